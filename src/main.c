@@ -8,17 +8,14 @@ void quitGame(void *t) {
 
 void saveMap(void *t) {
 	TSEE *tsee = (TSEE *)t;
-	TSEE_Map_Save(tsee, "map.tsee_map");
+	// Only the snapshot is taken on this frame, the file is written in the background.
+	TSEE_Map_SaveAsync(tsee, "map.tsee_map", NULL, NULL);
 }
 
 void loadMap(void *t) {
 	TSEE *tsee = (TSEE *)t;
-	TSEE_Map_Load(tsee, "map.tsee_map");
-	TSEE_Toolbar_AddButton(tsee, "_default", "Home");
-	TSEE_Toolbar_AddChild(tsee, "Home", "_default", "Quit", quitGame);
-	TSEE_Toolbar_AddButton(tsee, "_default", "Maps");
-	TSEE_Toolbar_AddChild(tsee, "Maps", "_default", "Save", saveMap);
-	TSEE_Toolbar_AddChild(tsee, "Maps", "_default", "Load", loadMap);
+	// Keeps the current map running while the new one loads, and leaves the toolbar's textures alone.
+	TSEE_Map_LoadAsync(tsee, "map.tsee_map", NULL, NULL);
 }
 
 int main(int argc, char *argv[]) {
@@ -0,0 +1,126 @@
+#include "../tsee/tsee.h"
+
+/**
+ * @brief Prints how to use tsee-cook.
+ * 
+ * @param name Name the program was run as.
+ */
+void usage(const char *name) {
+	fprintf(stderr,
+		"Usage: %s [-p] [-z] [-f format] -o archive.tsee_pak images...\n"
+		"  -p  Premultiply alpha\n"
+		"  -z  Compress the pixels with zlib\n"
+		"  -f  Pixel format to store, an SDL_PIXELFORMAT_* name without the prefix (default ARGB8888),\n"
+		"      or `native` to use the format this machine's renderer prefers\n"
+		"  -o  Archive to pack the cooked textures into, under their original paths.\n"
+		"      Loose images with the same paths are loaded instead of the archive's,\n"
+		"      unless the game turns that off with TSEE_Pak_SetLooseOverride\n",
+		name);
+}
+
+/**
+ * @brief Finds the pixel format to cook into from its name.
+ * 
+ * @param name Format name, e.g. ARGB8888, or `native`.
+ * @return Uint32 SDL_PixelFormatEnum, or SDL_PIXELFORMAT_UNKNOWN if it isn't a 32-bit format.
+ */
+Uint32 findFormat(const char *name) {
+	if (strcmp(name, "native") == 0) {
+		Uint32 format = SDL_PIXELFORMAT_UNKNOWN;
+		if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+			TSEE_Error("Failed to start SDL to find the native format (%s)\n", SDL_GetError());
+			return format;
+		}
+		SDL_Window *window = SDL_CreateWindow("tsee-cook", 0, 0, 1, 1, SDL_WINDOW_HIDDEN);
+		SDL_Renderer *renderer = window ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : NULL;
+		if (renderer) {
+			format = TSEE_Image_FindNativeFormat(renderer);
+		}
+		if (format != SDL_PIXELFORMAT_UNKNOWN) {
+			TSEE_Log("Using the renderer's native format %s\n", SDL_GetPixelFormatName(format));
+		}
+		if (renderer) SDL_DestroyRenderer(renderer);
+		if (window) SDL_DestroyWindow(window);
+		SDL_Quit();
+		return format;
+	}
+	const Uint32 formats[] = {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888};
+	for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+		// Names are SDL_PIXELFORMAT_ followed by the short name.
+		if (strcmp(SDL_GetPixelFormatName(formats[i]) + strlen("SDL_PIXELFORMAT_"), name) == 0) {
+			return formats[i];
+		}
+	}
+	return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+int main(int argc, char *argv[]) {
+	Uint32 flags = 0;
+	Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+	char *archive = NULL;
+	int first = 1;
+	for (; first < argc && argv[first][0] == '-'; first++) {
+		if (strcmp(argv[first], "-p") == 0) {
+			flags |= TSEE_IMAGE_PREMULTIPLIED;
+		} else if (strcmp(argv[first], "-z") == 0) {
+			flags |= TSEE_IMAGE_COMPRESSED;
+		} else if (strcmp(argv[first], "-f") == 0 && first + 1 < argc) {
+			format = findFormat(argv[++first]);
+			if (format == SDL_PIXELFORMAT_UNKNOWN) {
+				TSEE_Error("Unknown pixel format `%s`\n", argv[first]);
+				return 1;
+			}
+		} else if (strcmp(argv[first], "-o") == 0 && first + 1 < argc) {
+			archive = argv[++first];
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (first >= argc || !archive) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	size_t count = argc - first;
+	TSEE_MappedFile *cooked = xmalloc(sizeof(*cooked) * count);
+	size_t inputBytes = 0;
+	size_t outputBytes = 0;
+	bool success = true;
+	size_t done = 0;
+	for (; done < count; done++) {
+		char *path = argv[first + done];
+		SDL_Surface *surface = IMG_Load(path);
+		if (!surface) {
+			TSEE_Error("Failed to load `%s` (%s)\n", path, IMG_GetError());
+			success = false;
+			break;
+		}
+		if (!TSEE_Image_Cook(surface, format, flags, &cooked[done])) {
+			TSEE_Error("Failed to cook `%s` (%s)\n", path, SDL_GetError());
+			SDL_FreeSurface(surface);
+			success = false;
+			break;
+		}
+		SDL_FreeSurface(surface);
+
+		TSEE_MappedFile source;
+		if (TSEE_File_Map(path, &source)) {
+			inputBytes += source.size;
+			TSEE_File_Unmap(&source);
+		}
+		outputBytes += cooked[done].size;
+	}
+	if (success) {
+		success = TSEE_Pak_Write(archive, argv + first, cooked, count);
+	}
+	for (size_t i = 0; i < done; i++) {
+		xfree(cooked[i].data);
+	}
+	xfree(cooked);
+	if (!success) {
+		return 1;
+	}
+	TSEE_Log("Cooked %zu images as %s, %zu bytes -> %zu bytes\n", count, SDL_GetPixelFormatName(format), inputBytes, outputBytes);
+	return 0;
+}
\ No newline at end of file
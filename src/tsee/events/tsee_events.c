@@ -60,6 +60,9 @@ bool TSEE_Events_Handle(TSEE *tsee) {
 					tsee->events->mouseclick(tsee, tsee->events->event->button.x, tsee->events->event->button.y, tsee->events->event->button.button);
 				}
 				break;
+			case SDL_RENDER_TARGETS_RESET:
+				TSEE_Parallax_ResetStrips(tsee);
+				break;
 		}
 	}
 	Uint64 end = SDL_GetPerformanceCounter();
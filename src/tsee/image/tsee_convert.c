@@ -0,0 +1,244 @@
+#include "../tsee.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define TSEE_CONVERT_SSSE3
+#endif
+
+/**
+ * @brief Finds which byte of a pixel in memory a channel is stored in.
+ * 
+ * @param mask Channel's mask in a 32-bit pixel.
+ * @return int Byte index, or -1 if the channel isn't exactly one whole byte.
+ */
+int TSEE_Image_MaskByte(Uint32 mask) {
+	for (int shift = 0; shift < 32; shift += 8) {
+		if (mask == (Uint32)0xFF << shift) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			return shift / 8;
+#else
+			return 3 - shift / 8;
+#endif
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief Works out how to rearrange the bytes of one 32-bit format into another.
+ * 
+ * @param from Format to convert from.
+ * @param to Format to convert to.
+ * @param swizzle Set to the byte shuffle between them.
+ * @return true on success, false if either format doesn't have one byte per channel.
+ */
+bool TSEE_Image_GetSwizzle(const SDL_PixelFormat *from, const SDL_PixelFormat *to, TSEE_Image_Swizzle *swizzle) {
+	if (from->BytesPerPixel != 4 || to->BytesPerPixel != 4) {
+		return false;
+	}
+	const Uint32 fromMasks[4] = {from->Rmask, from->Gmask, from->Bmask, from->Amask};
+	const Uint32 toMasks[4] = {to->Rmask, to->Gmask, to->Bmask, to->Amask};
+	memset(swizzle->shuffle, 0x80, sizeof(swizzle->shuffle));
+	memset(swizzle->fill, 0, sizeof(swizzle->fill));
+	swizzle->alpha = -1;
+	for (int channel = 0; channel < 4; channel++) {
+		int source = fromMasks[channel] ? TSEE_Image_MaskByte(fromMasks[channel]) : -1;
+		int dest = toMasks[channel] ? TSEE_Image_MaskByte(toMasks[channel]) : -1;
+		if ((fromMasks[channel] && source < 0) || (toMasks[channel] && dest < 0) || (channel < 3 && (source < 0 || dest < 0))) {
+			return false;
+		}
+		if (dest < 0) continue;
+		if (channel == 3) {
+			swizzle->alpha = dest;
+			if (source < 0) {
+				// No alpha to copy, so every pixel is opaque.
+				swizzle->fill[dest] = 0xFF;
+				continue;
+			}
+		}
+		swizzle->shuffle[dest] = source;
+	}
+	return true;
+}
+
+#ifdef TSEE_CONVERT_SSSE3
+/**
+ * @brief SSSE3 part of TSEE_Image_SwizzleRow, converts four pixels at a time.
+ *        Only call it if the CPU has SSSE3, SSE4.1 is checked for as SDL can't check for SSSE3 alone.
+ * 
+ * @param swizzle Swizzle from TSEE_Image_GetSwizzle.
+ * @param src Pixels to convert.
+ * @param dst Where to write the converted pixels, can be the same as src.
+ * @param width Pixels in the row.
+ * @param premultiply True to premultiply, the destination must have alpha.
+ * @return int Pixels converted, the rest are left for the scalar loop.
+ */
+__attribute__((target("ssse3")))
+int TSEE_Image_SwizzleRowSSSE3(const TSEE_Image_Swizzle *swizzle, const Uint8 *src, Uint8 *dst, int width, bool premultiply) {
+	Uint8 shuffle[16], fill[16], spread[16], alpha[16];
+	for (int i = 0; i < 16; i++) {
+		int pixel = i & ~3;
+		Uint8 source = swizzle->shuffle[i & 3];
+		shuffle[i] = source & 0x80 ? 0x80 : pixel + source;
+		fill[i] = swizzle->fill[i & 3];
+		spread[i] = premultiply ? pixel + swizzle->alpha : 0;
+		alpha[i] = premultiply && (i & 3) == swizzle->alpha ? 0xFF : 0;
+	}
+	const __m128i shuffleMask = _mm_loadu_si128((const __m128i *)shuffle);
+	const __m128i fillMask = _mm_loadu_si128((const __m128i *)fill);
+	const __m128i spreadMask = _mm_loadu_si128((const __m128i *)spread);
+	const __m128i alphaMask = _mm_loadu_si128((const __m128i *)alpha);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i half = _mm_set1_epi16(128);
+	int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		__m128i pixels = _mm_loadu_si128((const __m128i *)(src + x * 4));
+		pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffleMask), fillMask);
+		if (premultiply) {
+			// Widen to 16 bits, multiply every channel by its pixel's alpha and divide by 255.
+			__m128i a = _mm_shuffle_epi8(pixels, spreadMask);
+			__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(a, zero)), half);
+			__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(a, zero)), half);
+			low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+			high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+			// Alpha itself stays as it was.
+			pixels = _mm_or_si128(_mm_andnot_si128(alphaMask, _mm_packus_epi16(low, high)), _mm_and_si128(alphaMask, pixels));
+		}
+		_mm_storeu_si128((__m128i *)(dst + x * 4), pixels);
+	}
+	return x;
+}
+#endif
+
+/**
+ * @brief Converts a row of pixels with a swizzle, optionally premultiplying colour by alpha.
+ *        Uses SSSE3 four pixels at a time when the CPU has it, the result is the same either way.
+ * 
+ * @param swizzle Swizzle from TSEE_Image_GetSwizzle.
+ * @param src Pixels to convert.
+ * @param dst Where to write the converted pixels, can be the same as src.
+ * @param width Pixels in the row.
+ * @param premultiply True to premultiply, ignored if the destination has no alpha.
+ */
+void TSEE_Image_SwizzleRow(const TSEE_Image_Swizzle *swizzle, const Uint8 *src, Uint8 *dst, int width, bool premultiply) {
+	premultiply = premultiply && swizzle->alpha >= 0;
+	int x = 0;
+#ifdef TSEE_CONVERT_SSSE3
+	if (SDL_HasSSE41()) {
+		x = TSEE_Image_SwizzleRowSSSE3(swizzle, src, dst, width, premultiply);
+	}
+#endif
+	for (; x < width; x++) {
+		const Uint8 *in = src + x * 4;
+		Uint8 out[4];
+		for (int i = 0; i < 4; i++) {
+			out[i] = (swizzle->shuffle[i] & 0x80 ? 0 : in[swizzle->shuffle[i]]) | swizzle->fill[i];
+		}
+		if (premultiply) {
+			Uint32 a = out[swizzle->alpha];
+			for (int i = 0; i < 4; i++) {
+				if (i == swizzle->alpha) continue;
+				// x * a / 255, rounded, without the divide
+				Uint32 c = out[i] * a + 128;
+				out[i] = (c + (c >> 8)) >> 8;
+			}
+		}
+		memcpy(dst + x * 4, out, 4);
+	}
+}
+
+/**
+ * @brief Converts a surface to a 32-bit format, optionally premultiplying its alpha.
+ *        Surfaces already in the format are converted in place. Palettes, 24-bit images
+ *        and colour keys are expanded to ARGB8888 by SDL first. Doesn't touch the renderer, so it is safe to call from any thread.
+ * 
+ * @param surface Surface to convert.
+ * @param format SDL_PixelFormatEnum to convert to, must have one byte per channel.
+ * @param premultiply True to premultiply colour by alpha.
+ * @return SDL_Surface* The converted surface, which is surface itself if converted in place, or NULL on fail.
+ *         If it's a new surface, the original is left as it was for the caller to free.
+ */
+SDL_Surface *TSEE_Image_Convert(SDL_Surface *surface, Uint32 format, bool premultiply) {
+	if (surface->format->format == format && !premultiply) {
+		return surface;
+	}
+	SDL_PixelFormat *target = SDL_AllocFormat(format);
+	if (!target) {
+		return NULL;
+	}
+	SDL_Surface *source = surface;
+	TSEE_Image_Swizzle swizzle;
+	// Colour keys and formats without a byte per channel are left to SDL's blitter.
+	if (SDL_GetColorKey(surface, NULL) == 0 || !TSEE_Image_GetSwizzle(source->format, target, &swizzle)) {
+		source = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		if (!source || !TSEE_Image_GetSwizzle(source->format, target, &swizzle)) {
+			if (source) SDL_FreeSurface(source);
+			SDL_FreeFormat(target);
+			return NULL;
+		}
+	}
+	SDL_FreeFormat(target);
+	SDL_Surface *converted = source;
+	if (source->format->format != format) {
+		converted = SDL_CreateRGBSurfaceWithFormat(0, source->w, source->h, 32, format);
+		if (!converted) {
+			if (source != surface) SDL_FreeSurface(source);
+			return NULL;
+		}
+	}
+	if (SDL_MUSTLOCK(source) && SDL_LockSurface(source) != 0) {
+		if (converted != source) SDL_FreeSurface(converted);
+		if (source != surface) SDL_FreeSurface(source);
+		return NULL;
+	}
+	for (int y = 0; y < source->h; y++) {
+		TSEE_Image_SwizzleRow(&swizzle, (Uint8 *)source->pixels + (size_t)y * source->pitch, (Uint8 *)converted->pixels + (size_t)y * converted->pitch, source->w, premultiply);
+	}
+	if (SDL_MUSTLOCK(source)) {
+		SDL_UnlockSurface(source);
+	}
+	if (source != surface && source != converted) {
+		SDL_FreeSurface(source);
+	}
+	return converted;
+}
+
+/**
+ * @brief Finds the texture format a renderer prefers that images can be converted to,
+ *        the first 32-bit format with alpha and one byte per channel it lists.
+ * 
+ * @param renderer Renderer to check.
+ * @return Uint32 SDL_PixelFormatEnum, or SDL_PIXELFORMAT_UNKNOWN if it doesn't list one.
+ */
+Uint32 TSEE_Image_FindNativeFormat(SDL_Renderer *renderer) {
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(renderer, &info) != 0) {
+		return SDL_PIXELFORMAT_UNKNOWN;
+	}
+	for (Uint32 i = 0; i < info.num_texture_formats; i++) {
+		Uint32 format = info.texture_formats[i];
+		if (SDL_ISPIXELFORMAT_FOURCC(format) || !SDL_ISPIXELFORMAT_ALPHA(format) || SDL_BYTESPERPIXEL(format) != 4) continue;
+		SDL_PixelFormat *details = SDL_AllocFormat(format);
+		if (!details) continue;
+		TSEE_Image_Swizzle swizzle;
+		bool usable = TSEE_Image_GetSwizzle(details, details, &swizzle) && swizzle.alpha >= 0;
+		SDL_FreeFormat(details);
+		if (usable) {
+			return format;
+		}
+	}
+	return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+/**
+ * @brief Sets whether images are converted to the renderer's native format as they're loaded.
+ *        Turn it off to compare upload and draw times against SDL converting them itself.
+ * 
+ * @param tsee TSEE object to set it for.
+ * @param convert True to convert images on load.
+ * @param premultiply True to also premultiply alpha, converted images are then drawn with a premultiplied blend mode.
+ */
+void TSEE_Image_SetConversion(TSEE *tsee, bool convert, bool premultiply) {
+	tsee->window->convert_images = convert;
+	tsee->window->premultiply_images = premultiply;
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "../tsee.h"
+
+/**
+ * @brief Checks if a file is a cooked texture.
+ * 
+ * @param file File to check.
+ * @return true if it starts with a cooked texture header, false otherwise.
+ */
+bool TSEE_Image_IsCooked(const TSEE_MappedFile *file) {
+	return file->size >= sizeof(TSEE_Cooked_Header) && memcmp(file->data, TSEE_COOKED_MAGIC, sizeof(((TSEE_Cooked_Header *)0)->magic)) == 0;
+}
+
+/**
+ * @brief Loads a cooked texture into a surface in the format it was cooked in.
+ *        Uncompressed textures in archives aren't copied, the surface points into the archive.
+ * 
+ * @param file Cooked texture file.
+ * @param flags Set to the texture's TSEE_Image_Flags.
+ * @return SDL_Surface* or NULL on fail.
+ */
+SDL_Surface *TSEE_Image_LoadCooked(const TSEE_MappedFile *file, Uint32 *flags) {
+	const TSEE_Cooked_Header *header = file->data;
+	const Uint8 *pixels = (const Uint8 *)file->data + sizeof(*header);
+	Uint32 format = SDL_SwapLE32(header->format);
+	int width = SDL_SwapLE32(header->width);
+	int height = SDL_SwapLE32(header->height);
+	Uint32 pitch = SDL_SwapLE32(header->pitch);
+	Uint64 size = SDL_SwapLE64(header->size);
+	*flags = (SDL_SwapLE32(header->flags) & (TSEE_IMAGE_PREMULTIPLIED | TSEE_IMAGE_COMPRESSED)) | TSEE_IMAGE_COOKED;
+	if (SDL_SwapLE32(header->version) != TSEE_COOKED_VERSION || width <= 0 || height <= 0 || size > file->size - sizeof(*header)
+		|| SDL_ISPIXELFORMAT_FOURCC(format) || pitch < width * SDL_BYTESPERPIXEL(format)) {
+		SDL_SetError("Invalid cooked texture header");
+		return NULL;
+	}
+	Uint64 unpacked = (Uint64)pitch * height;
+	if (!(*flags & TSEE_IMAGE_COMPRESSED)) {
+		if (size < unpacked) {
+			SDL_SetError("Cooked texture is truncated");
+			return NULL;
+		}
+		if (file->packed) {
+			return SDL_CreateRGBSurfaceWithFormatFrom((void *)pixels, width, height, SDL_BITSPERPIXEL(format), pitch, format);
+		}
+	}
+	SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, SDL_BITSPERPIXEL(format), format);
+	if (!surface) {
+		return NULL;
+	}
+	// Rows only need copying one by one if SDL pads them differently to the cooked pitch.
+	Uint8 *rows = (Uint32)surface->pitch == pitch ? surface->pixels : NULL;
+	if (*flags & TSEE_IMAGE_COMPRESSED) {
+		if (!rows) {
+			rows = xmalloc(unpacked);
+		}
+		uLongf length = unpacked;
+		if (uncompress(rows, &length, pixels, size) != Z_OK || length != unpacked) {
+			SDL_SetError("Failed to decompress cooked texture");
+			if (rows != surface->pixels) xfree(rows);
+			SDL_FreeSurface(surface);
+			return NULL;
+		}
+		pixels = rows;
+	}
+	if (pixels != surface->pixels) {
+		for (int y = 0; y < height; y++) {
+			memcpy((Uint8 *)surface->pixels + (size_t)y * surface->pitch, pixels + (size_t)y * pitch, width * SDL_BYTESPERPIXEL(format));
+		}
+	}
+	if (rows && rows != surface->pixels) {
+		xfree(rows);
+	}
+	return surface;
+}
+
+/**
+ * @brief Premultiplies a 32-bit surface's colour by its alpha, in place.
+ *        Only works on formats with one byte per channel.
+ * 
+ * @param surface Surface to premultiply.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Image_Premultiply(SDL_Surface *surface) {
+	TSEE_Image_Swizzle swizzle;
+	if (!TSEE_Image_GetSwizzle(surface->format, surface->format, &swizzle) || swizzle.alpha < 0) {
+		return false;
+	}
+	if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0) {
+		return false;
+	}
+	for (int y = 0; y < surface->h; y++) {
+		Uint8 *row = (Uint8 *)surface->pixels + (size_t)y * surface->pitch;
+		TSEE_Image_SwizzleRow(&swizzle, row, row, surface->w, true);
+	}
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+	return true;
+}
+
+/**
+ * @brief Cooks a decoded image into a cooked texture.
+ * 
+ * @param surface Image to cook.
+ * @param format SDL_PixelFormatEnum to store the pixels in, should be the renderer's native format.
+ * @param flags TSEE_IMAGE_PREMULTIPLIED and/or TSEE_IMAGE_COMPRESSED.
+ * @param output Set to the cooked texture, free its data with xfree.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Image_Cook(SDL_Surface *surface, Uint32 format, Uint32 flags, TSEE_MappedFile *output) {
+	output->data = NULL;
+	output->size = 0;
+	output->packed = false;
+	output->allocated = false;
+	SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+	if (!converted) {
+		return false;
+	}
+	if ((flags & TSEE_IMAGE_PREMULTIPLIED) && !TSEE_Image_Premultiply(converted)) {
+		flags &= ~TSEE_IMAGE_PREMULTIPLIED;
+	}
+
+	// Drop SDL's row padding.
+	Uint32 pitch = converted->w * SDL_BYTESPERPIXEL(format);
+	Uint64 unpacked = (Uint64)pitch * converted->h;
+	Uint8 *pixels = xmalloc(unpacked);
+	for (int y = 0; y < converted->h; y++) {
+		memcpy(pixels + (size_t)y * pitch, (Uint8 *)converted->pixels + (size_t)y * converted->pitch, pitch);
+	}
+
+	uLongf size = unpacked;
+	Uint8 *data = NULL;
+	if (flags & TSEE_IMAGE_COMPRESSED) {
+		size = compressBound(unpacked);
+		data = xmalloc(sizeof(TSEE_Cooked_Header) + size);
+		if (compress2(data + sizeof(TSEE_Cooked_Header), &size, pixels, unpacked, Z_BEST_COMPRESSION) != Z_OK) {
+			TSEE_Error("Failed to compress cooked texture\n");
+			xfree(data);
+			xfree(pixels);
+			SDL_FreeSurface(converted);
+			return false;
+		}
+	} else {
+		data = xmalloc(sizeof(TSEE_Cooked_Header) + size);
+		memcpy(data + sizeof(TSEE_Cooked_Header), pixels, unpacked);
+	}
+
+	TSEE_Cooked_Header header = {0};
+	memcpy(header.magic, TSEE_COOKED_MAGIC, sizeof(header.magic));
+	header.version = SDL_SwapLE32(TSEE_COOKED_VERSION);
+	header.format = SDL_SwapLE32(format);
+	header.width = SDL_SwapLE32(converted->w);
+	header.height = SDL_SwapLE32(converted->h);
+	header.pitch = SDL_SwapLE32(pitch);
+	header.flags = SDL_SwapLE32(flags & (TSEE_IMAGE_PREMULTIPLIED | TSEE_IMAGE_COMPRESSED));
+	header.size = SDL_SwapLE64(size);
+	memcpy(data, &header, sizeof(header));
+
+	output->data = data;
+	output->size = sizeof(header) + size;
+	xfree(pixels);
+	SDL_FreeSurface(converted);
+	return true;
+}
+
+/**
+ * @brief Gets the blend mode for drawing premultiplied textures.
+ * 
+ * @return SDL_BlendMode or SDL_BLENDMODE_INVALID if this SDL can't make custom blend modes.
+ */
+SDL_BlendMode TSEE_Image_PremultipliedBlendMode() {
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+#else
+	return SDL_BLENDMODE_INVALID;
+#endif
+}
\ No newline at end of file
@@ -1,5 +1,212 @@
 #include "../tsee.h"
 
+/**
+ * @brief Decodes an image file already in memory into a surface.
+ *        Cooked textures skip decoding, other images are converted to the renderer's native format
+ *        unless that's turned off. Doesn't touch the renderer, so it is safe to call from any thread.
+ * 
+ * @param tsee TSEE object with the window's format.
+ * @param path Path the image was read from, for errors.
+ * @param file Contents of the image file.
+ * @param flags Set to the surface's TSEE_Image_Flags.
+ * @return SDL_Surface* or NULL on fail.
+ */
+SDL_Surface *TSEE_Image_DecodeFile(TSEE *tsee, const char *path, const TSEE_MappedFile *file, Uint32 *flags) {
+	*flags = 0;
+	SDL_Surface *surface = NULL;
+	if (TSEE_Image_IsCooked(file)) {
+		surface = TSEE_Image_LoadCooked(file, flags);
+	} else {
+		surface = IMG_Load_RW(SDL_RWFromConstMem(file->data, file->size), 1);
+		TSEE_Window *window = tsee->window;
+		if (surface && window->convert_images && window->native_format != SDL_PIXELFORMAT_UNKNOWN) {
+			SDL_Surface *converted = TSEE_Image_Convert(surface, window->native_format, window->premultiply_images);
+			if (converted) {
+				if (converted != surface) SDL_FreeSurface(surface);
+				surface = converted;
+				*flags = TSEE_IMAGE_COOKED | (window->premultiply_images ? TSEE_IMAGE_PREMULTIPLIED : 0);
+			} else {
+				TSEE_Warn("Failed to convert `%s` to %s, SDL will convert it (%s)\n", path, SDL_GetPixelFormatName(window->native_format), SDL_GetError());
+			}
+		}
+	}
+	return surface;
+}
+
+/**
+ * @brief Decodes an image file into a surface, from a loose file or a mounted archive.
+ *        Doesn't touch the renderer, so it is safe to call from any thread.
+ * 
+ * @param tsee TSEE object with the mounted archives.
+ * @param path Path to read the image from.
+ * @param flags Set to the surface's TSEE_Image_Flags.
+ * @return SDL_Surface* or NULL on fail.
+ */
+SDL_Surface *TSEE_Image_LoadSurface(TSEE *tsee, char *path, Uint32 *flags) {
+	*flags = 0;
+	TSEE_MappedFile file;
+	if (!TSEE_Pak_Map(tsee, path, &file)) {
+		return NULL;
+	}
+	SDL_Surface *surface = TSEE_Image_DecodeFile(tsee, path, &file, flags);
+	TSEE_File_Unmap(&file);
+	return surface;
+}
+
+/**
+ * @brief Uploads a decoded surface to the renderer. Must be called on the render thread.
+ *        Cooked surfaces go straight to SDL_UpdateTexture without being converted.
+ *        Time spent is added to the debug overlay's texture upload time.
+ * 
+ * @param tsee TSEE object to upload to.
+ * @param surface Surface to upload, it isn't freed.
+ * @param flags TSEE_Image_Flags of the surface.
+ * @return SDL_Texture* or NULL on fail.
+ */
+SDL_Texture *TSEE_Image_Upload(TSEE *tsee, SDL_Surface *surface, Uint32 flags) {
+	Uint64 start = SDL_GetPerformanceCounter();
+	SDL_Texture *texture = NULL;
+	if (flags & TSEE_IMAGE_COOKED) {
+		texture = SDL_CreateTexture(tsee->window->renderer, surface->format->format, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+		if (texture && SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch) != 0) {
+			SDL_DestroyTexture(texture);
+			texture = NULL;
+		}
+		if (texture) {
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		}
+	} else {
+		texture = SDL_CreateTextureFromSurface(tsee->window->renderer, surface);
+	}
+	if (texture && (flags & TSEE_IMAGE_PREMULTIPLIED)) {
+		if (SDL_SetTextureBlendMode(texture, TSEE_Image_PremultipliedBlendMode()) != 0) {
+			TSEE_Warn("Renderer can't draw premultiplied textures, cook them without premultiplying (%s)\n", SDL_GetError());
+		}
+	}
+	if (tsee->debug) {
+		tsee->debug->render_times.upload_time += (SDL_GetPerformanceCounter() - start) * 1000 / (double)SDL_GetPerformanceFrequency();
+	}
+	return texture;
+}
+
+/**
+ * @brief Hashes a decoded surface's pixels, for finding identical images loaded from different paths.
+ *        Row padding isn't hashed, the size, format and premultiplication are.
+ * 
+ * @param surface Surface to hash.
+ * @param flags TSEE_Image_Flags of the surface.
+ * @return Uint64 Hash, never 0.
+ */
+Uint64 TSEE_Image_Hash(SDL_Surface *surface, Uint32 flags) {
+	Uint32 header[4] = {surface->w, surface->h, surface->format->format, flags & TSEE_IMAGE_PREMULTIPLIED};
+	Uint64 hash = TSEE_Hash_Bytes(header, sizeof(header), 0);
+	if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0) {
+		return hash ? hash : 1;
+	}
+	size_t row = (size_t)surface->w * surface->format->BytesPerPixel;
+	if ((size_t)surface->pitch == row) {
+		hash = TSEE_Hash_Bytes(surface->pixels, row * surface->h, hash);
+	} else {
+		for (int y = 0; y < surface->h; y++) {
+			hash = TSEE_Hash_Bytes((Uint8 *)surface->pixels + (size_t)y * surface->pitch, row, hash);
+		}
+	}
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+	// 0 means unhashed.
+	return hash ? hash : 1;
+}
+
+/**
+ * @brief Checks if two decoded surfaces hold the same image. Row padding isn't compared, the size and format are.
+ * 
+ * @param surface First surface.
+ * @param other Second surface.
+ * @return true if every pixel is the same.
+ */
+bool TSEE_Image_Equal(SDL_Surface *surface, SDL_Surface *other) {
+	if (surface->w != other->w || surface->h != other->h || surface->format->format != other->format->format) {
+		return false;
+	}
+	if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) != 0) {
+		return false;
+	}
+	if (SDL_MUSTLOCK(other) && SDL_LockSurface(other) != 0) {
+		if (SDL_MUSTLOCK(surface)) {
+			SDL_UnlockSurface(surface);
+		}
+		return false;
+	}
+	size_t row = (size_t)surface->w * surface->format->BytesPerPixel;
+	bool equal = true;
+	for (int y = 0; equal && y < surface->h; y++) {
+		equal = memcmp((Uint8 *)surface->pixels + (size_t)y * surface->pitch, (Uint8 *)other->pixels + (size_t)y * other->pitch, row) == 0;
+	}
+	if (SDL_MUSTLOCK(other)) {
+		SDL_UnlockSurface(other);
+	}
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+	return equal;
+}
+
+/**
+ * @brief Creates a texture handle for an asset, sized to the asset's image.
+ * 
+ * @param tsee TSEE object to create the texture in.
+ * @param asset Asset the texture draws.
+ * @return TSEE_Texture* 
+ */
+TSEE_Texture *TSEE_Texture_CreateFromAsset(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	TSEE_Texture *texture = xmalloc(sizeof(*texture));
+	if (!texture) {
+		TSEE_Error("Couldn't malloc memory for texture `%s`\n", asset->path);
+		return NULL;
+	}
+	texture->texture = asset->texture;
+	if (!texture->texture && tsee->loader && (asset->loading || asset->failed)) {
+		texture->texture = tsee->loader->placeholder;
+	}
+	texture->rect = (SDL_Rect){0, 0, asset->width, asset->height};
+	if (asset->width == 0 && texture->texture) {
+		SDL_QueryTexture(texture->texture, NULL, NULL, &texture->rect.w, &texture->rect.h);
+	}
+	texture->path = strdup(asset->path);
+	texture->id = asset->id;
+	texture->asset = asset;
+	TSEE_Array_Append(asset->users, texture);
+	TSEE_Array_Append(tsee->textures, texture);
+	return texture;
+}
+
+/**
+ * @brief Finds the asset for a file path, loading it now if it isn't loaded yet.
+ *        Create a texture from it straight away, assets are only freed once their last texture is destroyed.
+ * 
+ * @param tsee TSEE object to load the asset into
+ * @param path Path to read the image from.
+ * @return TSEE_Texture_Asset* or NULL if it couldn't be loaded.
+ */
+TSEE_Texture_Asset *TSEE_Texture_LoadAsset(TSEE *tsee, char *path) {
+	TSEE_Texture_Asset *asset = TSEE_TextureCache_GetAsset(tsee, path);
+	if (!asset->texture && (asset->loading || asset->width == 0)) {
+		TSEE_Texture_Asset *loaded = TSEE_TextureCache_Load(tsee, asset);
+		if (!loaded) {
+			// The asset may have been merged into a duplicate before that failed to upload.
+			// It may also have been dropped from the cache already, then there's nothing left to free.
+			asset = TSEE_HashMap_Get(tsee->texture_cache->assets, path);
+			if (asset && asset->users->size == 0) {
+				TSEE_TextureCache_DestroyAsset(tsee, asset);
+			}
+			return NULL;
+		}
+		asset = loaded;
+	}
+	return asset;
+}
+
 /**
  * @brief Creates a texture from a file path. If the texture is already loaded,
  *        the new texture uses a reference to the other texture.
@@ -9,38 +216,137 @@
  * @return TSEE_Texture* 
  */
 TSEE_Texture *TSEE_Texture_Create(TSEE *tsee, char *path) {
-	for (size_t i = 0; i < tsee->textures->size; i++) {
-		TSEE_Texture *existingTexture = (TSEE_Texture *)TSEE_Array_Get(tsee->textures, i);
-		if (strcmp(existingTexture->path, path) == 0) {
-			TSEE_Texture *newTexture = xmalloc(sizeof(*newTexture));
-			newTexture->texture = existingTexture->texture;
-			SDL_QueryTexture(newTexture->texture, NULL, NULL, &newTexture->rect.w, &newTexture->rect.h);
-			newTexture->rect = (SDL_Rect){0, 0, newTexture->rect.w, newTexture->rect.h};
-			newTexture->path = strdup(path);
-			TSEE_Array_Append(tsee->textures, newTexture);
-			return newTexture;
-		}
-	}
-	TSEE_Texture *texture = xmalloc(sizeof(*texture));
-	if (!texture) {
-		TSEE_Error("Couldn't malloc memory for texture `%s`\n", path);
+	TSEE_Texture_Asset *asset = TSEE_Texture_LoadAsset(tsee, path);
+	if (!asset) {
 		return NULL;
 	}
-	SDL_Texture *tex = IMG_LoadTexture(tsee->window->renderer, path);
-	if (!tex) {
-		TSEE_Error("Couldn't load texture from file `%s`\n", path);
-		xfree(texture);
+	return TSEE_Texture_CreateFromAsset(tsee, asset);
+}
+
+/**
+ * @brief Creates a texture from a file path without blocking. The texture shows a placeholder
+ *        until a loader thread has decoded it and it has been uploaded during TSEE_RenderAll.
+ * 
+ * @param tsee TSEE object to load the texture into
+ * @param path Path to read the texture from.
+ * @param callback Called once the texture has loaded or failed to load (can be NULL).
+ * @param userdata Passed to the callback.
+ * @return TSEE_Texture* 
+ */
+TSEE_Texture *TSEE_Texture_CreateAsync(TSEE *tsee, char *path, TSEE_Texture_Callback callback, void *userdata) {
+	TSEE_Texture_Asset *asset = TSEE_HashMap_Get(tsee->texture_cache->assets, path);
+	bool loaded = asset && asset->width > 0;
+	if (loaded || !TSEE_Loader_Init(tsee)) {
+		if (!loaded) {
+			TSEE_Warn("Loading texture `%s` synchronously, the loader failed to start.\n", path);
+		}
+		TSEE_Texture *texture = TSEE_Texture_Create(tsee, path);
+		if (callback) {
+			callback(tsee, texture, texture != NULL, userdata);
+		}
+		return texture;
+	}
+	asset = TSEE_TextureCache_GetAsset(tsee, path);
+	asset->failed = false;
+	asset->loading = true;
+	TSEE_Texture *texture = TSEE_Texture_CreateFromAsset(tsee, asset);
+	if (!texture || !TSEE_Loader_Request(tsee, asset, texture, callback, userdata)) {
+		asset->loading = false;
+		TSEE_Texture_Destroy(tsee, texture);
 		return NULL;
 	}
-	texture->texture = tex;
-	SDL_QueryTexture(tex, NULL, NULL, &texture->rect.w, &texture->rect.h);
-	texture->rect.x = 0;
-	texture->rect.y = 0;
-	texture->path = strdup(path);
-	TSEE_Array_Append(tsee->textures, texture);
 	return texture;
 }
 
+/**
+ * @brief Checks if a texture is still showing the loader's placeholder.
+ * 
+ * @param tsee TSEE object the texture is in.
+ * @param texture Texture to check.
+ * @return true if it hasn't loaded (or failed to), false otherwise.
+ */
+bool TSEE_Texture_IsLoading(TSEE *tsee, TSEE_Texture *texture) {
+	return tsee->loader && texture->texture == tsee->loader->placeholder;
+}
+
+/**
+ * @brief Destroys many textures at once, with one pass over the texture list and each image's users
+ *        rather than a search per texture. Images are only destroyed once no other texture uses them.
+ * 
+ * @param tsee TSEE object the textures are in.
+ * @param textures Textures to destroy, each only once.
+ * @param count Number of textures.
+ */
+void TSEE_Texture_DestroyBatch(TSEE *tsee, TSEE_Texture **textures, size_t count) {
+	if (count == 0) return;
+	TSEE_HashMap *doomed = TSEE_HashMap_Create();
+	TSEE_Array *assets = TSEE_Array_Create();
+	for (size_t i = 0; i < count; i++) {
+		TSEE_Texture *tex = textures[i];
+		TSEE_HashMap_Insert(doomed, TSEE_Hash_Pointer(tex), NULL, tex);
+		TSEE_Texture_Asset *asset = tex->asset;
+		if (asset && !TSEE_HashMap_Lookup(doomed, TSEE_Hash_Pointer(asset), NULL)) {
+			TSEE_HashMap_Insert(doomed, TSEE_Hash_Pointer(asset), NULL, asset);
+			TSEE_Array_Append(assets, asset);
+		}
+		if (asset && asset->loading) {
+			TSEE_Loader_Cancel(tsee, tex);
+		}
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < tsee->textures->size; i++) {
+		TSEE_Texture *tex = tsee->textures->data[i];
+		if (!TSEE_HashMap_Lookup(doomed, TSEE_Hash_Pointer(tex), NULL)) {
+			tsee->textures->data[kept++] = tex;
+		}
+	}
+	tsee->textures->size = kept;
+	for (size_t i = 0; i < assets->size; i++) {
+		TSEE_Texture_Asset *asset = assets->data[i];
+		kept = 0;
+		for (size_t j = 0; j < asset->users->size; j++) {
+			TSEE_Texture *user = asset->users->data[j];
+			if (!TSEE_HashMap_Lookup(doomed, TSEE_Hash_Pointer(user), NULL)) {
+				asset->users->data[kept++] = user;
+			}
+		}
+		asset->users->size = kept;
+		if (kept == 0) {
+			TSEE_TextureCache_DestroyAsset(tsee, asset);
+		}
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		TSEE_Texture *tex = textures[i];
+		if (!tex->asset && tex->texture) {
+			SDL_DestroyTexture(tex->texture);
+		}
+		if (tex->path)
+			xfree(tex->path);
+		xfree(tex);
+	}
+	TSEE_Array_Destroy(assets);
+	TSEE_HashMap_Destroy(doomed);
+}
+
+/**
+ * @brief Draws a texture, or part of it. Tiled images draw the tiles under the destination.
+ *        Call TSEE_Texture_Use first so evicted images are reloaded.
+ * 
+ * @param tsee TSEE object to draw to.
+ * @param texture Texture to draw.
+ * @param src Part of the texture to draw, or NULL for all of it.
+ * @param dst Where to draw it.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Texture_Render(TSEE *tsee, TSEE_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst) {
+	if (texture->asset && texture->asset->tiles) {
+		return TSEE_Tiles_Render(tsee, texture->asset, src, dst);
+	}
+	return SDL_RenderCopy(tsee->window->renderer, texture->texture, src, dst) == 0;
+}
+
 /**
  * @brief Finds a texture if it is already loaded.
  * 
@@ -51,6 +357,7 @@ TSEE_Texture *TSEE_Texture_Create(TSEE *tsee, char *path) {
 TSEE_Texture *TSEE_Texture_Find(TSEE *tsee, char *path) {
 	for (size_t i = 0; i < tsee->textures->size; i++) {
 		TSEE_Texture *texture = (TSEE_Texture *)TSEE_Array_Get(tsee->textures, i);
+		if (!texture->path) continue;
 		TSEE_Log("Checking texture %s against %s\n", texture->path, path);
 		if (strcmp(texture->path, path) == 0) {
 			TSEE_Log("Found texture with same path %s\n", path);
@@ -62,21 +369,37 @@ TSEE_Texture *TSEE_Texture_Find(TSEE *tsee, char *path) {
 }
 
 /**
- * @brief Destroys a texture
+ * @brief Destroys a texture. Its image is only destroyed once no other texture uses it.
  * 
  * @param tex Texture to destroy
  */
 void TSEE_Texture_Destroy(TSEE *tsee, TSEE_Texture *tex) {
 	if (!tex) return;
-	if (tex->texture)
-		SDL_DestroyTexture(tex->texture);
-	if (tex->path)
-		xfree(tex->path);
-	for (size_t i = 0; i < tsee->textures->size; i++) {
-		if (tex == TSEE_Array_Get(tsee->textures, i)) {
+	// Searched newest first, so destroying textures in reverse order doesn't scan the whole array each time.
+	for (size_t i = tsee->textures->size; i-- > 0;) {
+		if (tex == tsee->textures->data[i]) {
 			TSEE_Array_Delete(tsee->textures, i);
 			break;
 		}
 	}
+	TSEE_Texture_Asset *asset = tex->asset;
+	if (asset) {
+		if (asset->loading) {
+			TSEE_Loader_Cancel(tsee, tex);
+		}
+		for (size_t i = asset->users->size; i-- > 0;) {
+			if (tex == asset->users->data[i]) {
+				TSEE_Array_Delete(asset->users, i);
+				break;
+			}
+		}
+		if (asset->users->size == 0) {
+			TSEE_TextureCache_DestroyAsset(tsee, asset);
+		}
+	} else if (tex->texture) {
+		SDL_DestroyTexture(tex->texture);
+	}
+	if (tex->path)
+		xfree(tex->path);
 	xfree(tex);
 }
\ No newline at end of file
@@ -7,12 +7,104 @@ bool TSEE_Window_SetTitle(TSEE *tsee, char *title);
 bool TSEE_RenderAll(TSEE *tsee);
 bool TSEE_Rendering_IsReady(TSEE *tsee);
 
+// Render Queue
+
+TSEE_RenderQueue *TSEE_RenderQueue_Create();
+Uint64 TSEE_RenderQueue_MakeKey(TSEE_Render_Layer layer, int depth, Uint32 textureId, size_t order);
+bool TSEE_RenderQueue_Submit(TSEE_RenderQueue *queue, TSEE_Object *obj);
+void TSEE_RenderQueue_Sort(TSEE_RenderQueue *queue);
+bool TSEE_RenderQueue_Flush(TSEE *tsee);
+void TSEE_RenderQueue_Destroy(TSEE_RenderQueue *queue);
+
 // Image
 
+SDL_Surface *TSEE_Image_DecodeFile(TSEE *tsee, const char *path, const TSEE_MappedFile *file, Uint32 *flags);
+SDL_Surface *TSEE_Image_LoadSurface(TSEE *tsee, char *path, Uint32 *flags);
+SDL_Texture *TSEE_Image_Upload(TSEE *tsee, SDL_Surface *surface, Uint32 flags);
+Uint64 TSEE_Image_Hash(SDL_Surface *surface, Uint32 flags);
+bool TSEE_Image_Equal(SDL_Surface *surface, SDL_Surface *other);
+TSEE_Texture *TSEE_Texture_CreateFromAsset(TSEE *tsee, TSEE_Texture_Asset *asset);
+TSEE_Texture_Asset *TSEE_Texture_LoadAsset(TSEE *tsee, char *path);
 TSEE_Texture *TSEE_Texture_Create(TSEE *tsee, char *path);
+TSEE_Texture *TSEE_Texture_CreateAsync(TSEE *tsee, char *path, TSEE_Texture_Callback callback, void *userdata);
+bool TSEE_Texture_IsLoading(TSEE *tsee, TSEE_Texture *texture);
+bool TSEE_Texture_Render(TSEE *tsee, TSEE_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst);
 TSEE_Texture *TSEE_Texture_Find(TSEE *tsee, char *path);
 void TSEE_Texture_Destroy(TSEE *tsee, TSEE_Texture *tex);
+void TSEE_Texture_DestroyBatch(TSEE *tsee, TSEE_Texture **textures, size_t count);
 
 // Animation
 
-void TSEE_Animation_Init(TSEE *tsee);
\ No newline at end of file
+void TSEE_Animation_Init(TSEE *tsee);
+
+// Loader
+
+SDL_Texture *TSEE_Loader_CreatePlaceholder(TSEE *tsee);
+int TSEE_Loader_Thread(void *data);
+bool TSEE_Loader_Init(TSEE *tsee);
+void TSEE_Loader_SetBudget(TSEE *tsee, double milliseconds);
+TSEE_Texture_Job *TSEE_Loader_CreateJob(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_Loader_Queue(TSEE *tsee, TSEE_Texture_Job *job);
+bool TSEE_Loader_Request(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture *texture, TSEE_Texture_Callback callback, void *userdata);
+void TSEE_Loader_ReadDone(size_t index, TSEE_MappedFile *file, void *userdata);
+int TSEE_Loader_ReadThread(void *data);
+bool TSEE_Loader_Preload(TSEE *tsee, char **paths, size_t count, bool wait);
+void TSEE_Loader_Wait(TSEE *tsee);
+void TSEE_Loader_Cancel(TSEE *tsee, TSEE_Texture *texture);
+void TSEE_Loader_CancelAsset(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_Loader_FreeJob(TSEE_Texture_Job *job);
+void TSEE_Loader_Update(TSEE *tsee);
+void TSEE_Loader_Destroy(TSEE *tsee);
+
+// Cooked Textures
+
+bool TSEE_Image_IsCooked(const TSEE_MappedFile *file);
+SDL_Surface *TSEE_Image_LoadCooked(const TSEE_MappedFile *file, Uint32 *flags);
+bool TSEE_Image_Premultiply(SDL_Surface *surface);
+bool TSEE_Image_Cook(SDL_Surface *surface, Uint32 format, Uint32 flags, TSEE_MappedFile *output);
+SDL_BlendMode TSEE_Image_PremultipliedBlendMode();
+
+// Tiles
+
+bool TSEE_Tiles_Wanted(TSEE *tsee, SDL_Surface *surface);
+TSEE_Texture_Tiles *TSEE_Tiles_Create(TSEE *tsee, SDL_Surface *surface, Uint32 flags);
+SDL_Rect TSEE_Tiles_GetRect(TSEE_Texture_Tiles *tiles, size_t index);
+bool TSEE_Tiles_Upload(TSEE *tsee, TSEE_Texture_Asset *asset, size_t index);
+bool TSEE_Tiles_Render(TSEE *tsee, TSEE_Texture_Asset *asset, const SDL_Rect *src, const SDL_Rect *dst);
+void TSEE_Tiles_Release(TSEE *tsee, TSEE_Texture_Asset *asset, Uint32 frames);
+void TSEE_Tiles_Update(TSEE *tsee);
+void TSEE_Tiles_Destroy(TSEE *tsee, TSEE_Texture_Asset *asset);
+
+// Conversion
+
+int TSEE_Image_MaskByte(Uint32 mask);
+bool TSEE_Image_GetSwizzle(const SDL_PixelFormat *from, const SDL_PixelFormat *to, TSEE_Image_Swizzle *swizzle);
+int TSEE_Image_SwizzleRowSSSE3(const TSEE_Image_Swizzle *swizzle, const Uint8 *src, Uint8 *dst, int width, bool premultiply);
+void TSEE_Image_SwizzleRow(const TSEE_Image_Swizzle *swizzle, const Uint8 *src, Uint8 *dst, int width, bool premultiply);
+SDL_Surface *TSEE_Image_Convert(SDL_Surface *surface, Uint32 format, bool premultiply);
+Uint32 TSEE_Image_FindNativeFormat(SDL_Renderer *renderer);
+void TSEE_Image_SetConversion(TSEE *tsee, bool convert, bool premultiply);
+
+// Texture Cache
+
+TSEE_TextureCache *TSEE_TextureCache_Create();
+void TSEE_TextureCache_SetBudget(TSEE *tsee, size_t bytes, Uint32 frames);
+void TSEE_TextureCache_SetAsyncReload(TSEE *tsee, bool async);
+void TSEE_TextureCache_SetDedup(TSEE *tsee, bool dedup);
+void TSEE_TextureCache_SetVirtual(TSEE *tsee, int size, int tileSize);
+TSEE_Texture_Asset *TSEE_TextureCache_GetAsset(TSEE *tsee, char *path);
+void TSEE_TextureCache_Unlink(TSEE_TextureCache *cache, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_Touch(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_Pin(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_Unpin(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_SetTexture(TSEE *tsee, TSEE_Texture_Asset *asset, SDL_Texture *texture);
+void TSEE_TextureCache_SetTiles(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Tiles *tiles);
+bool TSEE_TextureCache_IsDuplicate(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Asset *original, SDL_Surface *surface, Uint32 flags);
+TSEE_Texture_Asset *TSEE_TextureCache_Merge(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Asset *original, SDL_Surface *surface);
+TSEE_Texture_Asset *TSEE_TextureCache_Finish(TSEE *tsee, TSEE_Texture_Asset *asset, SDL_Surface *surface, Uint32 flags, Uint64 hash);
+TSEE_Texture_Asset *TSEE_TextureCache_Load(TSEE *tsee, TSEE_Texture_Asset *asset);
+bool TSEE_Texture_Use(TSEE *tsee, TSEE_Texture *texture);
+void TSEE_TextureCache_Evict(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_Update(TSEE *tsee);
+void TSEE_TextureCache_DestroyAsset(TSEE *tsee, TSEE_Texture_Asset *asset);
+void TSEE_TextureCache_Destroy(TSEE *tsee);
\ No newline at end of file
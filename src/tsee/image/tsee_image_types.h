@@ -11,6 +11,11 @@ typedef struct TSEE_Window {
 	SDL_Point mouse;
 	SDL_DisplayMode mode;
 	Uint64 last_render;
+	int max_texture_width; // 0 if the renderer has no limit
+	int max_texture_height;
+	Uint32 native_format; // Texture format images are converted to on load, SDL_PIXELFORMAT_UNKNOWN if the renderer has none
+	bool convert_images;
+	bool premultiply_images;
 } TSEE_Window;
 
 // TSEE's texture wrapper, keeps track of important information for the texture.
@@ -18,4 +23,157 @@ typedef struct TSEE_Texture {
 	SDL_Texture *texture;
 	SDL_Rect rect;
 	char *path;
-} TSEE_Texture;
\ No newline at end of file
+	Uint32 id; // Shared by every TSEE_Texture using the same SDL_Texture, used to batch draws.
+	struct TSEE_Texture_Asset *asset; // NULL for textures not loaded from a file
+} TSEE_Texture;
+
+// An image too big to upload whole, split into tiles which are only uploaded while near the camera.
+typedef struct TSEE_Texture_Tiles {
+	SDL_Surface *surface; // The decoded image, kept to upload tiles from
+	Uint32 flags; // TSEE_Image_Flags of the surface
+	int size; // Width and height of a tile, edge tiles are cut short
+	int columns;
+	int rows;
+	SDL_Texture **tiles; // columns * rows, NULL until uploaded
+	Uint64 *last_used; // Frame each tile was last near the camera in
+	size_t tile_bytes;
+	size_t resident;
+} TSEE_Texture_Tiles;
+
+// An image loaded from a file, shared by every TSEE_Texture created from the same path.
+typedef struct TSEE_Texture_Asset {
+	char *path;
+	SDL_Texture *texture; // NULL while evicted or loading, or if it failed to load
+	TSEE_Array *users; // Array of TSEE_Texture drawing this asset
+	Uint32 id;
+	int width;
+	int height;
+	size_t bytes; // Memory used while resident, width * height * bytes per pixel
+	Uint64 last_used; // Frame it was last drawn in
+	Uint32 pins; // Pinned assets are kept out of the resident list, so they're never evicted
+	bool loading;
+	bool failed;
+	Uint64 hash; // Hash of the decoded pixels, 0 if it hasn't been hashed
+	TSEE_Array *aliases; // Paths of identical images merged into this asset
+	size_t saved; // Memory not used thanks to the aliases
+	TSEE_Texture_Tiles *tiles; // Set instead of texture for images drawn in tiles
+	struct TSEE_Texture_Asset *prev; // Resident assets, most recently drawn first
+	struct TSEE_Texture_Asset *next;
+} TSEE_Texture_Asset;
+
+// Keeps track of file textures and the memory they use, evicting the least recently drawn to stay in budget.
+typedef struct TSEE_TextureCache {
+	TSEE_HashMap *assets; // Path -> TSEE_Texture_Asset, aliases included
+	TSEE_HashMap *contents; // Pixel hash -> TSEE_Texture_Asset, while deduplicating
+	TSEE_Texture_Asset *newest;
+	TSEE_Texture_Asset *oldest;
+	size_t bytes; // Used by resident assets
+	size_t budget; // 0 for no limit
+	size_t saved; // Memory not used by sharing identical images
+	Uint32 evict_after; // Frames an asset must go undrawn before it can be evicted
+	Uint64 frame;
+	bool async_reload;
+	bool dedup;
+	TSEE_Array *tiled; // Assets drawn in tiles
+	int virtual_size; // Images wider or taller than this are tiled, 0 to only tile images too big for the renderer
+	int tile_size;
+	int tile_uploads; // Tiles uploaded this frame
+} TSEE_TextureCache;
+
+// How a decoded image's pixels should be uploaded.
+typedef enum TSEE_Image_Flags {
+	TSEE_IMAGE_COOKED = 1 << 0, // Already in the texture's format, uploaded as-is
+	TSEE_IMAGE_PREMULTIPLIED = 1 << 1, // Colour is premultiplied by alpha
+	TSEE_IMAGE_COMPRESSED = 1 << 2, // Cooked pixels are zlib compressed
+} TSEE_Image_Flags;
+
+#define TSEE_COOKED_MAGIC "TSEETEX"
+#define TSEE_COOKED_VERSION 1
+
+// Header of a cooked texture, made by tsee-cook. The pixels follow it, all fields are little endian.
+typedef struct TSEE_Cooked_Header {
+	char magic[8];
+	Uint32 version;
+	Uint32 format; // SDL_PixelFormatEnum of the pixels
+	Uint32 width;
+	Uint32 height;
+	Uint32 pitch; // Rows are tightly packed
+	Uint32 flags; // TSEE_IMAGE_PREMULTIPLIED and TSEE_IMAGE_COMPRESSED
+	Uint64 size; // Bytes of pixel data after the header
+	Uint64 reserved; // Keeps the pixels 16 byte aligned in archives
+} TSEE_Cooked_Header;
+
+// How to rearrange the bytes of a 32-bit pixel into another format with one byte per channel.
+typedef struct TSEE_Image_Swizzle {
+	Uint8 shuffle[4]; // Source byte for each destination byte, 0x80 for none
+	Uint8 fill[4]; // ORed into each destination byte, makes alpha opaque when the source has none
+	int alpha; // Destination byte holding alpha, -1 if it has none
+} TSEE_Image_Swizzle;
+
+// Layers which objects are drawn in, lowest first.
+typedef enum TSEE_Render_Layer {
+	TSEE_LAYER_BACKGROUND = 0,
+	TSEE_LAYER_WORLD = 64,
+	TSEE_LAYER_FOREGROUND = 128,
+	TSEE_LAYER_UI = 192,
+} TSEE_Render_Layer;
+
+// Per-frame queue of objects to draw, ordered by 64-bit sort keys.
+// Key layout (high to low): layer (8 bits), depth (16 bits), texture id (16 bits), submission order (24 bits).
+typedef struct TSEE_RenderQueue {
+	Uint64 *keys;
+	Uint64 *scratch;
+	struct TSEE_Object **items; // Indexed by submission order
+	size_t size;
+	size_t capacity;
+} TSEE_RenderQueue;
+
+// Called when a texture requested with TSEE_Texture_CreateAsync has finished loading.
+// On failure the texture keeps using the placeholder.
+typedef void (*TSEE_Texture_Callback)(void *tsee, TSEE_Texture *texture, bool success, void *userdata);
+
+// A texture handle waiting on a load, and who to tell when it's done.
+typedef struct TSEE_Texture_Request {
+	TSEE_Texture *texture;
+	TSEE_Texture_Callback callback;
+	void *userdata;
+} TSEE_Texture_Request;
+
+// An image being decoded by a loader thread, or waiting to be uploaded by the render thread.
+typedef struct TSEE_Texture_Job {
+	char *path;
+	TSEE_Texture_Asset *asset; // NULL if the asset was destroyed or loaded another way before the job finished
+	SDL_Surface *surface; // Set by the loader thread, NULL if decoding failed
+	Uint32 flags; // TSEE_Image_Flags of the surface
+	Uint64 hash; // Hash of the surface's pixels, 0 unless deduplicating
+	TSEE_MappedFile file; // Read ahead of time by TSEE_Loader_Preload, decoded instead of reading the path
+	TSEE_Array *requests; // Array of TSEE_Texture_Request, only touched by the render thread
+	struct TSEE_Texture_Job *next;
+} TSEE_Texture_Job;
+
+#define TSEE_LOADER_MAX_THREADS 4
+
+// Jobs whose files are being read in one batch by TSEE_Loader_Preload.
+typedef struct TSEE_Loader_Batch {
+	void *tsee;
+	TSEE_Texture_Job **jobs;
+	char **paths;
+	size_t count;
+} TSEE_Loader_Batch;
+
+// Decodes images on worker threads, then uploads them on the render thread within a per-frame budget.
+typedef struct TSEE_Loader {
+	SDL_Thread *threads[TSEE_LOADER_MAX_THREADS];
+	int thread_count;
+	SDL_mutex *lock;
+	SDL_cond *wake;
+	TSEE_Texture_Job *pending; // Waiting to be decoded, oldest first
+	TSEE_Texture_Job *pending_tail;
+	TSEE_Texture_Job *decoded; // Waiting to be uploaded, oldest first
+	TSEE_Texture_Job *decoded_tail;
+	TSEE_HashMap *jobs; // Path -> TSEE_Texture_Job, so repeated requests share a job
+	SDL_Texture *placeholder;
+	double upload_budget; // Milliseconds per frame
+	SDL_Thread *io_thread; // Reading a TSEE_Loader_Batch, NULL when no batch is running
+	bool quit;
+} TSEE_Loader;
@@ -0,0 +1,439 @@
+#include "../tsee.h"
+
+#define TSEE_LOADER_PLACEHOLDER_SIZE 16
+#define TSEE_LOADER_DEFAULT_BUDGET 2.0
+
+/**
+ * @brief Creates the placeholder texture shown while textures load, a magenta and black checkerboard.
+ * 
+ * @param tsee TSEE object to create the placeholder for.
+ * @return SDL_Texture* or NULL on fail.
+ */
+SDL_Texture *TSEE_Loader_CreatePlaceholder(TSEE *tsee) {
+	SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, TSEE_LOADER_PLACEHOLDER_SIZE, TSEE_LOADER_PLACEHOLDER_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!surface) {
+		return NULL;
+	}
+	int half = TSEE_LOADER_PLACEHOLDER_SIZE / 2;
+	SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 0, 0, 0, 255));
+	SDL_FillRect(surface, &(SDL_Rect){0, 0, half, half}, SDL_MapRGBA(surface->format, 255, 0, 255, 255));
+	SDL_FillRect(surface, &(SDL_Rect){half, half, half, half}, SDL_MapRGBA(surface->format, 255, 0, 255, 255));
+	SDL_Texture *texture = SDL_CreateTextureFromSurface(tsee->window->renderer, surface);
+	SDL_FreeSurface(surface);
+	return texture;
+}
+
+/**
+ * @brief Worker thread for the loader, decodes images until the loader quits.
+ * 
+ * @param data The TSEE object to take jobs from.
+ * @return int
+ */
+int TSEE_Loader_Thread(void *data) {
+	TSEE *tsee = data;
+	TSEE_Loader *loader = tsee->loader;
+	SDL_LockMutex(loader->lock);
+	while (true) {
+		while (!loader->quit && !loader->pending) {
+			SDL_CondWait(loader->wake, loader->lock);
+		}
+		if (loader->quit) break;
+		TSEE_Texture_Job *job = loader->pending;
+		loader->pending = job->next;
+		if (!loader->pending) loader->pending_tail = NULL;
+		SDL_UnlockMutex(loader->lock);
+
+		if (job->file.data) {
+			job->surface = TSEE_Image_DecodeFile(tsee, job->path, &job->file, &job->flags);
+			TSEE_File_Unmap(&job->file);
+		} else {
+			job->surface = TSEE_Image_LoadSurface(tsee, job->path, &job->flags);
+		}
+		job->hash = job->surface && tsee->texture_cache->dedup ? TSEE_Image_Hash(job->surface, job->flags) : 0;
+		job->next = NULL;
+
+		SDL_LockMutex(loader->lock);
+		if (loader->decoded_tail) loader->decoded_tail->next = job;
+		else loader->decoded = job;
+		loader->decoded_tail = job;
+	}
+	SDL_UnlockMutex(loader->lock);
+	return 0;
+}
+
+/**
+ * @brief Starts the texture loader and its worker threads.
+ * 
+ * @param tsee TSEE object to start the loader for.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Loader_Init(TSEE *tsee) {
+	if (tsee->loader) {
+		return true;
+	}
+	TSEE_Loader *loader = xmalloc(sizeof(*loader));
+	if (!loader) {
+		return false;
+	}
+	memset(loader, 0, sizeof(*loader));
+	loader->upload_budget = TSEE_LOADER_DEFAULT_BUDGET;
+	loader->lock = SDL_CreateMutex();
+	loader->wake = SDL_CreateCond();
+	loader->placeholder = TSEE_Loader_CreatePlaceholder(tsee);
+	if (!loader->lock || !loader->wake || !loader->placeholder) {
+		TSEE_Error("Failed to create texture loader (%s)\n", SDL_GetError());
+		if (loader->lock) SDL_DestroyMutex(loader->lock);
+		if (loader->wake) SDL_DestroyCond(loader->wake);
+		if (loader->placeholder) SDL_DestroyTexture(loader->placeholder);
+		xfree(loader);
+		return false;
+	}
+	loader->jobs = TSEE_HashMap_Create();
+	tsee->loader = loader;
+
+	// Leave a core for the render thread.
+	int threads = SDL_GetCPUCount() - 1;
+	if (threads < 1) threads = 1;
+	if (threads > TSEE_LOADER_MAX_THREADS) threads = TSEE_LOADER_MAX_THREADS;
+	for (int i = 0; i < threads; i++) {
+		loader->threads[loader->thread_count] = SDL_CreateThread(TSEE_Loader_Thread, "TSEE Loader", tsee);
+		if (!loader->threads[loader->thread_count]) {
+			TSEE_Warn("Failed to create texture loader thread (%s)\n", SDL_GetError());
+			continue;
+		}
+		loader->thread_count++;
+	}
+	if (loader->thread_count == 0) {
+		TSEE_Error("Texture loader has no threads to decode with.\n");
+		TSEE_HashMap_Destroy(loader->jobs);
+		SDL_DestroyTexture(loader->placeholder);
+		SDL_DestroyCond(loader->wake);
+		SDL_DestroyMutex(loader->lock);
+		xfree(loader);
+		tsee->loader = NULL;
+		return false;
+	}
+	TSEE_Log("Started texture loader with %d threads.\n", loader->thread_count);
+	return true;
+}
+
+/**
+ * @brief Sets how long the render thread may spend uploading textures each frame.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param milliseconds Time per frame, at least one texture is always uploaded.
+ */
+void TSEE_Loader_SetBudget(TSEE *tsee, double milliseconds) {
+	if (!TSEE_Loader_Init(tsee)) return;
+	tsee->loader->upload_budget = milliseconds;
+}
+
+/**
+ * @brief Creates a job to load an asset, without queueing it.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param asset Asset to load.
+ * @return TSEE_Texture_Job*
+ */
+TSEE_Texture_Job *TSEE_Loader_CreateJob(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	TSEE_Texture_Job *job = xmalloc(sizeof(*job));
+	job->path = strdup(asset->path);
+	job->asset = asset;
+	job->surface = NULL;
+	job->flags = 0;
+	job->hash = 0;
+	job->file.data = NULL;
+	job->file.size = 0;
+	job->file.packed = false;
+	job->file.allocated = false;
+	job->requests = TSEE_Array_Create();
+	job->next = NULL;
+	TSEE_HashMap_Set(tsee->loader->jobs, job->path, job);
+	return job;
+}
+
+/**
+ * @brief Hands a job to the loader threads to decode. Safe to call from any thread.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param job Job to decode.
+ */
+void TSEE_Loader_Queue(TSEE *tsee, TSEE_Texture_Job *job) {
+	TSEE_Loader *loader = tsee->loader;
+	SDL_LockMutex(loader->lock);
+	if (loader->pending_tail) loader->pending_tail->next = job;
+	else loader->pending = job;
+	loader->pending_tail = job;
+	SDL_CondSignal(loader->wake);
+	SDL_UnlockMutex(loader->lock);
+}
+
+/**
+ * @brief Queues an asset to be loaded, sharing a job with any other request for the same path.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param asset Asset to load.
+ * @param texture Handle to tell once loaded (can be NULL).
+ * @param callback Callback for when it's loaded (can be NULL).
+ * @param userdata Passed to the callback.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Loader_Request(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture *texture, TSEE_Texture_Callback callback, void *userdata) {
+	TSEE_Loader *loader = tsee->loader;
+	TSEE_Texture_Request *request = NULL;
+	if (texture) {
+		request = xmalloc(sizeof(*request));
+		if (!request) {
+			return false;
+		}
+		request->texture = texture;
+		request->callback = callback;
+		request->userdata = userdata;
+	}
+
+	TSEE_Texture_Job *job = TSEE_HashMap_Get(loader->jobs, asset->path);
+	if (job) {
+		// A cancelled job for the same path is still decoding, pick it back up.
+		job->asset = asset;
+		if (request) TSEE_Array_Append(job->requests, request);
+		return true;
+	}
+	job = TSEE_Loader_CreateJob(tsee, asset);
+	if (request) TSEE_Array_Append(job->requests, request);
+	TSEE_Loader_Queue(tsee, job);
+	return true;
+}
+
+/**
+ * @brief Called as each file of a preload batch is read, hands it straight to the loader threads
+ *        so decoding overlaps the rest of the reads.
+ * 
+ * @param index Index of the job in the batch.
+ * @param file The file's contents, NULL data if it couldn't be read.
+ * @param userdata The TSEE_Loader_Batch.
+ */
+void TSEE_Loader_ReadDone(size_t index, TSEE_MappedFile *file, void *userdata) {
+	TSEE_Loader_Batch *batch = userdata;
+	TSEE_Texture_Job *job = batch->jobs[index];
+	// A failed read is tried again by the loader thread, which reports why it failed.
+	job->file = *file;
+	TSEE_Loader_Queue(batch->tsee, job);
+}
+
+/**
+ * @brief Thread reading a preload batch, so the caller doesn't block on it.
+ * 
+ * @param data The TSEE_Loader_Batch to read, freed once read.
+ * @return int
+ */
+int TSEE_Loader_ReadThread(void *data) {
+	TSEE_Loader_Batch *batch = data;
+	TSEE_IO_ReadBatch(batch->paths, batch->count, TSEE_Loader_ReadDone, batch);
+	xfree(batch->jobs);
+	xfree(batch->paths);
+	xfree(batch);
+	return 0;
+}
+
+/**
+ * @brief Loads a list of images ahead of them being used, reading every loose file in one batch
+ *        with TSEE_IO_ReadBatch and decoding each as soon as it's read.
+ *        Images already loaded or loading are skipped, images in archives are already in memory so go straight to the loader threads.
+ *        Textures created for the images after they finish loading are ready straight away.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param paths Paths of the images.
+ * @param count Number of paths.
+ * @param wait True to wait for every image to be decoded and uploaded before returning.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Loader_Preload(TSEE *tsee, char **paths, size_t count, bool wait) {
+	if (!TSEE_Loader_Init(tsee)) {
+		return false;
+	}
+	TSEE_Loader *loader = tsee->loader;
+	if (loader->io_thread) {
+		SDL_WaitThread(loader->io_thread, NULL);
+		loader->io_thread = NULL;
+	}
+	TSEE_Loader_Batch *batch = xmalloc(sizeof(*batch));
+	batch->tsee = tsee;
+	batch->jobs = xmalloc(sizeof(*batch->jobs) * (count ? count : 1));
+	batch->paths = xmalloc(sizeof(*batch->paths) * (count ? count : 1));
+	batch->count = 0;
+	for (size_t i = 0; i < count; i++) {
+		TSEE_Texture_Asset *asset = TSEE_TextureCache_GetAsset(tsee, paths[i]);
+		if (asset->texture || asset->tiles || asset->loading) continue;
+		asset->failed = false;
+		asset->loading = true;
+		if (TSEE_HashMap_Get(loader->jobs, asset->path) || TSEE_Pak_IsPacked(tsee, asset->path)) {
+			TSEE_Loader_Request(tsee, asset, NULL, NULL, NULL);
+			continue;
+		}
+		TSEE_Texture_Job *job = TSEE_Loader_CreateJob(tsee, asset);
+		batch->jobs[batch->count] = job;
+		batch->paths[batch->count] = job->path;
+		batch->count++;
+	}
+	if (batch->count > 0) {
+		loader->io_thread = SDL_CreateThread(TSEE_Loader_ReadThread, "TSEE IO", batch);
+		if (!loader->io_thread) {
+			TSEE_Warn("Failed to create preload thread, reading on this thread (%s)\n", SDL_GetError());
+			TSEE_Loader_ReadThread(batch);
+		}
+	} else {
+		TSEE_Loader_ReadThread(batch);
+	}
+	if (wait) {
+		TSEE_Loader_Wait(tsee);
+	}
+	return true;
+}
+
+/**
+ * @brief Waits for every queued image to be decoded and uploaded. Must be called on the render thread.
+ * 
+ * @param tsee TSEE object with the loader.
+ */
+void TSEE_Loader_Wait(TSEE *tsee) {
+	TSEE_Loader *loader = tsee->loader;
+	if (!loader) return;
+	if (loader->io_thread) {
+		SDL_WaitThread(loader->io_thread, NULL);
+		loader->io_thread = NULL;
+	}
+	double budget = loader->upload_budget;
+	// Nothing else is drawn until the loads finish, so there's no frame to keep to.
+	loader->upload_budget = 1000;
+	while (loader->jobs->size > 0) {
+		TSEE_Loader_Update(tsee);
+		if (loader->jobs->size > 0) {
+			SDL_Delay(1);
+		}
+	}
+	loader->upload_budget = budget;
+}
+
+/**
+ * @brief Stops a texture handle from being filled in by a load, for when it's destroyed early.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param texture Handle to cancel.
+ */
+void TSEE_Loader_Cancel(TSEE *tsee, TSEE_Texture *texture) {
+	if (!tsee->loader || !texture->path) return;
+	TSEE_Texture_Job *job = TSEE_HashMap_Get(tsee->loader->jobs, texture->path);
+	if (!job) return;
+	for (size_t i = 0; i < job->requests->size; i++) {
+		TSEE_Texture_Request *request = job->requests->data[i];
+		if (request->texture == texture) {
+			xfree(request);
+			TSEE_Array_Delete(job->requests, i);
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Stops an asset from being filled in by a load, for when it's destroyed or loaded another way.
+ *        Callbacks waiting on the job are still called when it finishes.
+ * 
+ * @param tsee TSEE object with the loader.
+ * @param asset Asset to cancel.
+ */
+void TSEE_Loader_CancelAsset(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (!tsee->loader) return;
+	TSEE_Texture_Job *job = TSEE_HashMap_Get(tsee->loader->jobs, asset->path);
+	if (job && job->asset == asset) {
+		job->asset = NULL;
+	}
+}
+
+/**
+ * @brief Frees a job and any requests left in it.
+ * 
+ * @param job Job to free.
+ */
+void TSEE_Loader_FreeJob(TSEE_Texture_Job *job) {
+	for (size_t i = 0; i < job->requests->size; i++) {
+		xfree(job->requests->data[i]);
+	}
+	TSEE_Array_Destroy(job->requests);
+	if (job->surface)
+		SDL_FreeSurface(job->surface);
+	TSEE_File_Unmap(&job->file);
+	xfree(job->path);
+	xfree(job);
+}
+
+/**
+ * @brief Uploads decoded textures and runs their callbacks, until the frame's upload budget is spent.
+ *        Must be called on the render thread, TSEE_RenderAll does this every frame.
+ * 
+ * @param tsee TSEE object with the loader.
+ */
+void TSEE_Loader_Update(TSEE *tsee) {
+	TSEE_Loader *loader = tsee->loader;
+	if (!loader) return;
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = loader->upload_budget * SDL_GetPerformanceFrequency() / 1000;
+	do {
+		SDL_LockMutex(loader->lock);
+		TSEE_Texture_Job *job = loader->decoded;
+		if (job) {
+			loader->decoded = job->next;
+			if (!loader->decoded) loader->decoded_tail = NULL;
+		}
+		SDL_UnlockMutex(loader->lock);
+		if (!job) break;
+
+		TSEE_HashMap_Delete(loader->jobs, job->path);
+		if (job->asset) {
+			TSEE_TextureCache_Finish(tsee, job->asset, job->surface, job->flags, job->hash);
+			job->surface = NULL;
+		}
+		for (size_t i = 0; i < job->requests->size; i++) {
+			TSEE_Texture_Request *request = job->requests->data[i];
+			if (request->callback) {
+				request->callback(tsee, request->texture, !TSEE_Texture_IsLoading(tsee, request->texture), request->userdata);
+			}
+		}
+		TSEE_Loader_FreeJob(job);
+	} while (SDL_GetPerformanceCounter() - start < budget);
+}
+
+/**
+ * @brief Stops the loader's threads and frees it, abandoning any loads still in progress.
+ * 
+ * @param tsee TSEE object with the loader.
+ */
+void TSEE_Loader_Destroy(TSEE *tsee) {
+	TSEE_Loader *loader = tsee->loader;
+	if (!loader) return;
+	if (loader->io_thread) {
+		SDL_WaitThread(loader->io_thread, NULL);
+		loader->io_thread = NULL;
+	}
+	SDL_LockMutex(loader->lock);
+	loader->quit = true;
+	SDL_CondBroadcast(loader->wake);
+	SDL_UnlockMutex(loader->lock);
+	for (int i = 0; i < loader->thread_count; i++) {
+		SDL_WaitThread(loader->threads[i], NULL);
+	}
+	TSEE_Texture_Job *lists[2] = {loader->pending, loader->decoded};
+	for (int i = 0; i < 2; i++) {
+		TSEE_Texture_Job *job = lists[i];
+		while (job) {
+			TSEE_Texture_Job *next = job->next;
+			TSEE_Loader_FreeJob(job);
+			job = next;
+		}
+	}
+	TSEE_HashMap_Destroy(loader->jobs);
+	SDL_DestroyTexture(loader->placeholder);
+	SDL_DestroyCond(loader->wake);
+	SDL_DestroyMutex(loader->lock);
+	xfree(loader);
+	tsee->loader = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "../tsee.h"
+
+#define TSEE_RENDERQUEUE_ORDER_BITS 24
+#define TSEE_RENDERQUEUE_ORDER_MASK ((1 << TSEE_RENDERQUEUE_ORDER_BITS) - 1)
+
+/**
+ * @brief Creates an empty render queue.
+ * 
+ * @return TSEE_RenderQueue*
+ */
+TSEE_RenderQueue *TSEE_RenderQueue_Create() {
+	TSEE_RenderQueue *queue = xmalloc(sizeof(*queue));
+	queue->keys = NULL;
+	queue->scratch = NULL;
+	queue->items = NULL;
+	queue->size = 0;
+	queue->capacity = 0;
+	return queue;
+}
+
+/**
+ * @brief Builds a sort key for an object.
+ * 
+ * @param layer Layer the object is drawn in.
+ * @param depth Depth inside the layer, lower is drawn first.
+ * @param textureId ID of the object's texture.
+ * @param order Order the object was submitted in.
+ * @return Uint64
+ */
+Uint64 TSEE_RenderQueue_MakeKey(TSEE_Render_Layer layer, int depth, Uint32 textureId, size_t order) {
+	if (depth < -32768) depth = -32768;
+	if (depth > 32767) depth = 32767;
+	Uint64 key = (Uint64)(layer & 0xFF) << 56;
+	key |= (Uint64)(Uint16)(depth + 32768) << 40;
+	key |= (Uint64)(textureId & 0xFFFF) << TSEE_RENDERQUEUE_ORDER_BITS;
+	key |= (Uint64)(order & TSEE_RENDERQUEUE_ORDER_MASK);
+	return key;
+}
+
+/**
+ * @brief Adds an object to be drawn this frame.
+ * 
+ * @param queue Queue to add to.
+ * @param obj Object to draw.
+ * @return true on success, false on fail.
+ */
+bool TSEE_RenderQueue_Submit(TSEE_RenderQueue *queue, TSEE_Object *obj) {
+	if (queue->size > TSEE_RENDERQUEUE_ORDER_MASK) {
+		TSEE_Warn("Render queue is full, dropping object.\n");
+		return false;
+	}
+	if (queue->size == queue->capacity) {
+		size_t capacity = queue->capacity ? queue->capacity * 2 : 256;
+		Uint64 *keys = xrealloc(queue->keys, sizeof(*keys) * capacity);
+		if (!keys) return false;
+		queue->keys = keys;
+		Uint64 *scratch = xrealloc(queue->scratch, sizeof(*scratch) * capacity);
+		if (!scratch) return false;
+		queue->scratch = scratch;
+		TSEE_Object **items = xrealloc(queue->items, sizeof(*items) * capacity);
+		if (!items) return false;
+		queue->items = items;
+		queue->capacity = capacity;
+	}
+	Uint32 textureId = obj->texture ? obj->texture->id : 0;
+	queue->keys[queue->size] = TSEE_RenderQueue_MakeKey(obj->layer, obj->depth, textureId, queue->size);
+	queue->items[queue->size] = obj;
+	queue->size++;
+	return true;
+}
+
+/**
+ * @brief Sorts the queue by key with an LSD radix sort.
+ *        Bytes which are the same in every key are skipped.
+ * 
+ * @param queue Queue to sort.
+ */
+void TSEE_RenderQueue_Sort(TSEE_RenderQueue *queue) {
+	if (queue->size < 2) return;
+	size_t counts[8][256] = {{0}};
+	for (size_t i = 0; i < queue->size; i++) {
+		Uint64 key = queue->keys[i];
+		for (int byte = 0; byte < 8; byte++) {
+			counts[byte][(key >> (byte * 8)) & 0xFF]++;
+		}
+	}
+	Uint64 *src = queue->keys;
+	Uint64 *dst = queue->scratch;
+	for (int byte = 0; byte < 8; byte++) {
+		size_t *count = counts[byte];
+		if (count[(src[0] >> (byte * 8)) & 0xFF] == queue->size) continue;
+		size_t offset = 0;
+		for (int i = 0; i < 256; i++) {
+			size_t c = count[i];
+			count[i] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < queue->size; i++) {
+			dst[count[(src[i] >> (byte * 8)) & 0xFF]++] = src[i];
+		}
+		Uint64 *tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+	queue->keys = src;
+	queue->scratch = dst;
+}
+
+/**
+ * @brief Sorts and renders everything in the queue, then empties it.
+ * 
+ * @param tsee TSEE to render to.
+ * @return true on success, false if any object failed to render.
+ */
+bool TSEE_RenderQueue_Flush(TSEE *tsee) {
+	TSEE_RenderQueue *queue = tsee->render_queue;
+	bool success = true;
+	TSEE_RenderQueue_Sort(queue);
+	for (size_t i = 0; i < queue->size; i++) {
+		TSEE_Object *obj = queue->items[queue->keys[i] & TSEE_RENDERQUEUE_ORDER_MASK];
+		if (!TSEE_Object_Render(tsee, obj)) {
+			TSEE_Warn("Failed to render object\n");
+			success = false;
+		}
+	}
+	queue->size = 0;
+	return success;
+}
+
+/**
+ * @brief Destroys a render queue.
+ * 
+ * @param queue Queue to destroy.
+ */
+void TSEE_RenderQueue_Destroy(TSEE_RenderQueue *queue) {
+	if (!queue) return;
+	if (queue->keys)
+		xfree(queue->keys);
+	if (queue->scratch)
+		xfree(queue->scratch);
+	if (queue->items)
+		xfree(queue->items);
+	xfree(queue);
+}
@@ -37,6 +37,18 @@ bool TSEE_Rendering_Init(TSEE *tsee) {
 		return false;
 	}
 
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(tsee->window->renderer, &info) == 0) {
+		tsee->window->max_texture_width = info.max_texture_width;
+		tsee->window->max_texture_height = info.max_texture_height;
+	}
+	tsee->window->native_format = TSEE_Image_FindNativeFormat(tsee->window->renderer);
+	if (tsee->window->native_format == SDL_PIXELFORMAT_UNKNOWN) {
+		TSEE_Warn("Renderer has no 32-bit texture format to convert images to, SDL will convert them.\n");
+	} else {
+		TSEE_Log("Converting images to %s\n", SDL_GetPixelFormatName(tsee->window->native_format));
+	}
+
 	if (SDL_GetCurrentDisplayMode(0, &tsee->window->mode) != 0) {
 		TSEE_Warn("Failed to get display mode (%s)\n", SDL_GetError());
 		tsee->window->fps = 60;
@@ -103,93 +115,43 @@ bool TSEE_RenderAll(TSEE *tsee) {
 		SDL_Delay(25);
 		return true;
 	}
+	TSEE_Loader_Update(tsee);
+	TSEE_MapLoad_Update(tsee);
+	TSEE_MapSave_Update(tsee);
+	TSEE_MapStream_Update(tsee);
+
 	SDL_SetRenderDrawColor(tsee->window->renderer, 0, 0, 0, 255);
 	SDL_RenderClear(tsee->window->renderer);
 
-	// Render all objects
+	// Queue every visible object, then draw them sorted by layer, depth and texture
+	SDL_Rect screen = {0, 0, tsee->window->width, tsee->window->height};
 	for (size_t i = 0; i < tsee->world->objects->size; i++) {
-		TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
-		if (!TSEE_Object_Render(tsee, obj)) {
-			TSEE_Warn("Failed to render object\n");
-		}
+		TSEE_Object *obj = tsee->world->objects->data[i];
+		if (!TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PARALLAX) && !SDL_HasIntersection(&obj->texture->rect, &screen)) continue;
+		TSEE_RenderQueue_Submit(tsee->render_queue, obj);
 	}
+	TSEE_RenderQueue_Flush(tsee);
 
 	if (!TSEE_UI_Render(tsee)) {
 		TSEE_Warn("Failed to render all of UI\n");
 	}
 
 	if (tsee->debug->active) {
-		char text[128];
-		SDL_Color colour = {255, 255, 255, SDL_ALPHA_OPAQUE};
-		int height_off = 0;
-		sprintf(text, "Event: %.3f ms", tsee->debug->event_time);
-		TSEE_Object *tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_SetRenderDrawColor(tsee->window->renderer, 100, 100, 100, 255);
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Physics: %.3f ms", tsee->debug->physics_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Render: %.3f ms", tsee->debug->render_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Object Render: %.3f ms", tsee->debug->render_times.object_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Parallax Render: %.3f ms", tsee->debug->render_times.parallax_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Frame: %.3f ms", tsee->debug->frame_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
-		sprintf(text, "Framerate: %.3f", 1000 / tsee->debug->frame_time);
-		tex = TSEE_Text_Create(tsee, "_default", text, colour);
-		tex->texture->rect.x = 0;
-		tex->texture->rect.y = height_off;
-		height_off += tex->texture->rect.h;
-		SDL_RenderFillRect(tsee->window->renderer, &tex->texture->rect);
-		TSEE_Text_Render(tsee, tex);
-		TSEE_Text_Destroy(tsee, tex, true);
+		TSEE_Debug_Render(tsee);
 	}
 
 	SDL_RenderPresent(tsee->window->renderer);
+	TSEE_TextureCache_Update(tsee);
 	tsee->debug->framerate = 1000 / (tsee->window->last_render - SDL_GetPerformanceCounter()) / (double)SDL_GetPerformanceFrequency();
 	tsee->window->last_render = SDL_GetPerformanceCounter();
 	tsee->debug->render_time = (tsee->window->last_render - start) * 1000 / (double)SDL_GetPerformanceFrequency();
 	tsee->debug->frame_time = tsee->debug->event_time + tsee->debug->physics_time + tsee->debug->render_time;
+	TSEE_Debug_RecordFrame(tsee);
 	tsee->debug->event_time = 0;
 	tsee->debug->physics_time = 0;
 	tsee->debug->render_times.object_time = 0;
 	tsee->debug->render_times.parallax_time = 0;
+	tsee->debug->render_times.upload_time = 0;
 	return true;
 }
 
@@ -0,0 +1,534 @@
+#include "../tsee.h"
+
+#define TSEE_TEXTURECACHE_DEFAULT_FRAMES 120
+#define TSEE_TEXTURECACHE_DEFAULT_VIRTUAL_SIZE 4096
+#define TSEE_TEXTURECACHE_DEFAULT_TILE_SIZE 512
+
+/**
+ * @brief Creates an empty texture cache with no memory budget.
+ * 
+ * @return TSEE_TextureCache*
+ */
+TSEE_TextureCache *TSEE_TextureCache_Create() {
+	TSEE_TextureCache *cache = xmalloc(sizeof(*cache));
+	cache->assets = TSEE_HashMap_Create();
+	cache->contents = TSEE_HashMap_Create();
+	cache->newest = NULL;
+	cache->oldest = NULL;
+	cache->bytes = 0;
+	cache->budget = 0;
+	cache->saved = 0;
+	cache->evict_after = TSEE_TEXTURECACHE_DEFAULT_FRAMES;
+	cache->frame = 0;
+	cache->async_reload = false;
+	cache->dedup = false;
+	cache->tiled = TSEE_Array_Create();
+	cache->virtual_size = TSEE_TEXTURECACHE_DEFAULT_VIRTUAL_SIZE;
+	cache->tile_size = TSEE_TEXTURECACHE_DEFAULT_TILE_SIZE;
+	cache->tile_uploads = 0;
+	return cache;
+}
+
+/**
+ * @brief Sets how much memory file textures may use before the least recently drawn are evicted.
+ * 
+ * @param tsee TSEE object to set the budget for.
+ * @param bytes Memory budget in bytes, 0 for no limit.
+ * @param frames Frames a texture must go undrawn before it can be evicted.
+ */
+void TSEE_TextureCache_SetBudget(TSEE *tsee, size_t bytes, Uint32 frames) {
+	tsee->texture_cache->budget = bytes;
+	tsee->texture_cache->evict_after = frames;
+}
+
+/**
+ * @brief Sets whether evicted textures are reloaded through the texture loader.
+ *        Async reloads show the placeholder for a few frames rather than stalling the frame.
+ * 
+ * @param tsee TSEE object to set it for.
+ * @param async True to reload on the loader's threads, false to reload immediately.
+ */
+void TSEE_TextureCache_SetAsyncReload(TSEE *tsee, bool async) {
+	tsee->texture_cache->async_reload = async;
+}
+
+/**
+ * @brief Sets whether images are hashed after decoding, so identical images under different paths share one SDL_Texture.
+ *        Only images loaded after it's turned on are deduplicated.
+ * 
+ * @param tsee TSEE object to set it for.
+ * @param dedup True to deduplicate, false to only share textures loaded from the same path.
+ */
+void TSEE_TextureCache_SetDedup(TSEE *tsee, bool dedup) {
+	tsee->texture_cache->dedup = dedup;
+}
+
+/**
+ * @brief Sets when images are split into tiles that are only uploaded near the camera.
+ *        Images too big for the renderer are always tiled. Only affects images loaded afterwards.
+ * 
+ * @param tsee TSEE object to set it for.
+ * @param size Images wider or taller than this are tiled, 0 to only tile images too big for the renderer.
+ * @param tileSize Width and height of a tile.
+ */
+void TSEE_TextureCache_SetVirtual(TSEE *tsee, int size, int tileSize) {
+	tsee->texture_cache->virtual_size = size;
+	tsee->texture_cache->tile_size = tileSize > 0 ? tileSize : TSEE_TEXTURECACHE_DEFAULT_TILE_SIZE;
+}
+
+/**
+ * @brief Finds the asset for a path, creating an unloaded one if there isn't one.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param path Path of the image.
+ * @return TSEE_Texture_Asset*
+ */
+TSEE_Texture_Asset *TSEE_TextureCache_GetAsset(TSEE *tsee, char *path) {
+	TSEE_Texture_Asset *asset = TSEE_HashMap_Get(tsee->texture_cache->assets, path);
+	if (asset) {
+		return asset;
+	}
+	asset = xmalloc(sizeof(*asset));
+	asset->path = strdup(path);
+	asset->texture = NULL;
+	asset->users = TSEE_Array_Create();
+	asset->id = ++tsee->last_texture_id;
+	asset->width = 0;
+	asset->height = 0;
+	asset->bytes = 0;
+	asset->last_used = tsee->texture_cache->frame;
+	asset->pins = 0;
+	asset->loading = false;
+	asset->failed = false;
+	asset->hash = 0;
+	asset->aliases = TSEE_Array_Create();
+	asset->saved = 0;
+	asset->tiles = NULL;
+	asset->prev = NULL;
+	asset->next = NULL;
+	TSEE_HashMap_Set(tsee->texture_cache->assets, path, asset);
+	return asset;
+}
+
+/**
+ * @brief Removes an asset from the list of resident assets.
+ * 
+ * @param cache Cache the asset is in.
+ * @param asset Asset to unlink.
+ */
+void TSEE_TextureCache_Unlink(TSEE_TextureCache *cache, TSEE_Texture_Asset *asset) {
+	if (asset->prev) asset->prev->next = asset->next;
+	else if (cache->newest == asset) cache->newest = asset->next;
+	if (asset->next) asset->next->prev = asset->prev;
+	else if (cache->oldest == asset) cache->oldest = asset->prev;
+	asset->prev = NULL;
+	asset->next = NULL;
+}
+
+/**
+ * @brief Marks an asset as drawn this frame, moving it to the front of the resident list.
+ *        Pinned assets aren't in the list, so they're only marked.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset that was drawn.
+ */
+void TSEE_TextureCache_Touch(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	asset->last_used = cache->frame;
+	if (!asset->texture || asset->pins > 0 || cache->newest == asset) {
+		return;
+	}
+	TSEE_TextureCache_Unlink(cache, asset);
+	asset->next = cache->newest;
+	if (cache->newest) cache->newest->prev = asset;
+	cache->newest = asset;
+	if (!cache->oldest) cache->oldest = asset;
+}
+
+/**
+ * @brief Pins an asset, so it isn't evicted however long it goes undrawn. Pins are counted.
+ *        Tiled assets still release tiles away from the camera.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to pin.
+ */
+void TSEE_TextureCache_Pin(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (asset->pins++ == 0) {
+		TSEE_TextureCache_Unlink(tsee->texture_cache, asset);
+	}
+}
+
+/**
+ * @brief Removes a pin from an asset. Once it has none it can be evicted again, starting as the most recently drawn.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to unpin.
+ */
+void TSEE_TextureCache_Unpin(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (asset->pins == 0 || --asset->pins > 0) {
+		return;
+	}
+	TSEE_TextureCache_Touch(tsee, asset);
+}
+
+/**
+ * @brief Gives an asset its SDL_Texture (or takes it away), updating every texture using it and the memory used.
+ *        Textures using an asset without an SDL_Texture draw the loader's placeholder while it loads, or nothing.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to update.
+ * @param texture New SDL_Texture, or NULL. The old one isn't destroyed.
+ */
+void TSEE_TextureCache_SetTexture(TSEE *tsee, TSEE_Texture_Asset *asset, SDL_Texture *texture) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	if (asset->texture) {
+		TSEE_TextureCache_Unlink(cache, asset);
+		cache->bytes -= asset->bytes;
+		asset->bytes = 0;
+	}
+	// Textures made before the first load are the placeholder's size, reloads keep the size they were given.
+	bool resize = texture && asset->width == 0;
+	asset->texture = texture;
+	if (texture) {
+		Uint32 format;
+		SDL_QueryTexture(texture, &format, NULL, &asset->width, &asset->height);
+		int bpp = SDL_ISPIXELFORMAT_FOURCC(format) ? 4 : SDL_BYTESPERPIXEL(format);
+		asset->bytes = (size_t)asset->width * asset->height * bpp;
+		cache->bytes += asset->bytes;
+		asset->failed = false;
+		TSEE_TextureCache_Touch(tsee, asset);
+	}
+	SDL_Texture *shown = texture;
+	if (!shown && tsee->loader && (asset->loading || asset->failed)) {
+		shown = tsee->loader->placeholder;
+	}
+	for (size_t i = 0; i < asset->users->size; i++) {
+		TSEE_Texture *user = asset->users->data[i];
+		if (resize) {
+			user->rect.w = asset->width;
+			user->rect.h = asset->height;
+		}
+		user->texture = shown;
+	}
+	if (resize) {
+		// Static objects using it were merged into colliders while they had no size.
+		tsee->world->colliders_valid = false;
+	}
+}
+
+/**
+ * @brief Gives an asset tiles to draw instead of an SDL_Texture. Textures using it are drawn by TSEE_Texture_Render.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to update, it can't have an SDL_Texture.
+ * @param tiles Tiles of the asset's image.
+ */
+void TSEE_TextureCache_SetTiles(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Tiles *tiles) {
+	bool resize = asset->width == 0;
+	asset->tiles = tiles;
+	asset->width = tiles->surface->w;
+	asset->height = tiles->surface->h;
+	asset->failed = false;
+	for (size_t i = 0; i < asset->users->size; i++) {
+		TSEE_Texture *user = asset->users->data[i];
+		if (resize) {
+			user->rect.w = asset->width;
+			user->rect.h = asset->height;
+		}
+		user->texture = NULL;
+	}
+	if (resize) {
+		tsee->world->colliders_valid = false;
+	}
+	TSEE_Array_Append(tsee->texture_cache->tiled, asset);
+}
+
+/**
+ * @brief Merges an asset into another with identical pixels, so its textures draw the other's SDL_Texture.
+ *        The merged asset is freed and its path becomes an alias of the original.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to merge, it can't have an SDL_Texture.
+ * @param original Asset to merge into.
+ * @param surface The decoded image both assets share.
+ * @return TSEE_Texture_Asset* The original.
+ */
+TSEE_Texture_Asset *TSEE_TextureCache_Merge(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Asset *original, SDL_Surface *surface) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	if (original->loading) {
+		// This decode is as good as the one in flight, don't let that one replace it.
+		TSEE_Loader_CancelAsset(tsee, original);
+		original->loading = false;
+	}
+	SDL_Texture *shown = original->texture;
+	if (!shown && !original->tiles && tsee->loader) {
+		shown = tsee->loader->placeholder;
+	}
+	for (size_t i = 0; i < asset->users->size; i++) {
+		TSEE_Texture *user = asset->users->data[i];
+		if (asset->width == 0) {
+			user->rect.w = surface->w;
+			user->rect.h = surface->h;
+		}
+		user->asset = original;
+		user->id = original->id;
+		user->texture = shown;
+		TSEE_Array_Append(original->users, user);
+	}
+	if (asset->width == 0) {
+		tsee->world->colliders_valid = false;
+	}
+	if (asset->pins > 0) {
+		if (original->pins == 0) {
+			TSEE_TextureCache_Unlink(cache, original);
+		}
+		original->pins += asset->pins;
+	}
+	TSEE_Array_Append(asset->aliases, asset->path);
+	for (size_t i = 0; i < asset->aliases->size; i++) {
+		TSEE_HashMap_Set(cache->assets, asset->aliases->data[i], original);
+		TSEE_Array_Append(original->aliases, asset->aliases->data[i]);
+	}
+	size_t saved = (size_t)surface->w * surface->h * surface->format->BytesPerPixel;
+	original->saved += asset->saved + saved;
+	cache->saved += saved;
+	TSEE_Log("Texture `%s` is identical to `%s`, sharing it\n", asset->path, original->path);
+	TSEE_Array_Destroy(asset->aliases);
+	TSEE_Array_Destroy(asset->users);
+	xfree(asset);
+	return original;
+}
+
+/**
+ * @brief Checks if an image whose hash matches an asset's really is the same image, so a hash collision can't draw the wrong one.
+ *        Identical files are the same image, otherwise the original's image is decoded again and compared pixel by pixel.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset that was loaded.
+ * @param original Asset with the same hash.
+ * @param surface The asset's decoded image.
+ * @param flags TSEE_Image_Flags of the surface.
+ * @return true if the original draws exactly the same image.
+ */
+bool TSEE_TextureCache_IsDuplicate(TSEE *tsee, TSEE_Texture_Asset *asset, TSEE_Texture_Asset *original, SDL_Surface *surface, Uint32 flags) {
+	if (original->width != surface->w || original->height != surface->h) {
+		return false;
+	}
+	TSEE_MappedFile file;
+	TSEE_MappedFile originalFile;
+	if (TSEE_Pak_Map(tsee, asset->path, &file)) {
+		bool same = false;
+		if (TSEE_Pak_Map(tsee, original->path, &originalFile)) {
+			same = file.size == originalFile.size && (file.size == 0 || memcmp(file.data, originalFile.data, file.size) == 0);
+			TSEE_File_Unmap(&originalFile);
+		}
+		TSEE_File_Unmap(&file);
+		if (same) {
+			return true;
+		}
+	}
+	Uint32 originalFlags = 0;
+	SDL_Surface *decoded = TSEE_Image_LoadSurface(tsee, original->path, &originalFlags);
+	if (!decoded) {
+		return false;
+	}
+	bool same = (originalFlags & TSEE_IMAGE_PREMULTIPLIED) == (flags & TSEE_IMAGE_PREMULTIPLIED) && TSEE_Image_Equal(decoded, surface);
+	SDL_FreeSurface(decoded);
+	if (!same) {
+		TSEE_Warn("Textures `%s` and `%s` have the same hash but different pixels, not sharing them\n", asset->path, original->path);
+	}
+	return same;
+}
+
+/**
+ * @brief Uploads a decoded image to its asset, or merges the asset into one with identical pixels.
+ *        Images too big to upload whole are split into tiles.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset that was loaded.
+ * @param surface Decoded image, or NULL if decoding failed. It's freed, or kept if the image is tiled.
+ * @param flags TSEE_Image_Flags of the surface.
+ * @param hash TSEE_Image_Hash of the surface, or 0 to skip deduplication.
+ * @return TSEE_Texture_Asset* The asset now drawing the image, or NULL on fail.
+ */
+TSEE_Texture_Asset *TSEE_TextureCache_Finish(TSEE *tsee, TSEE_Texture_Asset *asset, SDL_Surface *surface, Uint32 flags, Uint64 hash) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	asset->loading = false;
+	if (surface && hash) {
+		TSEE_Texture_Asset *original = TSEE_HashMap_Lookup(cache->contents, hash, NULL);
+		if (original && original != asset && TSEE_TextureCache_IsDuplicate(tsee, asset, original, surface, flags)) {
+			asset = TSEE_TextureCache_Merge(tsee, asset, original, surface);
+			if (asset->texture || asset->tiles) {
+				TSEE_TextureCache_Touch(tsee, asset);
+				SDL_FreeSurface(surface);
+				return asset;
+			}
+		}
+	}
+	if (surface && TSEE_Tiles_Wanted(tsee, surface)) {
+		TSEE_Texture_Tiles *tiles = TSEE_Tiles_Create(tsee, surface, flags);
+		if (!tiles) {
+			TSEE_Error("Couldn't split texture `%s` into tiles (%s)\n", asset->path, SDL_GetError());
+			asset->failed = true;
+			TSEE_TextureCache_SetTexture(tsee, asset, NULL);
+			return NULL;
+		}
+		TSEE_TextureCache_SetTiles(tsee, asset, tiles);
+	} else {
+		SDL_Texture *texture = surface ? TSEE_Image_Upload(tsee, surface, flags) : NULL;
+		if (surface)
+			SDL_FreeSurface(surface);
+		if (!texture) {
+			TSEE_Error("Couldn't load texture from file `%s`\n", asset->path);
+			asset->failed = true;
+			TSEE_TextureCache_SetTexture(tsee, asset, NULL);
+			return NULL;
+		}
+		TSEE_TextureCache_SetTexture(tsee, asset, texture);
+	}
+	if (hash && !asset->hash) {
+		asset->hash = hash;
+		TSEE_HashMap_Insert(cache->contents, hash, NULL, asset);
+	}
+	return asset;
+}
+
+/**
+ * @brief Loads an asset's image and uploads it, on this thread.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to load.
+ * @return TSEE_Texture_Asset* The asset now drawing the image, which is another asset if it was a duplicate, or NULL on fail.
+ */
+TSEE_Texture_Asset *TSEE_TextureCache_Load(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (asset->loading) {
+		// Don't let a decode that's still running replace this one.
+		TSEE_Loader_CancelAsset(tsee, asset);
+		asset->loading = false;
+	}
+	Uint32 flags = 0;
+	SDL_Surface *surface = TSEE_Image_LoadSurface(tsee, asset->path, &flags);
+	Uint64 hash = surface && tsee->texture_cache->dedup ? TSEE_Image_Hash(surface, flags) : 0;
+	return TSEE_TextureCache_Finish(tsee, asset, surface, flags, hash);
+}
+
+/**
+ * @brief Makes sure a texture's image is resident before it's drawn, reloading it if it was evicted.
+ *        Called by the object renderers, so evicted textures come back without anything else knowing.
+ * 
+ * @param tsee TSEE object the texture is in.
+ * @param texture Texture about to be drawn.
+ * @return true if the texture has something to draw, false otherwise.
+ */
+bool TSEE_Texture_Use(TSEE *tsee, TSEE_Texture *texture) {
+	TSEE_Texture_Asset *asset = texture->asset;
+	if (!asset) {
+		return texture->texture != NULL;
+	}
+	if (!asset->texture && !asset->tiles && !asset->loading && !asset->failed) {
+		TSEE_Log("Reloading evicted texture `%s`\n", asset->path);
+		if (tsee->texture_cache->async_reload && TSEE_Loader_Init(tsee)) {
+			asset->loading = TSEE_Loader_Request(tsee, asset, NULL, NULL, NULL);
+			TSEE_TextureCache_SetTexture(tsee, asset, NULL);
+		}
+		if (!asset->loading) {
+			TSEE_TextureCache_Load(tsee, asset);
+		}
+	}
+	TSEE_TextureCache_Touch(tsee, texture->asset);
+	return texture->texture != NULL || texture->asset->tiles;
+}
+
+/**
+ * @brief Evicts an asset, destroying its SDL_Texture or tiles until it's next drawn.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to evict.
+ */
+void TSEE_TextureCache_Evict(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (asset->tiles) {
+		TSEE_Tiles_Release(tsee, asset, 0);
+		return;
+	}
+	SDL_Texture *texture = asset->texture;
+	if (!texture) return;
+	TSEE_TextureCache_SetTexture(tsee, asset, NULL);
+	SDL_DestroyTexture(texture);
+}
+
+/**
+ * @brief Ends the frame, evicting the least recently drawn textures while over budget.
+ *        Textures drawn in the last evict_after frames are never evicted, even over budget.
+ * 
+ * @param tsee TSEE object with the cache.
+ */
+void TSEE_TextureCache_Update(TSEE *tsee) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	while (cache->budget && cache->bytes > cache->budget && cache->oldest
+		&& cache->frame - cache->oldest->last_used >= cache->evict_after) {
+		TSEE_Texture_Asset *asset = cache->oldest;
+		TSEE_Log("Evicting texture `%s` (%zu bytes, unused for %llu frames)\n", asset->path, asset->bytes, (unsigned long long)(cache->frame - asset->last_used));
+		TSEE_TextureCache_Evict(tsee, asset);
+	}
+	TSEE_Tiles_Update(tsee);
+	cache->frame++;
+}
+
+/**
+ * @brief Destroys an asset once nothing uses it.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Asset to destroy.
+ */
+void TSEE_TextureCache_DestroyAsset(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	if (asset->loading) {
+		TSEE_Loader_CancelAsset(tsee, asset);
+	}
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	TSEE_TextureCache_Evict(tsee, asset);
+	TSEE_Tiles_Destroy(tsee, asset);
+	TSEE_HashMap_Delete(cache->assets, asset->path);
+	for (size_t i = 0; i < asset->aliases->size; i++) {
+		TSEE_HashMap_Delete(cache->assets, asset->aliases->data[i]);
+		xfree(asset->aliases->data[i]);
+	}
+	if (asset->hash && TSEE_HashMap_Lookup(cache->contents, asset->hash, NULL) == asset) {
+		TSEE_HashMap_Remove(cache->contents, asset->hash, NULL);
+	}
+	cache->saved -= asset->saved;
+	TSEE_Array_Destroy(asset->aliases);
+	TSEE_Array_Destroy(asset->users);
+	xfree(asset->path);
+	xfree(asset);
+}
+
+/**
+ * @brief Destroys the texture cache. Every texture should already have been destroyed.
+ * 
+ * @param tsee TSEE object with the cache.
+ */
+void TSEE_TextureCache_Destroy(TSEE *tsee) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	if (!cache) return;
+	// Collect the assets first, destroying one deletes its aliases from anywhere in the map.
+	TSEE_Array *assets = TSEE_Array_Create();
+	for (size_t i = 0; i < cache->assets->capacity; i++) {
+		TSEE_HashMap_Entry *entry = &cache->assets->entries[i];
+		TSEE_Texture_Asset *asset = entry->value;
+		if (entry->used && strcmp(entry->key, asset->path) == 0) {
+			TSEE_Array_Append(assets, asset);
+		}
+	}
+	for (size_t i = 0; i < assets->size; i++) {
+		TSEE_Texture_Asset *asset = assets->data[i];
+		TSEE_Warn("Texture `%s` is still in use\n", asset->path);
+		asset->users->size = 0;
+		TSEE_TextureCache_DestroyAsset(tsee, asset);
+	}
+	TSEE_Array_Destroy(assets);
+	TSEE_HashMap_Destroy(cache->assets);
+	TSEE_HashMap_Destroy(cache->contents);
+	TSEE_Array_Destroy(cache->tiled);
+	xfree(cache);
+	tsee->texture_cache = NULL;
+}
\ No newline at end of file
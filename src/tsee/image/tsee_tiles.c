@@ -0,0 +1,229 @@
+#include "../tsee.h"
+
+#define TSEE_TILES_PREFETCH_PER_FRAME 2
+#define TSEE_TILES_KEEP_FRAMES 30
+
+/**
+ * @brief Checks if an image should be split into tiles rather than uploaded as one texture.
+ * 
+ * @param tsee TSEE object with the cache and renderer.
+ * @param surface Decoded image.
+ * @return true if it's bigger than the renderer allows or the cache's virtual size, false otherwise.
+ */
+bool TSEE_Tiles_Wanted(TSEE *tsee, SDL_Surface *surface) {
+	TSEE_TextureCache *cache = tsee->texture_cache;
+	TSEE_Window *window = tsee->window;
+	if (window->max_texture_width > 0 && surface->w > window->max_texture_width) return true;
+	if (window->max_texture_height > 0 && surface->h > window->max_texture_height) return true;
+	return cache->virtual_size > 0 && (surface->w > cache->virtual_size || surface->h > cache->virtual_size);
+}
+
+/**
+ * @brief Splits a decoded image into tiles. No tiles are uploaded until they're drawn.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param surface Decoded image, the tiles take it and free it when destroyed.
+ * @param flags TSEE_Image_Flags of the surface.
+ * @return TSEE_Texture_Tiles* or NULL on fail, the surface is freed either way.
+ */
+TSEE_Texture_Tiles *TSEE_Tiles_Create(TSEE *tsee, SDL_Surface *surface, Uint32 flags) {
+	// Tiles are uploaded straight from the surface, so it needs to be 32-bit and own its pixels.
+	if (!(flags & TSEE_IMAGE_COOKED) || (surface->flags & SDL_PREALLOC)) {
+		SDL_Surface *converted = (flags & TSEE_IMAGE_COOKED) ? SDL_ConvertSurface(surface, surface->format, 0) : SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(surface);
+		if (!converted) {
+			return NULL;
+		}
+		surface = converted;
+		flags |= TSEE_IMAGE_COOKED;
+	}
+	TSEE_Texture_Tiles *tiles = xmalloc(sizeof(*tiles));
+	tiles->surface = surface;
+	tiles->flags = flags;
+	tiles->size = tsee->texture_cache->tile_size;
+	tiles->columns = (surface->w + tiles->size - 1) / tiles->size;
+	tiles->rows = (surface->h + tiles->size - 1) / tiles->size;
+	size_t count = (size_t)tiles->columns * tiles->rows;
+	tiles->tiles = xmalloc(sizeof(*tiles->tiles) * count);
+	tiles->last_used = xmalloc(sizeof(*tiles->last_used) * count);
+	memset(tiles->tiles, 0, sizeof(*tiles->tiles) * count);
+	memset(tiles->last_used, 0, sizeof(*tiles->last_used) * count);
+	tiles->tile_bytes = (size_t)tiles->size * tiles->size * surface->format->BytesPerPixel;
+	tiles->resident = 0;
+	TSEE_Log("Split %dx%d image into %dx%d tiles of %d pixels\n", surface->w, surface->h, tiles->columns, tiles->rows, tiles->size);
+	return tiles;
+}
+
+/**
+ * @brief Gets the part of the image a tile covers.
+ * 
+ * @param tiles Tiles of the image.
+ * @param index Index of the tile, row * columns + column.
+ * @return SDL_Rect
+ */
+SDL_Rect TSEE_Tiles_GetRect(TSEE_Texture_Tiles *tiles, size_t index) {
+	SDL_Rect rect = {(index % tiles->columns) * tiles->size, (index / tiles->columns) * tiles->size, tiles->size, tiles->size};
+	if (rect.x + rect.w > tiles->surface->w) rect.w = tiles->surface->w - rect.x;
+	if (rect.y + rect.h > tiles->surface->h) rect.h = tiles->surface->h - rect.y;
+	return rect;
+}
+
+/**
+ * @brief Uploads a tile from the image kept in memory.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Tiled asset.
+ * @param index Index of the tile.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Tiles_Upload(TSEE *tsee, TSEE_Texture_Asset *asset, size_t index) {
+	TSEE_Texture_Tiles *tiles = asset->tiles;
+	if (tiles->tiles[index]) {
+		return true;
+	}
+	SDL_Surface *surface = tiles->surface;
+	SDL_Rect rect = TSEE_Tiles_GetRect(tiles, index);
+	Uint8 *pixels = (Uint8 *)surface->pixels + (size_t)rect.y * surface->pitch + (size_t)rect.x * surface->format->BytesPerPixel;
+	SDL_Surface *tile = SDL_CreateRGBSurfaceWithFormatFrom(pixels, rect.w, rect.h, surface->format->BitsPerPixel, surface->pitch, surface->format->format);
+	if (!tile) {
+		return false;
+	}
+	tiles->tiles[index] = TSEE_Image_Upload(tsee, tile, tiles->flags);
+	SDL_FreeSurface(tile);
+	if (!tiles->tiles[index]) {
+		TSEE_Error("Failed to upload tile %zu of `%s` (%s)\n", index, asset->path, SDL_GetError());
+		return false;
+	}
+	tiles->last_used[index] = tsee->texture_cache->frame;
+	tiles->resident++;
+	asset->bytes += tiles->tile_bytes;
+	tsee->texture_cache->bytes += tiles->tile_bytes;
+	tsee->texture_cache->tile_uploads++;
+	return true;
+}
+
+/**
+ * @brief Draws part of a tiled image, uploading the tiles on screen and prefetching the ones around them.
+ *        Tiles are drawn edge to edge in screen space, so scaled images don't get gaps between tiles.
+ * 
+ * @param tsee TSEE object to draw to.
+ * @param asset Tiled asset.
+ * @param src Part of the image to draw, or NULL for all of it.
+ * @param dst Where to draw it on screen.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Tiles_Render(TSEE *tsee, TSEE_Texture_Asset *asset, const SDL_Rect *src, const SDL_Rect *dst) {
+	TSEE_Texture_Tiles *tiles = asset->tiles;
+	SDL_Rect whole = {0, 0, tiles->surface->w, tiles->surface->h};
+	if (!src) src = &whole;
+	SDL_Rect screen = {0, 0, tsee->window->width, tsee->window->height};
+	SDL_Rect visible;
+	if (src->w <= 0 || src->h <= 0 || !SDL_IntersectRect(dst, &screen, &visible)) {
+		return true;
+	}
+	// The visible part of the image, then grown by a tile to find what to prefetch.
+	SDL_Rect seen = {
+		src->x + (Sint64)(visible.x - dst->x) * src->w / dst->w,
+		src->y + (Sint64)(visible.y - dst->y) * src->h / dst->h,
+		0, 0,
+	};
+	seen.w = src->x + ((Sint64)(visible.x + visible.w - dst->x) * src->w + dst->w - 1) / dst->w - seen.x;
+	seen.h = src->y + ((Sint64)(visible.y + visible.h - dst->y) * src->h + dst->h - 1) / dst->h - seen.y;
+	SDL_Rect nearby = {seen.x - tiles->size, seen.y - tiles->size, seen.w + tiles->size * 2, seen.h + tiles->size * 2};
+	if (!SDL_IntersectRect(&nearby, src, &nearby)) {
+		return true;
+	}
+	int firstColumn = nearby.x / tiles->size;
+	int lastColumn = (nearby.x + nearby.w - 1) / tiles->size;
+	int firstRow = nearby.y / tiles->size;
+	int lastRow = (nearby.y + nearby.h - 1) / tiles->size;
+	bool success = true;
+	for (int row = firstRow; row <= lastRow; row++) {
+		for (int column = firstColumn; column <= lastColumn; column++) {
+			size_t index = (size_t)row * tiles->columns + column;
+			SDL_Rect rect = TSEE_Tiles_GetRect(tiles, index);
+			SDL_Rect part;
+			bool onScreen = SDL_HasIntersection(&rect, &seen) && SDL_IntersectRect(&rect, src, &part);
+			if (!tiles->tiles[index]) {
+				// Visible tiles always load, prefetching is spread over frames.
+				if (!onScreen && tsee->texture_cache->tile_uploads >= TSEE_TILES_PREFETCH_PER_FRAME) continue;
+				if (!TSEE_Tiles_Upload(tsee, asset, index)) {
+					success = false;
+					continue;
+				}
+			}
+			tiles->last_used[index] = tsee->texture_cache->frame;
+			if (!onScreen) continue;
+			SDL_Rect tileSrc = {part.x - rect.x, part.y - rect.y, part.w, part.h};
+			int left = dst->x + (Sint64)(part.x - src->x) * dst->w / src->w;
+			int top = dst->y + (Sint64)(part.y - src->y) * dst->h / src->h;
+			int right = dst->x + (Sint64)(part.x + part.w - src->x) * dst->w / src->w;
+			int bottom = dst->y + (Sint64)(part.y + part.h - src->y) * dst->h / src->h;
+			SDL_Rect tileDst = {left, top, right - left, bottom - top};
+			if (SDL_RenderCopy(tsee->window->renderer, tiles->tiles[index], &tileSrc, &tileDst) != 0) {
+				success = false;
+			}
+		}
+	}
+	TSEE_TextureCache_Touch(tsee, asset);
+	return success;
+}
+
+/**
+ * @brief Destroys a tiled asset's tiles which haven't been near the camera for a while.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Tiled asset.
+ * @param frames Frames a tile must go unused before it's destroyed, 0 to destroy every tile.
+ */
+void TSEE_Tiles_Release(TSEE *tsee, TSEE_Texture_Asset *asset, Uint32 frames) {
+	TSEE_Texture_Tiles *tiles = asset->tiles;
+	Uint64 frame = tsee->texture_cache->frame;
+	size_t count = (size_t)tiles->columns * tiles->rows;
+	for (size_t i = 0; i < count && tiles->resident > 0; i++) {
+		if (!tiles->tiles[i] || (frames > 0 && frame - tiles->last_used[i] < frames)) continue;
+		SDL_DestroyTexture(tiles->tiles[i]);
+		tiles->tiles[i] = NULL;
+		tiles->resident--;
+		asset->bytes -= tiles->tile_bytes;
+		tsee->texture_cache->bytes -= tiles->tile_bytes;
+	}
+}
+
+/**
+ * @brief Ends the frame for every tiled asset, destroying tiles that have left the camera.
+ *        Tiles are kept for a few frames so a camera moving back and forth doesn't re-upload them.
+ * 
+ * @param tsee TSEE object with the cache.
+ */
+void TSEE_Tiles_Update(TSEE *tsee) {
+	TSEE_Array *tiled = tsee->texture_cache->tiled;
+	for (size_t i = 0; i < tiled->size; i++) {
+		TSEE_Tiles_Release(tsee, tiled->data[i], TSEE_TILES_KEEP_FRAMES);
+	}
+	tsee->texture_cache->tile_uploads = 0;
+}
+
+/**
+ * @brief Destroys a tiled asset's tiles and the image kept for them.
+ * 
+ * @param tsee TSEE object with the cache.
+ * @param asset Tiled asset.
+ */
+void TSEE_Tiles_Destroy(TSEE *tsee, TSEE_Texture_Asset *asset) {
+	TSEE_Texture_Tiles *tiles = asset->tiles;
+	if (!tiles) return;
+	TSEE_Tiles_Release(tsee, asset, 0);
+	TSEE_Array *tiled = tsee->texture_cache->tiled;
+	for (size_t i = 0; i < tiled->size; i++) {
+		if (tiled->data[i] == asset) {
+			TSEE_Array_Delete(tiled, i);
+			break;
+		}
+	}
+	SDL_FreeSurface(tiles->surface);
+	xfree(tiles->tiles);
+	xfree(tiles->last_used);
+	xfree(tiles);
+	asset->tiles = NULL;
+}
\ No newline at end of file
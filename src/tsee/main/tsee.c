@@ -11,6 +11,8 @@ TSEE *TSEE_Create(int width, int height) {
 	TSEE_Log("Initialising TSEE Engine...\n");
 	TSEE *tsee = xmalloc(sizeof(*tsee));
 	tsee->fonts = NULL;
+	tsee->font_index = NULL;
+	tsee->font_files = NULL;
 
 	// Setup window + renderer
 	tsee->window = xmalloc(sizeof(*tsee->window));
@@ -19,13 +21,32 @@ TSEE *TSEE_Create(int width, int height) {
 	tsee->window->running = true;
 	tsee->window->fps = 60;
 	tsee->window->last_render = 0;
+	tsee->window->max_texture_width = 0;
+	tsee->window->max_texture_height = 0;
+	tsee->window->native_format = SDL_PIXELFORMAT_UNKNOWN;
+	tsee->window->convert_images = true;
+	tsee->window->premultiply_images = false;
 
 	// Setup world + textures
 	tsee->world = xmalloc(sizeof(*tsee->world));
 	tsee->world->objects = TSEE_Array_Create();
 	tsee->world->scroll_x = 0;
 	tsee->world->scroll_y = 0;
+	tsee->world->chunk_size = 0;
+	tsee->world->compress_maps = false;
+	tsee->world->stream = NULL;
+	tsee->world->colliders = NULL;
+	tsee->world->collider_count = 0;
+	tsee->world->colliders_valid = false;
 	tsee->textures = TSEE_Array_Create();
+	tsee->texture_cache = TSEE_TextureCache_Create();
+	tsee->last_texture_id = 0;
+	tsee->render_queue = TSEE_RenderQueue_Create();
+	tsee->loader = NULL;
+	tsee->map_load = NULL;
+	tsee->map_save = NULL;
+	tsee->paks = TSEE_Array_Create();
+	tsee->loose_override = true;
 
 	// Setup player
 	tsee->player = xmalloc(sizeof(*tsee->player));
@@ -57,12 +78,7 @@ TSEE *TSEE_Create(int width, int height) {
 
 	// Setup Debugging Counters
 	tsee->debug = xmalloc(sizeof(*tsee->debug));
-	tsee->debug->event_time = 0;
-	tsee->debug->physics_time = 0;
-	tsee->debug->render_time = 0;
-	tsee->debug->frame_time = 0;
-	tsee->debug->framerate = 0;
-	tsee->debug->active = false;
+	TSEE_Debug_Reset(tsee->debug);
 
 	// Load basic settings
 	TSEE_Settings_Load(tsee);
@@ -120,6 +136,9 @@ bool TSEE_InitAll(TSEE *tsee) {
  */
 bool TSEE_Close(TSEE *tsee) {
 	tsee->window->running = false;
+	TSEE_MapSave_Destroy(tsee);
+	TSEE_MapLoad_Destroy(tsee);
+	TSEE_MapStream_Destroy(tsee);
 	if (tsee->world->objects) {
 		if (tsee->world->objects->data) {
 			for (size_t i = 0; i < tsee->world->objects->size; i++) {
@@ -134,12 +153,19 @@ bool TSEE_Close(TSEE *tsee) {
 		TSEE_Texture_Destroy(tsee, tex);
 	}
 	TSEE_Array_Destroy(tsee->textures);
+	TSEE_TextureCache_Destroy(tsee);
+	TSEE_Loader_Destroy(tsee);
+	TSEE_RenderQueue_Destroy(tsee->render_queue);
 	TSEE_Font_UnloadAll(tsee);
+	TSEE_Pak_UnmountAll(tsee);
+	TSEE_Array_Destroy(tsee->paks);
 	
 	if (tsee->player)
 		xfree(tsee->player);
-	if (tsee->world)
+	if (tsee->world) {
+		TSEE_Physics_FreeColliders(tsee->world);
 		xfree(tsee->world);
+	}
 	
 	if (tsee->init->events) {
 		xfree(tsee->events->event);
@@ -257,9 +283,8 @@ void TSEE_World_ScrollToObject(TSEE *tsee, TSEE_Object *obj) {
 	for (size_t i = 0; i < tsee->world->objects->size; i++) {
 		TSEE_Object *object = TSEE_Array_Get(tsee->world->objects, i);
 		if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_UI) || TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PLAYER)) continue;
-		if (!TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX)) {
-			object->texture->rect.x = object->position.x - tsee->world->scroll_x;
-		}
+		if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX)) continue; // Positioned by TSEE_Parallax_Render
+		object->texture->rect.x = object->position.x - tsee->world->scroll_x;
 		object->texture->rect.y = object->position.y * -1 + tsee->window->height - tsee->world->scroll_y;
 	}
 }
\ No newline at end of file
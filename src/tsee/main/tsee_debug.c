@@ -0,0 +1,139 @@
+#include "../tsee.h"
+
+#define TSEE_DEBUG_GRAPH_HEIGHT 100
+#define TSEE_DEBUG_GRAPH_MS (1000.0f / 30) // Frame time at the top of the graph
+
+/**
+ * @brief Resets the debug counters, frame history and overlay text.
+ * 
+ * @param debug Debug object to reset.
+ */
+void TSEE_Debug_Reset(TSEE_Debug *debug) {
+	memset(debug, 0, sizeof(*debug));
+	for (int i = 0; i < TSEE_DEBUG_LINES; i++) {
+		debug->lines[i].value = LLONG_MIN;
+	}
+}
+
+/**
+ * @brief Stores the current frame's timings in the frame history.
+ * 
+ * @param tsee TSEE object to record the frame for.
+ */
+void TSEE_Debug_RecordFrame(TSEE *tsee) {
+	TSEE_Debug *debug = tsee->debug;
+	debug->history[debug->history_next] = (TSEE_Debug_Frame){debug->event_time, debug->physics_time, debug->render_time};
+	debug->history_next = (debug->history_next + 1) % TSEE_DEBUG_HISTORY;
+}
+
+/**
+ * @brief Updates a line of the overlay, only formatting it if the value has changed at display precision.
+ * 
+ * @param tsee TSEE object the overlay is in.
+ * @param line Index of the line to update.
+ * @param format Format string with a single %.3f for the value.
+ * @param value Value to display.
+ */
+void TSEE_Debug_SetLine(TSEE *tsee, int line, const char *format, double value) {
+	TSEE_Debug_Line *debugLine = &tsee->debug->lines[line];
+	long long rounded = llround(value * 1000);
+	if (rounded == debugLine->value) {
+		return;
+	}
+	debugLine->value = rounded;
+	snprintf(debugLine->text, sizeof(debugLine->text), format, rounded / 1000.0);
+	TSEE_Text_Measure(tsee, "_default", debugLine->text, &debugLine->width, NULL);
+}
+
+/**
+ * @brief Draws the frame-time graph, event, physics and render time stacked for each frame.
+ * 
+ * @param tsee TSEE object to draw the graph for.
+ * @param x X position of the graph.
+ * @param y Y position of the top of the graph.
+ */
+void TSEE_Debug_RenderGraph(TSEE *tsee, int x, int y) {
+	TSEE_Debug *debug = tsee->debug;
+	const SDL_Color colours[3] = {{255, 200, 50, 255}, {50, 200, 255, 255}, {100, 255, 100, 255}};
+	float scale = TSEE_DEBUG_GRAPH_HEIGHT / TSEE_DEBUG_GRAPH_MS;
+	int bottom = y + TSEE_DEBUG_GRAPH_HEIGHT;
+
+	SDL_SetRenderDrawColor(tsee->window->renderer, 0, 0, 0, 150);
+	SDL_RenderFillRect(tsee->window->renderer, &(SDL_Rect){x, y, TSEE_DEBUG_HISTORY, TSEE_DEBUG_GRAPH_HEIGHT});
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	int count = 0;
+#endif
+	for (int i = 0; i < TSEE_DEBUG_HISTORY; i++) {
+		TSEE_Debug_Frame *frame = &debug->history[(debug->history_next + i) % TSEE_DEBUG_HISTORY];
+		float times[3] = {frame->event_time, frame->physics_time, frame->render_time};
+		float top = bottom;
+		for (int part = 0; part < 3; part++) {
+			float height = times[part] * scale;
+			if (top - height < y) {
+				height = top - y;
+			}
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+			float x0 = x + i, x1 = x + i + 1, y0 = top - height, y1 = top;
+			SDL_Vertex *v = &debug->graph[count];
+			v[0] = (SDL_Vertex){{x0, y0}, colours[part], {0, 0}};
+			v[1] = (SDL_Vertex){{x1, y0}, colours[part], {0, 0}};
+			v[2] = (SDL_Vertex){{x0, y1}, colours[part], {0, 0}};
+			v[3] = (SDL_Vertex){{x1, y0}, colours[part], {0, 0}};
+			v[4] = (SDL_Vertex){{x1, y1}, colours[part], {0, 0}};
+			v[5] = (SDL_Vertex){{x0, y1}, colours[part], {0, 0}};
+			count += 6;
+#else
+			debug->graph[part][i] = (SDL_Rect){x + i, top - height, 1, height};
+#endif
+			top -= height;
+		}
+	}
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	SDL_RenderGeometry(tsee->window->renderer, NULL, debug->graph, count, NULL, 0);
+#else
+	for (int part = 0; part < 3; part++) {
+		SDL_SetRenderDrawColor(tsee->window->renderer, colours[part].r, colours[part].g, colours[part].b, colours[part].a);
+		SDL_RenderFillRects(tsee->window->renderer, debug->graph[part], TSEE_DEBUG_HISTORY);
+	}
+#endif
+
+	// Mark the 60 FPS frame budget
+	int budget = bottom - (1000.0f / 60) * scale;
+	SDL_SetRenderDrawColor(tsee->window->renderer, 255, 80, 80, 255);
+	SDL_RenderDrawLine(tsee->window->renderer, x, budget, x + TSEE_DEBUG_HISTORY, budget);
+}
+
+/**
+ * @brief Renders the F3 debug overlay. Text comes from the default font's glyph atlas,
+ *        so nothing is allocated while the overlay is open.
+ * 
+ * @param tsee TSEE object to render the overlay for.
+ */
+void TSEE_Debug_Render(TSEE *tsee) {
+	TSEE_Debug *debug = tsee->debug;
+	TSEE_Debug_SetLine(tsee, 0, "Event: %.3f ms", debug->event_time);
+	TSEE_Debug_SetLine(tsee, 1, "Physics: %.3f ms", debug->physics_time);
+	TSEE_Debug_SetLine(tsee, 2, "Render: %.3f ms", debug->render_time);
+	TSEE_Debug_SetLine(tsee, 3, "Object Render: %.3f ms", debug->render_times.object_time);
+	TSEE_Debug_SetLine(tsee, 4, "Parallax Render: %.3f ms", debug->render_times.parallax_time);
+	TSEE_Debug_SetLine(tsee, 5, "Frame: %.3f ms", debug->frame_time);
+	TSEE_Debug_SetLine(tsee, 6, "Framerate: %.3f", debug->frame_time > 0 ? 1000 / debug->frame_time : 0);
+	TSEE_Debug_SetLine(tsee, 7, "Texture Memory: %.3f MB", tsee->texture_cache->bytes / (1024.0 * 1024.0));
+	TSEE_Debug_SetLine(tsee, 8, "Texture Dedup Saved: %.3f MB", tsee->texture_cache->saved / (1024.0 * 1024.0));
+	TSEE_Debug_SetLine(tsee, 9, "Texture Upload: %.3f ms", debug->render_times.upload_time);
+
+	int line_height = 0;
+	TSEE_Text_Measure(tsee, "_default", "", NULL, &line_height);
+	SDL_Rect backgrounds[TSEE_DEBUG_LINES];
+	for (int i = 0; i < TSEE_DEBUG_LINES; i++) {
+		backgrounds[i] = (SDL_Rect){0, i * line_height, debug->lines[i].width, line_height};
+	}
+	SDL_SetRenderDrawColor(tsee->window->renderer, 100, 100, 100, 255);
+	SDL_RenderFillRects(tsee->window->renderer, backgrounds, TSEE_DEBUG_LINES);
+	for (int i = 0; i < TSEE_DEBUG_LINES; i++) {
+		TSEE_Text_Draw(tsee, "_default", debug->lines[i].text, 0, i * line_height, (SDL_Color){255, 255, 255, SDL_ALPHA_OPAQUE});
+	}
+
+	TSEE_Debug_RenderGraph(tsee, 0, TSEE_DEBUG_LINES * line_height + 4);
+}
@@ -57,6 +57,14 @@ bool TSEE_CalculateDT(TSEE *tsee);
 bool TSEE_World_SetGravity(TSEE *tsee, TSEE_Vec2 gravity);
 void TSEE_World_ScrollToObject(TSEE *tsee, TSEE_Object *obj);
 
+// Debug
+
+void TSEE_Debug_Reset(TSEE_Debug *debug);
+void TSEE_Debug_RecordFrame(TSEE *tsee);
+void TSEE_Debug_SetLine(TSEE *tsee, int line, const char *format, double value);
+void TSEE_Debug_RenderGraph(TSEE *tsee, int x, int y);
+void TSEE_Debug_Render(TSEE *tsee);
+
 // Settings
 
 void TSEE_Settings_LoadCallback(TSEE *tsee, char *section, char *value);
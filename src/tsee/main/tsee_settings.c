@@ -40,19 +40,20 @@ void TSEE_Settings_LoadCallback(TSEE *tsee, char *section, char *value) {
  * @return true on success, false on fail.
  */
 bool TSEE_Settings_Load(TSEE *tsee) {
-	FILE *fp = fopen("TSEE-Settings.ini", "r");
-	if (!fp) {
+	TSEE_Stream stream;
+	if (!TSEE_Stream_OpenFile(&stream, "TSEE-Settings.ini", false)) {
 		TSEE_Warn("Couldn't open settings file `TSEE-Settings.ini`\nCreating basic settings file...\n");
 		TSEE_Settings_Save(tsee);
 		return false;
 	}
 	char buf[512];
-	while (fgets(buf, 512, fp)) {
+	while (TSEE_Stream_ReadLine(&stream, buf, 512)) {
 		char *sec, *val;
 		sec = strtok(buf, "=");
 		val = strtok(NULL, "=");
 		TSEE_Settings_LoadCallback(tsee, sec, val);
 	}
+	TSEE_Stream_Close(&stream);
 	return true;
 }
 
@@ -7,6 +7,12 @@ typedef struct TSEE_World {
 	float scroll_x;
 	float scroll_y;
 	float max_scroll_x;
+	float chunk_size; // Maps are saved in chunks this wide and tall, 0 to save them whole
+	bool compress_maps; // Maps are saved compressed with zlib
+	TSEE_MapStream *stream; // Streams the loaded map's chunks, NULL if it was loaded whole
+	TSEE_Collider *colliders; // Static objects merged into as few rectangles as possible, see TSEE_Physics_BuildColliders
+	size_t collider_count;
+	bool colliders_valid; // Cleared when static objects are added, moved or removed, they're rebuilt on the next physics step
 } TSEE_World;
 
 // TSEE's system of keeping track of what's initialized.
@@ -21,8 +27,26 @@ typedef struct TSEE_Init {
 typedef struct TSEE_Debug_RenderTimes {
 	double object_time;
 	double parallax_time;
+	double upload_time;
 } TSEE_Debug_RenderTimes;
 
+#define TSEE_DEBUG_HISTORY 240
+#define TSEE_DEBUG_LINES 10
+
+// One frame's timings, kept for the frame-time graph.
+typedef struct TSEE_Debug_Frame {
+	float event_time;
+	float physics_time;
+	float render_time;
+} TSEE_Debug_Frame;
+
+// A line of the debug overlay, only reformatted when its value changes at display precision.
+typedef struct TSEE_Debug_Line {
+	long long value; // Thousandths of the displayed value
+	int width;
+	char text[64];
+} TSEE_Debug_Line;
+
 typedef struct TSEE_Debug {
 	double event_time;
 	double physics_time;
@@ -31,19 +55,37 @@ typedef struct TSEE_Debug {
 	double frame_time;
 	double framerate;
 	bool active;
+	TSEE_Debug_Frame history[TSEE_DEBUG_HISTORY]; // Ring buffer, oldest at history_next
+	size_t history_next;
+	TSEE_Debug_Line lines[TSEE_DEBUG_LINES];
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	SDL_Vertex graph[TSEE_DEBUG_HISTORY * 3 * 6];
+#else
+	SDL_Rect graph[3][TSEE_DEBUG_HISTORY];
+#endif
 } TSEE_Debug;
 
 // The main TSEE object, create using TSEE_Create(width, height).
 typedef struct TSEE {
 	TSEE_Window *window;
 	TSEE_Array *textures;
+	TSEE_TextureCache *texture_cache;
 	TSEE_Array *fonts;
+	TSEE_HashMap *font_index; // Font name -> TSEE_Font
+	TSEE_HashMap *font_files; // Font path -> TSEE_FontFile
 	TSEE_World *world;
 	TSEE_Events *events;
 	TSEE_Player *player;
 	TSEE_Init *init;
 	TSEE_UI *ui;
 	TSEE_Debug *debug;
+	TSEE_RenderQueue *render_queue;
+	TSEE_Loader *loader; // Created by the first TSEE_Texture_CreateAsync
+	TSEE_MapLoad *map_load; // Map being loaded by TSEE_Map_LoadAsync, or the old world being torn down
+	TSEE_MapSave *map_save; // Map being written by TSEE_Map_SaveAsync
+	TSEE_Array *paks; // Mounted TSEE_Pak archives, searched newest first
+	bool loose_override; // Loose files are used before archives
+	Uint32 last_texture_id;
 	Uint64 last_time;
 	Uint64 current_time;
 	float dt;
@@ -1,131 +1,155 @@
 #include "../tsee.h"
 
 /**
- * @brief Reads from a file pointer until a null character is hit.
+ * @brief Destroys the current world's objects and textures and resets the player, ready for a map to be loaded.
  * 
- * @param fp File pointer to read from.
- * @return char* 
+ * @param tsee TSEE object to clear.
  */
-char *TSEE_ReadFile_UntilNull(FILE *fp) {
-	char c;
-	int len = 0;
-	char *buffer = NULL;
-	while ((c = getc(fp)) != 0 && c != EOF) {
-		char *newPtr = xrealloc(buffer, sizeof(*buffer) * (++len));
-		if (!newPtr) {
-			TSEE_Critical("Failed realloc for text buffer.\n");
-			return NULL;
+void TSEE_Map_Clear(TSEE *tsee) {
+	TSEE_MapLoad_Destroy(tsee);
+	TSEE_MapStream_Destroy(tsee);
+	// Clear arrays to be overwritten
+	if (tsee->world->objects) {
+		if (tsee->world->objects->data) {
+			for (size_t i = 0; i < tsee->world->objects->size; i++) {
+				TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
+				TSEE_Object_Destroy(tsee, obj, false);
+			}
 		}
-		buffer = newPtr;
-		buffer[len - 1] = c;
+		TSEE_Array_Clear(tsee->world->objects);
+	}
+	TSEE_Physics_FreeColliders(tsee->world);
+	// Newest first, so each texture is found at the end of the arrays it's in.
+	while (tsee->textures->size > 0) {
+		TSEE_Texture *tex = TSEE_Array_Get(tsee->textures, tsee->textures->size - 1);
+		TSEE_Texture_Destroy(tsee, tex);
 	}
-	buffer[len] = '\0';
-	return buffer;
+
+	// Reset the player
+	tsee->player->grounded = true;
+	tsee->player->jump_force = 0;
+	tsee->player->movement.down = false;
+	tsee->player->movement.up = false;
+	tsee->player->movement.left = false;
+	tsee->player->movement.right = false;
+	tsee->player->object = NULL;
+	tsee->player->speed = 0;
 }
 
 /**
- * @brief Writes a null-terminated string to a file.
+ * @brief Finds the player object in the world after a map is loaded.
  * 
- * @param fp File to write to
- * @param string String to write
+ * @param tsee TSEE object with the world.
+ * @return true on success, false if there's no player object.
  */
-void TSEE_WriteFile_String(FILE *fp, char *string) {
-	TSEE_WriteFile(string, sizeof(*string) * strlen(string), 1, fp);
-	putc(0, fp);
+bool TSEE_Map_FindPlayer(TSEE *tsee) {
+	for (size_t i = 0; i < tsee->world->objects->size; i++) {
+		TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
+		if (TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PLAYER)) {
+			tsee->player->object = obj;
+			return true;
+		}
+	}
+	TSEE_Warn("Failed to find player object.\n");
+	return false;
 }
 
 /**
- * @brief Reads from a file
+ * @brief Opens a map file to read. Compressed maps are recognised by their header,
+ *        and decompressed a buffer at a time as they're read rather than all at once.
  * 
- * @param dst Destination buffer
- * @param size Size to read
- * @param n Number of items to read
- * @param fp File to read from
- * @return true on success, false on failure
+ * @param tsee TSEE object with the archives the map may be in.
+ * @param map Map file to open, it mustn't be moved while it's open.
+ * @param path Path of the map.
+ * @return true on success, false on fail.
  */
-bool TSEE_ReadFile(void *dst, size_t size, size_t n, FILE *fp) {
-	if (fread(dst, size, n, fp) != n) {
-		TSEE_Error("Failed to read from file (or reached unexpected EOF)\n");
+bool TSEE_Map_Open(TSEE *tsee, TSEE_Map_File *map, const char *path) {
+	map->stream = &map->file;
+	map->compressed = false;
+	if (!TSEE_Stream_OpenMapped(tsee, &map->file, path)) {
+		TSEE_Error("Failed to open map file (%s)\n", path);
+		return false;
+	}
+	const void *magic = TSEE_Stream_Peek(&map->file, sizeof(TSEE_MAP_ZLIB_MAGIC) - 1);
+	if (!magic || memcmp(magic, TSEE_MAP_ZLIB_MAGIC, sizeof(TSEE_MAP_ZLIB_MAGIC) - 1) != 0) {
+		return true;
+	}
+	TSEE_Stream_Skip(&map->file, sizeof(TSEE_MAP_ZLIB_MAGIC) - 1);
+	if (!TSEE_Stream_OpenZlib(&map->zlib, &map->file, false)) {
+		TSEE_Error("Failed to decompress map file (%s)\n", path);
+		TSEE_Stream_Close(&map->file);
 		return false;
 	}
+	map->stream = &map->zlib;
+	map->compressed = true;
 	return true;
 }
 
 /**
- * @brief Writes to a file
+ * @brief Closes a map file opened with TSEE_Map_Open.
  * 
- * @param src Source buffer
- * @param size Size to write
- * @param n Number to items to write
- * @param fp File to write to
- * @return true on success, false on failure
+ * @param map Map file to close.
  */
-bool TSEE_WriteFile(void *src, size_t size, size_t n, FILE *fp) {
-	if (fwrite(src, size, n, fp) != n) {
-		TSEE_Error("Failed to write to file\n");
-		return false;
+void TSEE_Map_Close(TSEE_Map_File *map) {
+	if (map->compressed) {
+		TSEE_Stream_Close(&map->zlib);
 	}
-	return true;
+	TSEE_Stream_Close(&map->file);
 }
 
 /**
- * @brief Loads a TSEE map from a file
+ * @brief Loads a TSEE map from a file, v2 maps are loaded in bulk.
+ *        Older maps are read with TSEE_Map_LoadV1. Compressed chunked maps are loaded whole,
+ *        as their chunks can't be read in place.
  * 
  * @param tsee TSEE object to load the map into.
  * @param fn File name to load from.
  * @return true on success, false on fail.
  */
 bool TSEE_Map_Load(TSEE *tsee, char *fn) {
-	// Open the file
-	FILE *fp = fopen(fn, "rb");
-	if (fp == NULL) {
-		TSEE_Error("Failed to open map file (%s)\n", fn);
+	TSEE_Map_File map;
+	if (!TSEE_Map_Open(tsee, &map, fn)) {
 		return false;
 	}
-
-	// Clear arrays to be overwritten
-	if (tsee->world->objects) {
-		if (tsee->world->objects->data) {
-			for (size_t i = 0; i < tsee->world->objects->size; i++) {
-				TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
-				TSEE_Object_Destroy(tsee, obj, false);
-			}
-		}
+	bool success;
+	if (TSEE_Map_IsV2(map.stream)) {
+		success = TSEE_Map_LoadV2(tsee, map.stream, map.compressed ? NULL : fn);
+	} else {
+		TSEE_Map_Clear(tsee);
+		success = TSEE_Map_LoadV1(tsee, map.stream);
 	}
-	while (tsee->textures->size > 0) {
-		TSEE_Texture *tex = TSEE_Array_Get(tsee->textures, 0);
-		TSEE_Texture_Destroy(tsee, tex);
-	}
-
-	// Reset the player
-	tsee->player->grounded = true;
-	tsee->player->jump_force = 0;
-	tsee->player->movement.down = false;
-	tsee->player->movement.up = false;
-	tsee->player->movement.left = false;
-	tsee->player->movement.right = false;
-	tsee->player->object = NULL;
-	tsee->player->speed = 0;
+	TSEE_Map_Close(&map);
+	return success;
+}
 
+/**
+ * @brief Loads a map saved before maps were versioned, field by field.
+ *        Objects are added to the current world, clear it first with TSEE_Map_Clear.
+ * 
+ * @param tsee TSEE object to load the map into.
+ * @param stream Stream to read the map from.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_LoadV1(TSEE *tsee, TSEE_Stream *stream) {
 	// Read all of the map header data
 	char *mapName = NULL;
-	if (!(mapName = TSEE_ReadFile_UntilNull(fp))) return false;
+	if (!(mapName = TSEE_Stream_ReadCString(stream))) return false;
 	char *mapAuthor = NULL;
-	if (!(mapAuthor = TSEE_ReadFile_UntilNull(fp))) return false;
+	if (!(mapAuthor = TSEE_Stream_ReadCString(stream))) return false;
 	char *mapVersion = NULL;
-	if (!(mapVersion = TSEE_ReadFile_UntilNull(fp))) return false;
+	if (!(mapVersion = TSEE_Stream_ReadCString(stream))) return false;
 	char *mapDescription = NULL;
-	if (!(mapDescription = TSEE_ReadFile_UntilNull(fp))) return false;
+	if (!(mapDescription = TSEE_Stream_ReadCString(stream))) return false;
 	TSEE_Log("Loading into %s by %s\nVersion: %s\n%s\n", mapName, mapAuthor, mapVersion, mapDescription);
 
 	// Read the gravity (for some reason its here in the header?)
 	float gravityX = 0;
-	if (TSEE_ReadFile(&gravityX, sizeof(gravityX), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &gravityX, sizeof(gravityX))) {
 		TSEE_Error("Failed to read gravity X.\n");
 		return false;
 	}
 	float gravityY = 0;
-	if (TSEE_ReadFile(&gravityY, sizeof(gravityY), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &gravityY, sizeof(gravityY))) {
 		TSEE_Error("Failed to read gravity Y.\n");
 		return false;
 	}
@@ -133,7 +157,7 @@ bool TSEE_Map_Load(TSEE *tsee, char *fn) {
 
 	// Read map's textures
 	size_t numTextures = 0;
-	if (TSEE_ReadFile(&numTextures, sizeof(numTextures), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &numTextures, sizeof(numTextures))) {
 		TSEE_Error("Failed to read number of textures.\n");
 		return false;
 	}
@@ -143,187 +167,148 @@ bool TSEE_Map_Load(TSEE *tsee, char *fn) {
 	char *texturePath = NULL;
 	for (size_t i = 0; i < numTextures; i++) {
 		texturePath = NULL;
-		if (!(texturePath = TSEE_ReadFile_UntilNull(fp))) return false;
+		if (!(texturePath = TSEE_Stream_ReadCString(stream))) return false;
 		texturePaths = xrealloc(texturePaths, sizeof(*texturePaths) * (++numTexPaths));
 		texturePaths[numTexPaths - 1] = strdup(texturePath);
 		free(texturePath);
 	}
+	// Read and decode every texture at once, rather than one by one as objects use them.
+	TSEE_Loader_Preload(tsee, texturePaths, numTexPaths, true);
 
 	// Read objects
 	size_t numObjects = 0;
-	if (TSEE_ReadFile(&numObjects, sizeof(numObjects), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &numObjects, sizeof(numObjects))) {
 		TSEE_Error("Failed to read number of objects.\n");
 		return false;
 	}
 	TSEE_Log("Loading %zu objects\n", numObjects);
 	for (size_t i = 0; i < numObjects; i++) {
 		size_t texIdx = 0;
-		if (TSEE_ReadFile(&texIdx, sizeof(texIdx), 1, fp) != 1) {
+		if (!TSEE_Stream_Read(stream, &texIdx, sizeof(texIdx))) {
 			TSEE_Error("Failed to read texture index.\n");
 			return false;
 		}
 		TSEE_Log("Read object %ld with texture %ld\n", i, texIdx);
-		char *path = texturePaths[texIdx];
 		float x = 0;
 		float y = 0;
 		TSEE_Object_Attributes attr;
 
-		if (TSEE_ReadFile(&x, sizeof(x), 1, fp) != 1 || TSEE_ReadFile(&y, sizeof(y), 1, fp) != 1) {
+		if (!TSEE_Stream_Read(stream, &x, sizeof(x)) || !TSEE_Stream_Read(stream, &y, sizeof(y))) {
 			TSEE_Error("Failed to read object position\n");
 			return false;
 		}
 
-		if (TSEE_ReadFile(&attr, sizeof(attr), 1, fp) != 1) {
+		if (!TSEE_Stream_Read(stream, &attr, sizeof(attr))) {
 			TSEE_Error("Failed to read object attributes\n");
 			return false;
 		}
 
-		TSEE_Object *object;
+		// These maps only saved the first component an object had, in the order of the component table, see TSEE_Component_GetAll.
+		size_t componentCount;
+		const TSEE_Component *components = TSEE_Component_GetAll(&componentCount);
+		const TSEE_Component *component = NULL;
+		for (size_t c = 0; !component && c < componentCount; c++) {
+			if (TSEE_Attributes_Check(attr, components[c].attribute)) {
+				component = &components[c];
+			}
+		}
+		// Its fields are read before the object is created, so an object that can't be created can be skipped.
+		TSEE_Object fields;
+		memset(&fields, 0, sizeof(fields));
+		fields.attributes = attr;
+		for (size_t f = 0; component && f < component->field_count; f++) {
+			const TSEE_Field *field = &component->fields[f];
+			if (field->type == TSEE_FIELD_STRING) {
+				char *string = TSEE_Stream_ReadCString(stream);
+				TSEE_Field_SetString(&fields, field, string);
+				if (string) {
+					xfree(string);
+				}
+				continue;
+			}
+			float value = field->fallback;
+			TSEE_Stream_Read(stream, &value, sizeof(value));
+			TSEE_Field_SetFloat(&fields, field, value);
+		}
 
-		if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PARALLAX)) {
-			object = TSEE_Parallax_Create(tsee, TSEE_Texture_Create(tsee, path), 1000);
-		} else {
-			object = TSEE_Object_Create(tsee, TSEE_Texture_Create(tsee, path), attr, x, y);
+		TSEE_Texture *texture = texIdx < numTexPaths ? TSEE_Texture_Create(tsee, texturePaths[texIdx]) : NULL;
+		TSEE_Object *object = NULL;
+		if (texture && TSEE_Attributes_Check(attr, TSEE_ATTRIB_PARALLAX)) {
+			object = TSEE_Parallax_Create(tsee, texture, 1000);
+		} else if (texture) {
+			object = TSEE_Object_Create(tsee, texture, attr, x, y);
 		}
 
-		if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PHYS)) {
-			TSEE_ReadFile(&object->physics.mass, sizeof(object->physics.mass), 1, fp);
-			TSEE_ReadFile(&object->physics.restitution, sizeof(object->physics.restitution), 1, fp);
-		} else if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PARALLAX)) {
-			TSEE_ReadFile(&object->parallax.distance, sizeof(object->parallax.distance), 1, fp);
-		} else if(TSEE_Attributes_Check(attr, TSEE_ATTRIB_TEXT)) {
-			object->text.text = TSEE_ReadFile_UntilNull(fp);
+		if (!object) {
+			TSEE_Warn("Skipping object %ld, it's invalid or its texture couldn't be loaded.\n", i);
+			if (texture) {
+				TSEE_Texture_Destroy(tsee, texture);
+			}
+			TSEE_Field_FreeStrings(&fields);
+			continue;
 		}
+
+		for (size_t f = 0; component && TSEE_Object_CheckAttribute(object, component->attribute) && f < component->field_count; f++) {
+			const TSEE_Field *field = &component->fields[f];
+			if (field->type == TSEE_FIELD_STRING) {
+				TSEE_Field_SetString(object, field, TSEE_Field_GetString(&fields, field));
+			} else {
+				TSEE_Field_SetFloat(object, field, TSEE_Field_GetFloat(&fields, field));
+			}
+		}
+		TSEE_Field_FreeStrings(&fields);
 		
 		TSEE_Log("Loaded object `%s` at (%f, %f, %d, %d) with texture at (%d, %d)\n", object->texture->path, object->position.x, object->position.y, object->texture->rect.w, object->texture->rect.h, object->texture->rect.x, object->texture->rect.y);
 	}
 
 	// Setup the player
-	bool player_found = false;
-	for (size_t i = 0; i < tsee->world->objects->size; i++) {
-		TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
-		if (TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PLAYER)) {
-			tsee->player->object = obj;
-			player_found = true;
-			break;
-		}
-	}
-	if (!player_found) {
-		TSEE_Warn("Failed to find player object.\n");
-	}
+	TSEE_Map_FindPlayer(tsee);
 
 	float speed = 0;
-	if (TSEE_ReadFile(&speed, sizeof(speed), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &speed, sizeof(speed))) {
 		TSEE_Error("Failed to read player speed.\n");
 		return false;
 	}
 	TSEE_Player_SetSpeed(tsee, speed);
 	float jumpForce = 0;
-	if (TSEE_ReadFile(&jumpForce, sizeof(jumpForce), 1, fp) != 1) {
+	if (!TSEE_Stream_Read(stream, &jumpForce, sizeof(jumpForce))) {
 		TSEE_Error("Failed to read player jump force.\n");
 		return false;
 	}
 	TSEE_Player_SetJumpForce(tsee, jumpForce);
 
-	fclose(fp);
 	TSEE_Log("Map %s loaded successfully.\n", mapName);
 	return true;
 }
 
 /**
- * @brief Saves the current TSEE to a map file
+ * @brief Saves the current TSEE to a map file, in the v2 format. The file is replaced in one step once it's written.
+ *        TSEE_Map_SaveAsync does the writing on a background thread instead. A background save to the same file is finished first,
+ *        so it can't replace this one with an older snapshot.
  * 
  * @param tsee TSEE object to save.
  * @param fn File name to save to.
  * @return true on success, false on fail.
  */
 bool TSEE_Map_Save(TSEE *tsee, char *fn) {
-	FILE *fp = fopen(fn, "wb");
-	if (fp == NULL) {
-		TSEE_Error("Failed to open map file (%s)\n", fn);
+	if (tsee->world->stream) {
+		TSEE_Error("Can't save a streamed map, only its loaded chunks are in the world.\n");
 		return false;
 	}
-	// Write the map header
-	char *mapName = "Test Map";
-	char *mapAuthor = "Test Author";
-	char *mapVersion = "1.0";
-	char *mapDescription = "Test Description";
-	TSEE_WriteFile_String(fp, mapName);
-	TSEE_WriteFile_String(fp, mapAuthor);
-	TSEE_WriteFile_String(fp, mapVersion);
-	TSEE_WriteFile_String(fp, mapDescription);
-	// Write the gravity
-	float gravityX = tsee->world->gravity.x;
-	TSEE_WriteFile(&gravityX, sizeof(gravityX), 1, fp);
-	float gravityY = tsee->world->gravity.y;
-	TSEE_WriteFile(&gravityY, sizeof(gravityY), 1, fp);
-	// Write the number of textures
-
-	// As not all textures are loaded from files, we must figure out how many unique ones there are.
-	size_t numTextures = 0;
-	char **texturesSeen = NULL;
-	for (size_t i = 0; i < tsee->textures->size; i++) {
-		TSEE_Texture *texture = TSEE_Array_Get(tsee->textures, i);
-		if (!texture->path) continue;
-		if (!texturesSeen) {
-			texturesSeen = xmalloc(sizeof(*texturesSeen) * ++numTextures);
-			texturesSeen[0] = strdup(texture->path);
-		}
-		bool found = false;
-		for (size_t j = 0; j < numTextures; j++) {
-			if (strcmp(texturesSeen[j], texture->path) == 0) {
-				found = true;
-				break;
-			}
-		}
-		if (found) continue;
-		texturesSeen = xrealloc(texturesSeen, sizeof(*texturesSeen) * (++numTextures));
-		texturesSeen[numTextures - 1] = strdup(texture->path);
+	if (tsee->map_save && strcmp(tsee->map_save->path, fn) == 0) {
+		TSEE_Log("Waiting for the background save to %s to finish.\n", fn);
+		TSEE_MapSave_Wait(tsee);
 	}
-	TSEE_Log("Found %ld unique textures.\n", numTextures);
-	TSEE_WriteFile(&numTextures, sizeof(numTextures), 1, fp);
-
-	// Then we write the paths for the textures.
-	for (size_t i = 0; i < numTextures; i++) {
-		TSEE_WriteFile_String(fp, texturesSeen[i]);
+	TSEE_Map_Snapshot *snapshot = TSEE_Map_TakeSnapshot(tsee);
+	if (!snapshot) {
+		return false;
 	}
-
-	// Write the objects with texture indexes.
-	TSEE_Log("Writing %ld objects.\n", tsee->world->objects->size);
-	TSEE_WriteFile(&tsee->world->objects->size, sizeof(tsee->world->objects->size), 1, fp);
-	for (size_t i = 0; i < tsee->world->objects->size; i++) {
-		bool written = false;
-		TSEE_Object *object = TSEE_Array_Get(tsee->world->objects, i);
-		for (size_t j = 0; j < numTextures; j++) {
-			if (strcmp(object->texture->path, texturesSeen[j]) == 0) {
-				TSEE_Log("Written object %ld with texture %ld.\n", i, j);
-				TSEE_WriteFile(&j, sizeof(j), 1, fp);
-				written = true;
-				break;
-			}
-		}
-		if (!written) {
-			TSEE_Error("Couldn't write texture idx for texture!!\n");
-			return false;
-		}
-		TSEE_WriteFile(&object->position.x, sizeof(object->position.x), 1, fp);
-		TSEE_WriteFile(&object->position.y, sizeof(object->position.y), 1, fp);
-		TSEE_WriteFile(&object->attributes, sizeof(object->attributes), 1, fp);
-		// Write individual fields for each attribute
-		if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PHYS)) {
-			TSEE_WriteFile(&object->physics.mass, sizeof(object->physics.mass), 1, fp);
-			TSEE_WriteFile(&object->physics.restitution, sizeof(object->physics.restitution), 1, fp);
-		} else if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX)) {
-			TSEE_WriteFile(&object->parallax.distance, sizeof(object->parallax.distance), 1, fp);
-		} else if(TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_TEXT)) {
-			TSEE_WriteFile_String(fp, object->text.text);
-		}
+	bool success = TSEE_Map_WriteFile(snapshot, fn);
+	TSEE_Map_FreeSnapshot(snapshot);
+	if (!success) {
+		TSEE_Error("Failed to save map to %s\n", fn);
+		return false;
 	}
-
-	// Write player information
-	TSEE_WriteFile(&tsee->player->speed, sizeof(tsee->player->speed), 1, fp);
-	TSEE_WriteFile(&tsee->player->jump_force, sizeof(tsee->player->jump_force), 1, fp);
-	fclose(fp);
 	TSEE_Log("Saved map to %s\n", fn);
 	return true;
 }
\ No newline at end of file
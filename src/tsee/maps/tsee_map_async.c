@@ -0,0 +1,613 @@
+#include "../tsee.h"
+
+#define TSEE_MAPLOAD_DEFAULT_BUDGET 4.0
+#define TSEE_MAPLOAD_READ_BATCH 4096
+#define TSEE_MAPLOAD_BUILD_BATCH 256
+#define TSEE_MAPLOAD_TEARDOWN_BATCH 16384
+
+/**
+ * @brief Loads a map in the background, the current world keeps running until the new one is ready.
+ *        The map is read on a thread, its textures are decoded on the loader's threads, then its objects are created
+ *        into a staged world a batch a frame. Once every object exists the staged world replaces the current one between frames,
+ *        and the old world's objects are destroyed a batch a frame after that. Maps saved before v2 are staged all at once, on the render thread.
+ *
+ * @param tsee TSEE object to load the map into.
+ * @param path Path of the map.
+ * @param callback Called once the load finishes, or NULL. Not called if the load is cancelled by TSEE_Map_Clear or TSEE_Close.
+ * @param userdata Passed to the callback.
+ * @return true if the load started, false if a map is already loading or it couldn't start.
+ */
+bool TSEE_Map_LoadAsync(TSEE *tsee, char *path, TSEE_Map_LoadCallback callback, void *userdata) {
+	if (tsee->map_load && tsee->map_load->state != TSEE_MAPLOAD_TEARDOWN) {
+		TSEE_Warn("Already loading a map, not loading `%s`.\n", path);
+		return false;
+	}
+	// Only one old world is torn down at a time, so finish the last one now.
+	TSEE_MapLoad_Destroy(tsee);
+	TSEE_MapLoad *load = xmalloc(sizeof(*load));
+	if (!load) {
+		return false;
+	}
+	memset(load, 0, sizeof(*load));
+	load->tsee = tsee;
+	load->path = strdup(path);
+	load->state = TSEE_MAPLOAD_PARSING;
+	load->callback = callback;
+	load->userdata = userdata;
+	load->budget = TSEE_MAPLOAD_DEFAULT_BUDGET;
+	load->start = SDL_GetPerformanceCounter();
+	SDL_AtomicSet(&load->read, 0);
+	SDL_AtomicSet(&load->done, 0);
+	tsee->map_load = load;
+	load->thread = SDL_CreateThread(TSEE_MapLoad_Thread, "TSEE_MapLoad", load);
+	if (!load->thread) {
+		TSEE_Warn("Couldn't start the map load thread (%s), reading `%s` on this thread.\n", SDL_GetError(), path);
+		TSEE_MapLoad_Thread(load);
+	}
+	return true;
+}
+
+/**
+ * @brief Sets how long is spent creating the loading map's objects each frame.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param milliseconds Milliseconds per frame, at least one batch of objects is always created.
+ */
+void TSEE_MapLoad_SetBudget(TSEE *tsee, double milliseconds) {
+	if (!tsee->map_load) return;
+	tsee->map_load->budget = milliseconds > 0 ? milliseconds : 0;
+}
+
+/**
+ * @brief Gets how far through the asynchronous map load is.
+ *
+ * @param tsee TSEE object with the map load.
+ * @return float From 0 to 1, or -1 if no map is loading.
+ */
+float TSEE_Map_GetLoadProgress(TSEE *tsee) {
+	TSEE_MapLoad *load = tsee->map_load;
+	if (!load || load->state == TSEE_MAPLOAD_TEARDOWN) {
+		return -1;
+	}
+	// Reading, decoding and building are weighted roughly by how long each takes.
+	switch (load->state) {
+		case TSEE_MAPLOAD_PARSING:
+			return 0.3f * SDL_AtomicGet(&load->read) / 1000.0f;
+		case TSEE_MAPLOAD_TEXTURES:
+			return 0.3f + 0.4f * (load->textures_used ? (float)load->textures_ready / load->textures_used : 1);
+		default:
+			return 0.7f + 0.3f * (load->record_count + load->instance_count ? (float)load->built / (load->record_count + load->instance_count) : 1);
+	}
+}
+
+/**
+ * @brief Reads a map into memory for an asynchronous load, run by the load thread.
+ *        Only touches the load and the paks the map is opened from.
+ *
+ * @param load Load to read the map of.
+ * @return true on success, false on fail or if the map isn't v2.
+ */
+bool TSEE_MapLoad_Parse(TSEE_MapLoad *load) {
+	TSEE_Map_File map;
+	if (!TSEE_Map_Open(load->tsee, &map, load->path)) {
+		return false;
+	}
+	TSEE_Stream *stream = map.stream;
+	if (!TSEE_Map_IsV2(stream)) {
+		load->legacy = true;
+		TSEE_Map_Close(&map);
+		return false;
+	}
+	TSEE_Map_Header *header = &load->header;
+	bool success = TSEE_Map_ReadHeader(stream, header) && TSEE_Map_ReadStrings(stream, header, &load->strings);
+	if (success) {
+		load->texture_paths = TSEE_Map_ReadTextures(stream, header, &load->strings);
+		success = load->texture_paths != NULL;
+	}
+	// Compressed maps are loaded whole, their chunks can't be read in place.
+	if (success && header->chunk_count > 0 && !map.compressed) {
+		load->chunks = TSEE_Map_ReadChunks(stream, header);
+		success = load->chunks != NULL;
+	}
+	if (success && TSEE_Map_ReadComponents(stream, header, &load->components) && TSEE_Map_SkipTo(stream, header->objects_offset)) {
+		// Chunked maps only load the objects outside every chunk, the rest are streamed in once it's swapped in.
+		load->record_count = load->chunks ? load->chunks[0].first_object : header->object_count;
+		load->records = xmalloc(sizeof(*load->records) * (load->record_count ? load->record_count : 1));
+		load->used = xmalloc(sizeof(*load->used) * (header->texture_count ? header->texture_count : 1));
+		success = load->records && load->used;
+	} else {
+		success = false;
+	}
+	if (success) {
+		memset(load->used, 0, sizeof(*load->used) * (header->texture_count ? header->texture_count : 1));
+	}
+	for (Uint64 first = 0; success && first < load->record_count; first += TSEE_MAPLOAD_READ_BATCH) {
+		size_t count = load->record_count - first < TSEE_MAPLOAD_READ_BATCH ? load->record_count - first : TSEE_MAPLOAD_READ_BATCH;
+		if (!TSEE_Stream_Read(stream, &load->records[first], sizeof(*load->records) * count)) {
+			TSEE_Error("Map's objects are truncated, read %zu of them.\n", (size_t)first);
+			success = false;
+			break;
+		}
+		for (size_t i = 0; i < count; i++) {
+			TSEE_Map_Object *record = &load->records[first + i];
+			TSEE_Map_SwapObject(record);
+			if (record->texture < header->texture_count) {
+				load->used[record->texture] = true;
+			}
+		}
+		SDL_AtomicSet(&load->read, (int)((first + count) * 1000 / load->record_count));
+	}
+	// Prefab instances are always loaded with the map, even if it's chunked.
+	if (success && header->prefab_count > 0) {
+		load->prefabs = TSEE_Map_ReadPrefabs(stream, header);
+		load->instances = load->prefabs ? TSEE_Map_ReadInstances(stream, header) : NULL;
+		success = load->instances != NULL;
+	}
+	if (success && load->prefabs) {
+		load->instance_count = header->instance_count;
+		for (Uint32 i = 0; i < header->prefab_count; i++) {
+			if (load->prefabs[i].texture < header->texture_count && load->prefabs[i].instance_count > 0) {
+				load->used[load->prefabs[i].texture] = true;
+			}
+		}
+	}
+	TSEE_Map_Close(&map);
+	return success;
+}
+
+/**
+ * @brief Reads the map of an asynchronous load, DO NOT CALL.
+ *
+ * @param data The TSEE_MapLoad.
+ * @return int 0
+ */
+int TSEE_MapLoad_Thread(void *data) {
+	TSEE_MapLoad *load = data;
+	load->parsed = TSEE_MapLoad_Parse(load);
+	SDL_AtomicSet(&load->read, 1000);
+	SDL_AtomicSet(&load->done, 1);
+	return 0;
+}
+
+/**
+ * @brief Creates an empty staged world, and a staged player with the current player's settings.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load to create them for.
+ * @return true on success, false on fail.
+ */
+bool TSEE_MapLoad_CreateWorld(TSEE *tsee, TSEE_MapLoad *load) {
+	load->world = xmalloc(sizeof(*load->world));
+	if (!load->world) {
+		return false;
+	}
+	load->world->objects = TSEE_Array_Create();
+	load->world->gravity = tsee->world->gravity;
+	load->world->scroll_x = 0;
+	load->world->scroll_y = 0;
+	load->world->max_scroll_x = tsee->world->max_scroll_x;
+	load->world->chunk_size = tsee->world->chunk_size;
+	load->world->compress_maps = tsee->world->compress_maps;
+	load->world->stream = NULL;
+	load->world->colliders = NULL;
+	load->world->collider_count = 0;
+	load->world->colliders_valid = false;
+	load->player = xmalloc(sizeof(*load->player));
+	if (!load->player) {
+		return false;
+	}
+	*load->player = *tsee->player;
+	load->player->object = NULL;
+	load->player->movement = (TSEE_Player_Movement){false, false, false, false};
+	load->player->grounded = true;
+	return true;
+}
+
+/**
+ * @brief Loads a map saved before maps were versioned into the staged world, all at once on the render thread.
+ *        Only the swap and the old world's teardown are spread over frames.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load of the older map.
+ * @return true on success, false on fail.
+ */
+bool TSEE_MapLoad_LoadLegacy(TSEE *tsee, TSEE_MapLoad *load) {
+	if (!TSEE_MapLoad_CreateWorld(tsee, load)) {
+		return false;
+	}
+	TSEE_Map_File map;
+	if (!TSEE_Map_Open(tsee, &map, load->path)) {
+		return false;
+	}
+	TSEE_World *world = tsee->world;
+	TSEE_Player *player = tsee->player;
+	tsee->world = load->world;
+	tsee->player = load->player;
+	bool success = TSEE_Map_LoadV1(tsee, map.stream);
+	tsee->world = world;
+	tsee->player = player;
+	TSEE_Map_Close(&map);
+	return success;
+}
+
+/**
+ * @brief Creates the staged world and player for a read map, and queues every texture it uses on the loader at once.
+ *        The textures are pinned so the texture cache doesn't evict them before the world they're for is drawn.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load whose map has been read.
+ * @return true on success, false on fail.
+ */
+bool TSEE_MapLoad_Stage(TSEE *tsee, TSEE_MapLoad *load) {
+	size_t textureCount = load->header.texture_count ? load->header.texture_count : 1;
+	load->textures = xmalloc(sizeof(*load->textures) * textureCount);
+	load->tried = xmalloc(sizeof(*load->tried) * textureCount);
+	if (!load->textures || !load->tried || !TSEE_MapLoad_CreateWorld(tsee, load)) {
+		return false;
+	}
+	memset(load->tried, 0, sizeof(*load->tried) * textureCount);
+	load->world->gravity = (TSEE_Vec2){load->header.gravity_x, load->header.gravity_y};
+	load->player->speed = load->header.player_speed;
+	load->player->jump_force = load->header.player_jump_force;
+
+	const char *name = TSEE_Map_GetString(&load->strings, load->header.name);
+	const char *author = TSEE_Map_GetString(&load->strings, load->header.author);
+	const char *version = TSEE_Map_GetString(&load->strings, load->header.map_version);
+	const char *description = TSEE_Map_GetString(&load->strings, load->header.description);
+	TSEE_Log("Loading into %s by %s in the background\nVersion: %s\n%s\n", name ? name : "", author ? author : "", version ? version : "", description ? description : "");
+
+	char **paths = xmalloc(sizeof(*paths) * textureCount);
+	if (!paths) {
+		return false;
+	}
+	load->textures_used = 0;
+	for (Uint32 i = 0; i < load->header.texture_count; i++) {
+		if (load->used[i]) {
+			paths[load->textures_used++] = (char *)load->texture_paths[i];
+		}
+	}
+	TSEE_Log("Loading %u textures\n", load->textures_used);
+	if (TSEE_Loader_Preload(tsee, paths, load->textures_used, false)) {
+		for (Uint32 i = 0; i < load->textures_used; i++) {
+			TSEE_TextureCache_Pin(tsee, TSEE_TextureCache_GetAsset(tsee, paths[i]));
+		}
+		load->pinned = true;
+	}
+	xfree(paths);
+	return true;
+}
+
+/**
+ * @brief Removes the pins TSEE_MapLoad_Stage put on the map's textures.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load to unpin the textures of.
+ */
+void TSEE_MapLoad_Unpin(TSEE *tsee, TSEE_MapLoad *load) {
+	if (!load->pinned) return;
+	load->pinned = false;
+	for (Uint32 i = 0; i < load->header.texture_count; i++) {
+		if (!load->used[i]) continue;
+		// Looked up again, the asset may have been merged into another with the same image since.
+		TSEE_Texture_Asset *asset = TSEE_HashMap_Get(tsee->texture_cache->assets, load->texture_paths[i]);
+		if (asset) {
+			TSEE_TextureCache_Unpin(tsee, asset);
+		}
+	}
+}
+
+/**
+ * @brief Checks whether the loader has finished with every texture the loading map uses.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load waiting for its textures.
+ * @return true once none of them are loading, false otherwise.
+ */
+bool TSEE_MapLoad_TexturesReady(TSEE *tsee, TSEE_MapLoad *load) {
+	Uint32 ready = 0;
+	for (Uint32 i = 0; i < load->header.texture_count; i++) {
+		if (!load->used[i]) continue;
+		TSEE_Texture_Asset *asset = TSEE_HashMap_Get(tsee->texture_cache->assets, load->texture_paths[i]);
+		if (!asset || !asset->loading) {
+			ready++;
+		}
+	}
+	load->textures_ready = ready;
+	return ready == load->textures_used;
+}
+
+/**
+ * @brief Creates the loading map's objects in the staged world until the frame's budget is used.
+ *        The staged world and player stand in for the current ones while the objects are created, so they're created as usual.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load being built.
+ * @return true once every object has been created, false otherwise.
+ */
+bool TSEE_MapLoad_Build(TSEE *tsee, TSEE_MapLoad *load) {
+	TSEE_World *world = tsee->world;
+	TSEE_Player *player = tsee->player;
+	tsee->world = load->world;
+	tsee->player = load->player;
+	if (load->built == 0) {
+		TSEE_Array_Reserve(tsee->world->objects, load->record_count + load->instance_count);
+		TSEE_Array_Reserve(tsee->textures, tsee->textures->size + load->record_count + load->instance_count);
+	}
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = load->budget * SDL_GetPerformanceFrequency() / 1000;
+	while (load->built < load->record_count) {
+		TSEE_Map_Object *record = &load->records[load->built++];
+		if (record->texture >= load->header.texture_count) {
+			load->invalid++;
+			continue;
+		}
+		TSEE_Texture *texture = NULL;
+		TSEE_Texture *first = load->textures[record->texture];
+		if (!load->tried[record->texture]) {
+			load->tried[record->texture] = true;
+			texture = TSEE_Texture_Create(tsee, (char *)load->texture_paths[record->texture]);
+			load->textures[record->texture] = texture;
+		} else if (first && first->asset) {
+			texture = TSEE_Texture_CreateFromAsset(tsee, first->asset);
+		}
+		if (!texture) {
+			load->skipped++;
+		} else if (!TSEE_Map_CreateObject(tsee, record, texture, &load->components, &load->strings)) {
+			if (load->textures[record->texture] == texture) {
+				// Try again with the next object, this texture is gone.
+				load->textures[record->texture] = NULL;
+				load->tried[record->texture] = false;
+			}
+			TSEE_Texture_Destroy(tsee, texture);
+			load->invalid++;
+		}
+		if (load->built % TSEE_MAPLOAD_BUILD_BATCH == 0 && SDL_GetPerformanceCounter() - start >= budget) {
+			break;
+		}
+	}
+	while (load->built >= load->record_count && load->prefab < load->header.prefab_count && SDL_GetPerformanceCounter() - start < budget) {
+		TSEE_MapLoad_Instantiate(tsee, load);
+	}
+	bool built = load->built == load->record_count + load->instance_count;
+	if (built) {
+		TSEE_Map_FindPlayer(tsee);
+	}
+	tsee->world = world;
+	tsee->player = player;
+	return built;
+}
+
+/**
+ * @brief Creates the next batch of the current prefab's instances in the staged world, moving on to the next prefab once they're all created.
+ *
+ * @param tsee TSEE object with the map load, standing in for the staged world.
+ * @param load Load being built, every record is already built.
+ */
+void TSEE_MapLoad_Instantiate(TSEE *tsee, TSEE_MapLoad *load) {
+	TSEE_Map_Prefab *record = &load->prefabs[load->prefab];
+	if (load->prefab_built == 0) {
+		load->current.asset = NULL;
+		if (record->texture >= load->header.texture_count || !TSEE_Map_CreatePrefab(&load->current, record, &load->components)) {
+			// None of its instances can be created, so they're skipped all at once.
+			load->invalid += record->instance_count;
+			load->built += record->instance_count;
+			load->prefab++;
+			return;
+		}
+		// Textures are shared with the records the same way, the first texture made from one keeps its asset.
+		if (!load->tried[record->texture]) {
+			load->tried[record->texture] = true;
+			load->current.asset = TSEE_Texture_LoadAsset(tsee, (char *)load->texture_paths[record->texture]);
+		} else if (load->textures[record->texture]) {
+			load->current.asset = load->textures[record->texture]->asset;
+		}
+	}
+	Uint64 count = record->instance_count - load->prefab_built;
+	if (count > TSEE_MAPLOAD_BUILD_BATCH) {
+		count = TSEE_MAPLOAD_BUILD_BATCH;
+	}
+	size_t created = 0;
+	if (load->current.asset) {
+		size_t first = tsee->world->objects->size;
+		created = TSEE_Prefab_Instantiate(tsee, &load->current, &load->instances[record->first_instance + load->prefab_built], count);
+		if (created > 0 && !load->textures[record->texture]) {
+			load->textures[record->texture] = ((TSEE_Object *)tsee->world->objects->data[first])->texture;
+		}
+	}
+	load->skipped += count - created;
+	load->prefab_built += count;
+	load->built += count;
+	if (load->prefab_built == record->instance_count) {
+		load->prefab++;
+		load->prefab_built = 0;
+	}
+}
+
+/**
+ * @brief Destroys objects from the end of a world along with their textures.
+ *
+ * @param tsee TSEE object the world's textures are in.
+ * @param world World to destroy the objects of.
+ * @param count Most objects to destroy.
+ * @return true once the world has no objects left, false otherwise.
+ */
+bool TSEE_MapLoad_DestroyObjects(TSEE *tsee, TSEE_World *world, size_t count) {
+	TSEE_Array *objects = world->objects;
+	size_t first = objects->size > count ? objects->size - count : 0;
+	TSEE_Texture **textures = xmalloc(sizeof(*textures) * (objects->size - first ? objects->size - first : 1));
+	size_t textureCount = 0;
+	for (size_t i = first; i < objects->size; i++) {
+		TSEE_Object *object = objects->data[i];
+		if (object->texture) {
+			textures[textureCount++] = object->texture;
+		}
+		TSEE_Object_Destroy(tsee, object, false);
+	}
+	objects->size = first;
+	TSEE_Texture_DestroyBatch(tsee, textures, textureCount);
+	xfree(textures);
+	return first == 0;
+}
+
+/**
+ * @brief Destroys a world and every object in it.
+ *
+ * @param tsee TSEE object the world's textures are in.
+ * @param world World to destroy.
+ */
+void TSEE_MapLoad_DestroyWorld(TSEE *tsee, TSEE_World *world) {
+	TSEE_MapLoad_DestroyObjects(tsee, world, world->objects->size);
+	TSEE_Array_Destroy(world->objects);
+	TSEE_Physics_FreeColliders(world);
+	xfree(world);
+}
+
+/**
+ * @brief Frees what's left of a map load, but not its worlds.
+ *
+ * @param load Load to free.
+ */
+void TSEE_MapLoad_Free(TSEE_MapLoad *load) {
+	TSEE_Map_FreeStrings(&load->strings);
+	if (load->texture_paths) xfree(load->texture_paths);
+	if (load->used) xfree(load->used);
+	if (load->chunks) xfree(load->chunks);
+	if (load->components.data) xfree(load->components.data);
+	if (load->records) xfree(load->records);
+	if (load->prefabs) xfree(load->prefabs);
+	if (load->instances) xfree(load->instances);
+	if (load->textures) xfree(load->textures);
+	if (load->tried) xfree(load->tried);
+	xfree(load->path);
+	xfree(load);
+}
+
+/**
+ * @brief Gives up on a map load that failed, the current world stays as it is.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load that failed.
+ */
+void TSEE_MapLoad_Fail(TSEE *tsee, TSEE_MapLoad *load) {
+	TSEE_Error("Couldn't load map `%s`, keeping the current one.\n", load->path);
+	tsee->map_load = NULL;
+	TSEE_MapLoad_Unpin(tsee, load);
+	if (load->world) {
+		TSEE_MapLoad_DestroyWorld(tsee, load->world);
+	}
+	if (load->player) xfree(load->player);
+	TSEE_Map_LoadCallback callback = load->callback;
+	void *userdata = load->userdata;
+	TSEE_MapLoad_Free(load);
+	if (callback) {
+		callback(tsee, false, userdata);
+	}
+}
+
+/**
+ * @brief Replaces the current world and player with the staged ones, keeping the old world to tear down.
+ *        Chunked maps start streaming their chunks once they're swapped in.
+ *
+ * @param tsee TSEE object with the map load.
+ * @param load Load that's finished building.
+ */
+void TSEE_MapLoad_Swap(TSEE *tsee, TSEE_MapLoad *load) {
+	TSEE_MapStream_Destroy(tsee);
+	TSEE_World *world = tsee->world;
+	xfree(tsee->player);
+	tsee->world = load->world;
+	tsee->player = load->player;
+	load->world = world;
+	load->player = NULL;
+	load->state = TSEE_MAPLOAD_TEARDOWN;
+	TSEE_MapLoad_Unpin(tsee, load);
+	if (load->skipped > 0) {
+		TSEE_Warn("Skipped %zu objects with textures that couldn't be loaded.\n", load->skipped);
+	}
+	if (load->invalid > 0) {
+		TSEE_Warn("Skipped %zu invalid objects.\n", load->invalid);
+	}
+	TSEE_Log("Map `%s` loaded %zu objects in the background in %.3f ms.\n", load->path, tsee->world->objects->size, (SDL_GetPerformanceCounter() - load->start) * 1000 / (double)SDL_GetPerformanceFrequency());
+
+	bool success = true;
+	if (load->chunks) {
+		// The stream takes the strings, paths and chunks.
+		success = TSEE_MapStream_Create(tsee, load->path, &load->header, &load->strings, load->texture_paths, load->chunks);
+		load->texture_paths = NULL;
+		load->chunks = NULL;
+	}
+	if (load->callback) {
+		load->callback(tsee, success, load->userdata);
+	}
+}
+
+/**
+ * @brief Moves the asynchronous map load along, called once a frame by TSEE_RenderAll before anything is drawn.
+ *        The staged world is swapped in here, so it's never swapped in partway through a frame.
+ *
+ * @param tsee TSEE object with the map load.
+ */
+void TSEE_MapLoad_Update(TSEE *tsee) {
+	TSEE_MapLoad *load = tsee->map_load;
+	if (!load) return;
+	switch (load->state) {
+		case TSEE_MAPLOAD_PARSING:
+			if (!SDL_AtomicGet(&load->done)) return;
+			if (load->thread) {
+				SDL_WaitThread(load->thread, NULL);
+				load->thread = NULL;
+			}
+			if (load->legacy) {
+				if (TSEE_MapLoad_LoadLegacy(tsee, load)) {
+					TSEE_MapLoad_Swap(tsee, load);
+				} else {
+					TSEE_MapLoad_Fail(tsee, load);
+				}
+				return;
+			}
+			if (!load->parsed || !TSEE_MapLoad_Stage(tsee, load)) {
+				TSEE_MapLoad_Fail(tsee, load);
+				return;
+			}
+			load->state = TSEE_MAPLOAD_TEXTURES;
+			return;
+		case TSEE_MAPLOAD_TEXTURES:
+			if (!TSEE_MapLoad_TexturesReady(tsee, load)) return;
+			load->state = TSEE_MAPLOAD_BUILDING;
+			return;
+		case TSEE_MAPLOAD_BUILDING:
+			if (TSEE_MapLoad_Build(tsee, load)) {
+				TSEE_MapLoad_Swap(tsee, load);
+			}
+			return;
+		case TSEE_MAPLOAD_TEARDOWN:
+			if (TSEE_MapLoad_DestroyObjects(tsee, load->world, TSEE_MAPLOAD_TEARDOWN_BATCH)) {
+				tsee->map_load = NULL;
+				TSEE_Array_Destroy(load->world->objects);
+				TSEE_Physics_FreeColliders(load->world);
+				xfree(load->world);
+				TSEE_MapLoad_Free(load);
+			}
+			return;
+	}
+}
+
+/**
+ * @brief Cancels the asynchronous map load, or finishes tearing down the old world if it's already swapped in.
+ *
+ * @param tsee TSEE object with the map load.
+ */
+void TSEE_MapLoad_Destroy(TSEE *tsee) {
+	TSEE_MapLoad *load = tsee->map_load;
+	if (!load) return;
+	tsee->map_load = NULL;
+	if (load->thread) {
+		SDL_WaitThread(load->thread, NULL);
+	}
+	TSEE_MapLoad_Unpin(tsee, load);
+	if (load->world) {
+		TSEE_MapLoad_DestroyWorld(tsee, load->world);
+	}
+	if (load->player) xfree(load->player);
+	TSEE_MapLoad_Free(load);
+}
\ No newline at end of file
@@ -1,8 +1,107 @@
 // Maps
 
-bool TSEE_ReadFile(void *dst, size_t size, size_t n, FILE *fp);
-bool TSEE_WriteFile(void *src, size_t size, size_t n, FILE *fp);
-char *TSEE_ReadFile_UntilNull(FILE *fp);
-void TSEE_WriteFile_String(FILE *fp, char *string);
+void TSEE_Map_Clear(TSEE *tsee);
+bool TSEE_Map_FindPlayer(TSEE *tsee);
+bool TSEE_Map_Open(TSEE *tsee, TSEE_Map_File *map, const char *path);
+void TSEE_Map_Close(TSEE_Map_File *map);
 bool TSEE_Map_Load(TSEE *tsee, char *path);
-bool TSEE_Map_Save(TSEE *tsee, char *path);
\ No newline at end of file
+bool TSEE_Map_LoadV1(TSEE *tsee, TSEE_Stream *stream);
+bool TSEE_Map_Save(TSEE *tsee, char *path);
+
+// Map Format v2
+
+bool TSEE_Map_IsV2(TSEE_Stream *stream);
+bool TSEE_Map_SkipTo(TSEE_Stream *stream, Uint64 offset);
+bool TSEE_Map_ReadHeader(TSEE_Stream *stream, TSEE_Map_Header *header);
+TSEE_Map_Chunk *TSEE_Map_ReadChunks(TSEE_Stream *stream, const TSEE_Map_Header *header);
+TSEE_Map_Prefab *TSEE_Map_ReadPrefabs(TSEE_Stream *stream, const TSEE_Map_Header *header);
+TSEE_Vec2 *TSEE_Map_ReadInstances(TSEE_Stream *stream, const TSEE_Map_Header *header);
+bool TSEE_Map_ReadComponents(TSEE_Stream *stream, const TSEE_Map_Header *header, TSEE_Map_ComponentData *components);
+Uint64 TSEE_Map_ComponentsSize(TSEE_Object_Attributes attributes);
+bool TSEE_Map_CheckComponents(const TSEE_Map_ComponentData *components, TSEE_Object_Attributes attributes, Uint64 offset);
+bool TSEE_Map_CreatePrefab(TSEE_Prefab *prefab, const TSEE_Map_Prefab *record, const TSEE_Map_ComponentData *components);
+bool TSEE_Map_SaveComponents(TSEE_Map_Snapshot *snapshot, const TSEE_Object *object, TSEE_Map_Object *record);
+void TSEE_Map_LoadComponents(TSEE_Object *object, TSEE_Object_Attributes attributes, const TSEE_Map_ComponentData *components, Uint64 offset, const TSEE_Map_StringTable *strings);
+void TSEE_Map_SwapObject(TSEE_Map_Object *record);
+TSEE_Object *TSEE_Map_CreateObject(TSEE *tsee, const TSEE_Map_Object *record, TSEE_Texture *texture, const TSEE_Map_ComponentData *components, const TSEE_Map_StringTable *strings);
+bool TSEE_Map_ReadStrings(TSEE_Stream *stream, const TSEE_Map_Header *header, TSEE_Map_StringTable *table);
+const char **TSEE_Map_ReadTextures(TSEE_Stream *stream, const TSEE_Map_Header *header, const TSEE_Map_StringTable *strings);
+const char *TSEE_Map_GetString(const TSEE_Map_StringTable *table, Uint32 index);
+void TSEE_Map_FreeStrings(TSEE_Map_StringTable *table);
+bool TSEE_Map_LoadV2(TSEE *tsee, TSEE_Stream *stream, const char *path);
+Uint32 TSEE_Map_AddString(TSEE_Map_Strings *strings, const char *string);
+Uint32 TSEE_Map_AddTexture(TSEE_Map_Snapshot *snapshot, const char *path);
+int TSEE_Map_CompareSaveObjects(const void *a, const void *b);
+Uint64 TSEE_Map_SpreadBits(Uint32 value);
+Uint64 TSEE_Map_MortonCode(float x, float y, float left, float top, float size);
+void TSEE_Map_SortObjects(TSEE_Map_Snapshot *snapshot);
+Sint32 TSEE_Map_ChunkCoordinate(float position, float chunkSize);
+void TSEE_Map_AddObject(TSEE_Map_Snapshot *snapshot, const TSEE_Map_Object *record);
+TSEE_Map_Snapshot *TSEE_Map_CreateSnapshot(size_t capacity);
+TSEE_Map_Snapshot *TSEE_Map_TakeSnapshot(TSEE *tsee);
+void TSEE_Map_FreeSnapshot(TSEE_Map_Snapshot *snapshot);
+TSEE_Map_Prefab *TSEE_Map_FindPrefabs(TSEE_Map_Snapshot *snapshot, Uint32 *prefabCount);
+bool TSEE_Map_WriteSnapshot(TSEE_Map_Snapshot *snapshot, TSEE_Stream *stream);
+bool TSEE_Map_SaveV2(TSEE *tsee, TSEE_Stream *stream);
+
+// Map Streaming
+
+void TSEE_Map_SetChunkSize(TSEE *tsee, float size);
+bool TSEE_MapStream_Create(TSEE *tsee, const char *path, const TSEE_Map_Header *header, TSEE_Map_StringTable *strings, const char **texturePaths, TSEE_Map_Chunk *chunks);
+void TSEE_MapStream_SetRadius(TSEE *tsee, int load, int unload);
+Uint32 TSEE_MapStream_Find(TSEE_MapStream *stream, Sint32 x, Sint32 y);
+SDL_Rect TSEE_MapStream_GetView(TSEE *tsee);
+Sint64 TSEE_MapStream_Distance(const TSEE_MapStream_Chunk *chunk, const SDL_Rect *view);
+bool TSEE_MapStream_ReadChunk(TSEE_MapStream *stream, TSEE_MapStream_Chunk *chunk);
+int TSEE_MapStream_Thread(void *data);
+void TSEE_MapStream_QueueNearby(TSEE *tsee);
+void TSEE_MapStream_Place(TSEE *tsee, TSEE_MapStream_Chunk *chunk);
+void TSEE_MapStream_Unload(TSEE *tsee);
+void TSEE_MapStream_Update(TSEE *tsee);
+void TSEE_MapStream_Destroy(TSEE *tsee);
+
+// Asynchronous Map Loading
+
+bool TSEE_Map_LoadAsync(TSEE *tsee, char *path, TSEE_Map_LoadCallback callback, void *userdata);
+void TSEE_MapLoad_SetBudget(TSEE *tsee, double milliseconds);
+float TSEE_Map_GetLoadProgress(TSEE *tsee);
+bool TSEE_MapLoad_Parse(TSEE_MapLoad *load);
+int TSEE_MapLoad_Thread(void *data);
+bool TSEE_MapLoad_CreateWorld(TSEE *tsee, TSEE_MapLoad *load);
+bool TSEE_MapLoad_LoadLegacy(TSEE *tsee, TSEE_MapLoad *load);
+bool TSEE_MapLoad_Stage(TSEE *tsee, TSEE_MapLoad *load);
+void TSEE_MapLoad_Unpin(TSEE *tsee, TSEE_MapLoad *load);
+bool TSEE_MapLoad_TexturesReady(TSEE *tsee, TSEE_MapLoad *load);
+bool TSEE_MapLoad_Build(TSEE *tsee, TSEE_MapLoad *load);
+void TSEE_MapLoad_Instantiate(TSEE *tsee, TSEE_MapLoad *load);
+bool TSEE_MapLoad_DestroyObjects(TSEE *tsee, TSEE_World *world, size_t count);
+void TSEE_MapLoad_DestroyWorld(TSEE *tsee, TSEE_World *world);
+void TSEE_MapLoad_Free(TSEE_MapLoad *load);
+void TSEE_MapLoad_Fail(TSEE *tsee, TSEE_MapLoad *load);
+void TSEE_MapLoad_Swap(TSEE *tsee, TSEE_MapLoad *load);
+void TSEE_MapLoad_Update(TSEE *tsee);
+void TSEE_MapLoad_Destroy(TSEE *tsee);
+
+// Scenes
+
+const char *TSEE_Scene_GetScalar(struct fy_node *node, const char *key, size_t *length);
+Uint32 TSEE_Scene_AddString(TSEE_Map_Snapshot *snapshot, struct fy_node *node, const char *key, const char *fallback);
+bool TSEE_Scene_ParseFloat(struct fy_node *node, float *value);
+bool TSEE_Scene_GetFloat(struct fy_node *node, const char *key, float *value);
+bool TSEE_Scene_GetVec2(struct fy_node *node, const char *key, TSEE_Vec2 *value);
+bool TSEE_Scene_GetAttributes(struct fy_node *node, TSEE_Object_Attributes *attributes);
+struct fy_node *TSEE_Scene_Field(struct fy_node *node, struct fy_node *prefab, const char *key);
+bool TSEE_Scene_AddObject(TSEE_Map_Snapshot *snapshot, struct fy_node *node, struct fy_node *prefabs, int index);
+TSEE_Map_Snapshot *TSEE_Scene_Compile(const char *source, size_t size);
+char *TSEE_Map_CompileScene(TSEE *tsee, const char *path);
+bool TSEE_Map_LoadScene(TSEE *tsee, const char *path);
+
+// Background Map Saving
+
+void TSEE_Map_SetCompression(TSEE *tsee, bool compress);
+bool TSEE_Map_WriteFile(TSEE_Map_Snapshot *snapshot, const char *path);
+bool TSEE_Map_SaveAsync(TSEE *tsee, char *path, TSEE_Map_SaveCallback callback, void *userdata);
+int TSEE_MapSave_Thread(void *data);
+void TSEE_MapSave_Update(TSEE *tsee);
+void TSEE_MapSave_Wait(TSEE *tsee);
+void TSEE_MapSave_Destroy(TSEE *tsee);
@@ -0,0 +1,190 @@
+#include "../tsee.h"
+#include <unistd.h>
+
+#define TSEE_MAPSAVE_TEMP_SUFFIX ".tmp"
+
+/**
+ * @brief Sets whether maps are saved compressed with zlib. Compressed maps are smaller on disk and decompressed as they're read,
+ *        but chunked maps are always saved uncompressed so their chunks can be streamed from the file in place.
+ *
+ * @param tsee TSEE object to set it for.
+ * @param compress True to compress maps when they're saved.
+ */
+void TSEE_Map_SetCompression(TSEE *tsee, bool compress) {
+	tsee->world->compress_maps = compress;
+}
+
+/**
+ * @brief Writes a snapshot to a map file. It's written to a temporary file next to it first,
+ *        synced to disk, then renamed over the map, so a crash or a full disk never leaves a partly written map.
+ *        Every write gets its own temporary file, so saves to the same map from other threads or processes can't write into each other's.
+ *        Compressed snapshots are written as the compressed map's header then the map through zlib.
+ *
+ * @param snapshot Snapshot to write.
+ * @param path Path of the map.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_WriteFile(TSEE_Map_Snapshot *snapshot, const char *path) {
+	static SDL_atomic_t writes;
+	// The path, the process id and a count of this process's writes, each at most 20 digits.
+	size_t length = strlen(path) + 2 * 21 + sizeof(TSEE_MAPSAVE_TEMP_SUFFIX);
+	char *temporary = xmalloc(length);
+	if (!temporary) {
+		return false;
+	}
+	snprintf(temporary, length, "%s.%ld.%d" TSEE_MAPSAVE_TEMP_SUFFIX, path, (long)getpid(), SDL_AtomicAdd(&writes, 1));
+	TSEE_Stream file;
+	if (!TSEE_Stream_OpenFile(&file, temporary, true)) {
+		TSEE_Error("Failed to open map file (%s)\n", temporary);
+		xfree(temporary);
+		return false;
+	}
+	bool success;
+	if (snapshot->compressed) {
+		TSEE_Stream zlib;
+		success = TSEE_Stream_Write(&file, TSEE_MAP_ZLIB_MAGIC, sizeof(TSEE_MAP_ZLIB_MAGIC) - 1) && TSEE_Stream_OpenZlib(&zlib, &file, true);
+		if (success) {
+			success = TSEE_Map_WriteSnapshot(snapshot, &zlib);
+			// Closing finishes the compressed data, so it has to happen before the file is synced.
+			if (!TSEE_Stream_Close(&zlib)) {
+				success = false;
+			}
+		}
+	} else {
+		success = TSEE_Map_WriteSnapshot(snapshot, &file);
+	}
+	success = success && TSEE_Stream_Sync(&file);
+	if (!TSEE_Stream_Close(&file)) {
+		success = false;
+	}
+	if (success) {
+		success = TSEE_File_Replace(temporary, path);
+	}
+	if (!success) {
+		remove(temporary);
+	}
+	xfree(temporary);
+	return success;
+}
+
+/**
+ * @brief Saves the current world as a map without stalling the frame. A snapshot of the world is taken now,
+ *        then it's written on a background thread, see TSEE_Map_WriteFile. The world can change straight away.
+ *
+ * @param tsee TSEE object to save.
+ * @param path Path to save to.
+ * @param callback Called on the render thread once the map is written, or NULL.
+ * @param userdata Passed to the callback.
+ * @return true if the save started, false if a save is already running or the world can't be saved.
+ */
+bool TSEE_Map_SaveAsync(TSEE *tsee, char *path, TSEE_Map_SaveCallback callback, void *userdata) {
+	if (tsee->map_save) {
+		TSEE_Warn("Already saving a map, not saving `%s`.\n", path);
+		return false;
+	}
+	if (tsee->world->stream) {
+		TSEE_Error("Can't save a streamed map, only its loaded chunks are in the world.\n");
+		return false;
+	}
+	Uint64 start = SDL_GetPerformanceCounter();
+	TSEE_Map_Snapshot *snapshot = TSEE_Map_TakeSnapshot(tsee);
+	if (!snapshot) {
+		return false;
+	}
+	TSEE_MapSave *save = xmalloc(sizeof(*save));
+	if (!save) {
+		TSEE_Map_FreeSnapshot(snapshot);
+		return false;
+	}
+	save->snapshot = snapshot;
+	save->path = strdup(path);
+	save->callback = callback;
+	save->userdata = userdata;
+	save->success = false;
+	save->start = start;
+	SDL_AtomicSet(&save->done, 0);
+	TSEE_Log("Took a snapshot of %zu objects in %.3f ms.\n", snapshot->count, (SDL_GetPerformanceCounter() - start) * 1000 / (double)SDL_GetPerformanceFrequency());
+	tsee->map_save = save;
+	save->thread = SDL_CreateThread(TSEE_MapSave_Thread, "TSEE_MapSave", save);
+	if (!save->thread) {
+		TSEE_Warn("Couldn't start the map save thread (%s), writing `%s` on this thread.\n", SDL_GetError(), path);
+		TSEE_MapSave_Thread(save);
+	}
+	return true;
+}
+
+/**
+ * @brief Writes the snapshot of a background save, DO NOT CALL.
+ *
+ * @param data The TSEE_MapSave.
+ * @return int 0
+ */
+int TSEE_MapSave_Thread(void *data) {
+	TSEE_MapSave *save = data;
+	save->success = TSEE_Map_WriteFile(save->snapshot, save->path);
+	SDL_AtomicSet(&save->done, 1);
+	return 0;
+}
+
+/**
+ * @brief Finishes the background save once it's written, called once a frame by TSEE_RenderAll.
+ *
+ * @param tsee TSEE object with the save.
+ */
+void TSEE_MapSave_Update(TSEE *tsee) {
+	TSEE_MapSave *save = tsee->map_save;
+	if (!save || !SDL_AtomicGet(&save->done)) return;
+	tsee->map_save = NULL;
+	if (save->thread) {
+		SDL_WaitThread(save->thread, NULL);
+	}
+	if (save->success) {
+		TSEE_Log("Saved map to %s in the background in %.3f ms.\n", save->path, (SDL_GetPerformanceCounter() - save->start) * 1000 / (double)SDL_GetPerformanceFrequency());
+	} else {
+		TSEE_Error("Failed to save map to %s\n", save->path);
+	}
+	TSEE_Map_SaveCallback callback = save->callback;
+	void *userdata = save->userdata;
+	bool success = save->success;
+	TSEE_Map_FreeSnapshot(save->snapshot);
+	xfree(save->path);
+	xfree(save);
+	if (callback) {
+		callback(tsee, success, userdata);
+	}
+}
+
+/**
+ * @brief Waits for the background save to be written, then finishes it like TSEE_MapSave_Update.
+ *
+ * @param tsee TSEE object with the save.
+ */
+void TSEE_MapSave_Wait(TSEE *tsee) {
+	TSEE_MapSave *save = tsee->map_save;
+	if (!save) return;
+	if (save->thread) {
+		SDL_WaitThread(save->thread, NULL);
+		save->thread = NULL;
+	}
+	TSEE_MapSave_Update(tsee);
+}
+
+/**
+ * @brief Waits for the background save to be written, so closing doesn't lose it. Its callback isn't called.
+ *
+ * @param tsee TSEE object with the save.
+ */
+void TSEE_MapSave_Destroy(TSEE *tsee) {
+	TSEE_MapSave *save = tsee->map_save;
+	if (!save) return;
+	tsee->map_save = NULL;
+	if (save->thread) {
+		SDL_WaitThread(save->thread, NULL);
+	}
+	if (!save->success) {
+		TSEE_Error("Failed to save map to %s\n", save->path);
+	}
+	TSEE_Map_FreeSnapshot(save->snapshot);
+	xfree(save->path);
+	xfree(save);
+}
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "../tsee.h"
+#include <unistd.h>
+
+#define TSEE_SCENE_CACHE_SUFFIX ".tsee_map"
+
+/**
+ * @brief Finds a scalar in a YAML mapping.
+ *
+ * @param node Mapping to look in.
+ * @param key Key of the scalar.
+ * @param length Set to the scalar's length, scalars aren't NUL terminated.
+ * @return const char* The scalar, or NULL if it isn't there or isn't a scalar.
+ */
+const char *TSEE_Scene_GetScalar(struct fy_node *node, const char *key, size_t *length) {
+	struct fy_node *value = node ? fy_node_mapping_lookup_by_string(node, key, strlen(key)) : NULL;
+	if (!value || fy_node_get_type(value) != FYNT_SCALAR) {
+		return NULL;
+	}
+	return fy_node_get_scalar(value, length);
+}
+
+/**
+ * @brief Adds a string from a YAML mapping to a scene's map.
+ *
+ * @param snapshot Map being built.
+ * @param node Mapping to look in.
+ * @param key Key of the string.
+ * @param fallback Added if the string isn't there.
+ * @return Uint32 Index of the string.
+ */
+Uint32 TSEE_Scene_AddString(TSEE_Map_Snapshot *snapshot, struct fy_node *node, const char *key, const char *fallback) {
+	size_t length;
+	const char *scalar = TSEE_Scene_GetScalar(node, key, &length);
+	if (!scalar) {
+		return TSEE_Map_AddString(&snapshot->strings, fallback);
+	}
+	char *string = strndup(scalar, length);
+	Uint32 index = TSEE_Map_AddString(&snapshot->strings, string);
+	xfree(string);
+	return index;
+}
+
+/**
+ * @brief Parses a YAML scalar as a float.
+ *
+ * @param node Scalar node.
+ * @param value Set to the number.
+ * @return true on success, false if it isn't a number.
+ */
+bool TSEE_Scene_ParseFloat(struct fy_node *node, float *value) {
+	size_t length;
+	const char *scalar = fy_node_get_type(node) == FYNT_SCALAR ? fy_node_get_scalar(node, &length) : NULL;
+	char number[64];
+	if (!scalar || length == 0 || length >= sizeof(number)) {
+		return false;
+	}
+	memcpy(number, scalar, length);
+	number[length] = '\0';
+	char *end;
+	*value = strtof(number, &end);
+	return *end == '\0';
+}
+
+/**
+ * @brief Reads a float from a YAML mapping, leaving it alone if it isn't there.
+ *
+ * @param node Mapping to look in.
+ * @param key Key of the float.
+ * @param value Set to the float if it's there.
+ * @return true on success, false if it's there but isn't a number.
+ */
+bool TSEE_Scene_GetFloat(struct fy_node *node, const char *key, float *value) {
+	struct fy_node *child = fy_node_mapping_lookup_by_string(node, key, strlen(key));
+	if (!child) {
+		return true;
+	}
+	if (!TSEE_Scene_ParseFloat(child, value)) {
+		TSEE_Error("Scene's `%s` isn't a number.\n", key);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Reads a vector written as [x, y] from a YAML mapping, leaving it alone if it isn't there.
+ *
+ * @param node Mapping to look in.
+ * @param key Key of the vector.
+ * @param value Set to the vector if it's there.
+ * @return true on success, false if it's there but isn't two numbers.
+ */
+bool TSEE_Scene_GetVec2(struct fy_node *node, const char *key, TSEE_Vec2 *value) {
+	struct fy_node *child = fy_node_mapping_lookup_by_string(node, key, strlen(key));
+	if (!child) {
+		return true;
+	}
+	if (fy_node_get_type(child) != FYNT_SEQUENCE || fy_node_sequence_item_count(child) != 2
+		|| !TSEE_Scene_ParseFloat(fy_node_sequence_get_by_index(child, 0), &value->x)
+		|| !TSEE_Scene_ParseFloat(fy_node_sequence_get_by_index(child, 1), &value->y)) {
+		TSEE_Error("Scene's `%s` isn't written as [x, y].\n", key);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Reads an object's attributes, written as a list of names like [physics, player].
+ *
+ * @param node The object's mapping.
+ * @param attributes Set to the attributes.
+ * @return true on success, false if an attribute isn't known.
+ */
+bool TSEE_Scene_GetAttributes(struct fy_node *node, TSEE_Object_Attributes *attributes) {
+	const struct {
+		const char *name;
+		TSEE_Object_Attributes attribute;
+	} names[] = {
+		{"physics", TSEE_ATTRIB_PHYS},
+		{"parallax", TSEE_ATTRIB_PARALLAX},
+		{"text", TSEE_ATTRIB_TEXT},
+		{"ui", TSEE_ATTRIB_UI},
+		{"player", TSEE_ATTRIB_PLAYER},
+		{"static", TSEE_ATTRIB_STATIC},
+	};
+	*attributes = TSEE_ATTRIB_NONE;
+	struct fy_node *list = fy_node_mapping_lookup_by_string(node, "attributes", strlen("attributes"));
+	if (!list) {
+		return true;
+	}
+	if (fy_node_get_type(list) != FYNT_SEQUENCE) {
+		TSEE_Error("Scene object's attributes aren't a list.\n");
+		return false;
+	}
+	for (int i = 0; i < fy_node_sequence_item_count(list); i++) {
+		struct fy_node *item = fy_node_sequence_get_by_index(list, i);
+		size_t length = 0;
+		const char *name = fy_node_get_type(item) == FYNT_SCALAR ? fy_node_get_scalar(item, &length) : NULL;
+		size_t found = 0;
+		while (found < sizeof(names) / sizeof(names[0]) && !(name && strlen(names[found].name) == length && memcmp(names[found].name, name, length) == 0)) {
+			found++;
+		}
+		if (found == sizeof(names) / sizeof(names[0])) {
+			TSEE_Error("Scene object has an unknown attribute `%.*s`.\n", (int)length, name ? name : "");
+			return false;
+		}
+		*attributes |= names[found].attribute;
+	}
+	return true;
+}
+
+/**
+ * @brief Finds which of an object and its prefab sets a field, the object's own fields win.
+ *
+ * @param node The object's mapping.
+ * @param prefab The prefab's mapping, or NULL if it isn't made from one.
+ * @param key Key of the field.
+ * @return struct fy_node* The mapping to read the field from.
+ */
+struct fy_node *TSEE_Scene_Field(struct fy_node *node, struct fy_node *prefab, const char *key) {
+	if (!prefab || fy_node_mapping_lookup_by_string(node, key, strlen(key))) {
+		return node;
+	}
+	return prefab;
+}
+
+/**
+ * @brief Adds an object from a scene to its map. Objects can name one of the scene's prefabs,
+ *        then any field they don't set comes from the prefab.
+ *
+ * @param snapshot Map being built.
+ * @param node The object's mapping.
+ * @param prefabs The scene's prefabs mapping, or NULL if it has none.
+ * @param index Position of the object in the scene, for errors.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Scene_AddObject(TSEE_Map_Snapshot *snapshot, struct fy_node *node, struct fy_node *prefabs, int index) {
+	if (fy_node_get_type(node) != FYNT_MAPPING) {
+		TSEE_Error("Scene object %d isn't a mapping.\n", index);
+		return false;
+	}
+	size_t length;
+	struct fy_node *prefab = NULL;
+	const char *name = TSEE_Scene_GetScalar(node, "prefab", &length);
+	if (name) {
+		prefab = prefabs ? fy_node_mapping_lookup_by_string(prefabs, name, length) : NULL;
+		if (!prefab || fy_node_get_type(prefab) != FYNT_MAPPING) {
+			TSEE_Error("Scene object %d uses an unknown prefab `%.*s`.\n", index, (int)length, name);
+			return false;
+		}
+	}
+	const char *texture = TSEE_Scene_GetScalar(TSEE_Scene_Field(node, prefab, "texture"), "texture", &length);
+	if (!texture) {
+		TSEE_Error("Scene object %d has no texture.\n", index);
+		return false;
+	}
+	TSEE_Object_Attributes attributes;
+	TSEE_Vec2 position = {0, 0};
+	if (!TSEE_Scene_GetAttributes(TSEE_Scene_Field(node, prefab, "attributes"), &attributes)
+		|| !TSEE_Scene_GetVec2(TSEE_Scene_Field(node, prefab, "position"), "position", &position)) {
+		TSEE_Error("Scene object %d is invalid.\n", index);
+		return false;
+	}
+	// Checked and resolved the same way TSEE_Object_Create does, so a player is saved with the physics fields it'll have.
+	if (!TSEE_Attributes_IsValid(attributes)) {
+		TSEE_Error("Scene object %d is invalid.\n", index);
+		return false;
+	}
+	attributes = TSEE_Attributes_Resolve(attributes);
+	// Each component's fields are read into a blank object, then saved the same way the world's objects are, see TSEE_Map_TakeSnapshot.
+	TSEE_Object object;
+	memset(&object, 0, sizeof(object));
+	object.attributes = attributes;
+	size_t componentCount;
+	const TSEE_Component *components = TSEE_Component_GetAll(&componentCount);
+	bool success = true;
+	for (size_t c = 0; success && c < componentCount; c++) {
+		const TSEE_Component *component = &components[c];
+		if (!TSEE_Attributes_Check(attributes, component->attribute)) continue;
+		for (size_t i = 0; success && i < component->field_count; i++) {
+			const TSEE_Field *field = &component->fields[i];
+			struct fy_node *value = TSEE_Scene_Field(node, prefab, field->name);
+			if (field->type == TSEE_FIELD_STRING) {
+				size_t stringLength;
+				const char *scalar = TSEE_Scene_GetScalar(value, field->name, &stringLength);
+				char *string = scalar ? strndup(scalar, stringLength) : NULL;
+				TSEE_Field_SetString(&object, field, string);
+				if (string) xfree(string);
+				continue;
+			}
+			float number = field->fallback;
+			if (!TSEE_Scene_GetFloat(value, field->name, &number)) {
+				TSEE_Error("Scene object %d is invalid.\n", index);
+				success = false;
+			} else if (field->positive && !(number > 0)) {
+				TSEE_Error("Scene object %d is a %s object with a %s of %f, it must be greater than 0.\n", index, component->name, field->name, number);
+				success = false;
+			} else {
+				TSEE_Field_SetFloat(&object, field, number);
+			}
+		}
+	}
+	TSEE_Map_Object record;
+	memset(&record, 0, sizeof(record));
+	if (success) {
+		char *path = strndup(texture, length);
+		record.texture = TSEE_Map_AddTexture(snapshot, path);
+		xfree(path);
+		record.attributes = attributes;
+		record.x = position.x;
+		record.y = position.y;
+		success = TSEE_Map_SaveComponents(snapshot, &object, &record);
+	}
+	TSEE_Field_FreeStrings(&object);
+	if (success) {
+		TSEE_Map_AddObject(snapshot, &record);
+	}
+	return success;
+}
+
+/**
+ * @brief Compiles a YAML scene into a map. A scene looks like:
+ *
+ *        name: Level 1
+ *        author: Evie
+ *        version: "1.0"
+ *        description: The first level
+ *        gravity: [0, -9.81]
+ *        player: {speed: 10, jump_force: 25}
+ *        chunk_size: 512 # Optional, chunked maps stream in around the camera
+ *        objects:
+ *          - texture: assets/player.png
+ *            position: [200, 300]
+ *            attributes: [physics, player]
+ *            mass: 1
+ *            restitution: 0
+ *          - prefab: floor
+ *            position: [160, 30]
+ *        prefabs:
+ *          floor: {texture: assets/floor.png, attributes: [static]}
+ *
+ *        Parallax objects take a distance, text objects take their text. Objects that only differ by position,
+ *        whether or not they're written with a prefab, are saved as prefab instances, see TSEE_Map_FindPrefabs.
+ *
+ * @param source The scene's YAML.
+ * @param size Size of the YAML in bytes.
+ * @return TSEE_Map_Snapshot* The map, write it with TSEE_Map_WriteFile and free it with TSEE_Map_FreeSnapshot. NULL on fail.
+ */
+TSEE_Map_Snapshot *TSEE_Scene_Compile(const char *source, size_t size) {
+	struct fy_document *document = fy_document_build_from_string(NULL, source, size);
+	struct fy_node *root = document ? fy_document_root(document) : NULL;
+	if (!root || fy_node_get_type(root) != FYNT_MAPPING) {
+		TSEE_Error("Scene isn't a YAML mapping.\n");
+		if (document) fy_document_destroy(document);
+		return NULL;
+	}
+	struct fy_node *objects = fy_node_mapping_lookup_by_string(root, "objects", strlen("objects"));
+	if (objects && fy_node_get_type(objects) != FYNT_SEQUENCE) {
+		TSEE_Error("Scene's objects aren't a list.\n");
+		fy_document_destroy(document);
+		return NULL;
+	}
+	int count = objects ? fy_node_sequence_item_count(objects) : 0;
+	TSEE_Map_Snapshot *snapshot = TSEE_Map_CreateSnapshot(count);
+	if (!snapshot) {
+		fy_document_destroy(document);
+		return NULL;
+	}
+	snapshot->name = TSEE_Scene_AddString(snapshot, root, "name", "Untitled");
+	snapshot->author = TSEE_Scene_AddString(snapshot, root, "author", "");
+	snapshot->version = TSEE_Scene_AddString(snapshot, root, "version", "1.0");
+	snapshot->description = TSEE_Scene_AddString(snapshot, root, "description", "");
+	snapshot->player_speed = 1;
+	snapshot->player_jump_force = 1;
+	struct fy_node *player = fy_node_mapping_lookup_by_string(root, "player", strlen("player"));
+	bool success = TSEE_Scene_GetVec2(root, "gravity", &snapshot->gravity) && TSEE_Scene_GetFloat(root, "chunk_size", &snapshot->chunk_size);
+	if (success && player) {
+		if (fy_node_get_type(player) != FYNT_MAPPING) {
+			TSEE_Error("Scene's player isn't a mapping.\n");
+			success = false;
+		} else {
+			success = TSEE_Scene_GetFloat(player, "speed", &snapshot->player_speed) && TSEE_Scene_GetFloat(player, "jump_force", &snapshot->player_jump_force);
+		}
+	}
+	if (!(snapshot->chunk_size > 0)) {
+		snapshot->chunk_size = 0;
+	}
+	struct fy_node *prefabs = fy_node_mapping_lookup_by_string(root, "prefabs", strlen("prefabs"));
+	if (success && prefabs && fy_node_get_type(prefabs) != FYNT_MAPPING) {
+		TSEE_Error("Scene's prefabs aren't a mapping.\n");
+		success = false;
+	}
+	for (int i = 0; success && i < count; i++) {
+		success = TSEE_Scene_AddObject(snapshot, fy_node_sequence_get_by_index(objects, i), prefabs, i);
+	}
+	fy_document_destroy(document);
+	if (!success) {
+		TSEE_Map_FreeSnapshot(snapshot);
+		return NULL;
+	}
+	return snapshot;
+}
+
+/**
+ * @brief Compiles a YAML scene to a map, unless it's already been compiled. Compiled maps are cached next to the scene,
+ *        named after a hash of its contents, so editing the scene compiles it again and later runs skip parsing the YAML.
+ *        The hash is machine specific, so moving the cache between machines only costs a recompile.
+ *        Caches of older versions of the scene are left behind, they can be deleted at any time.
+ *        The scene can be a loose file or in a mounted archive, the cache is always written as a loose file.
+ *
+ * @param tsee TSEE object with the archives to read the scene from.
+ * @param path Path of the scene.
+ * @return char* Path of the compiled map, free it with xfree. NULL on fail.
+ */
+char *TSEE_Map_CompileScene(TSEE *tsee, const char *path) {
+	TSEE_MappedFile source;
+	if (!TSEE_Pak_Map(tsee, path, &source)) {
+		TSEE_Error("Failed to open scene `%s`\n", path);
+		return NULL;
+	}
+	// The map version is part of the key, so caches written in an older format are compiled again.
+	Uint64 hash = TSEE_Hash_Bytes(source.data, source.size, TSEE_MAP_VERSION);
+	size_t length = strlen(path) + 1 + 16 + sizeof(TSEE_SCENE_CACHE_SUFFIX);
+	char *cache = xmalloc(length);
+	if (!cache) {
+		TSEE_File_Unmap(&source);
+		return NULL;
+	}
+	snprintf(cache, length, "%s.%016llx%s", path, (unsigned long long)hash, TSEE_SCENE_CACHE_SUFFIX);
+	if (access(cache, R_OK) == 0) {
+		TSEE_File_Unmap(&source);
+		return cache;
+	}
+	Uint64 start = SDL_GetPerformanceCounter();
+	// Empty files have no data, they still go through the parser so they're reported like any other invalid scene.
+	TSEE_Map_Snapshot *snapshot = TSEE_Scene_Compile(source.data ? source.data : "", source.size);
+	TSEE_File_Unmap(&source);
+	// Written to a temporary file and renamed, so a cache is never partly written.
+	bool success = snapshot && TSEE_Map_WriteFile(snapshot, cache);
+	if (!success) {
+		TSEE_Error("Failed to compile scene `%s`\n", path);
+		if (snapshot) TSEE_Map_FreeSnapshot(snapshot);
+		xfree(cache);
+		return NULL;
+	}
+	TSEE_Log("Compiled scene `%s` with %zu objects to `%s` in %.3f ms.\n", path, snapshot->count, cache, (SDL_GetPerformanceCounter() - start) * 1000 / (double)SDL_GetPerformanceFrequency());
+	TSEE_Map_FreeSnapshot(snapshot);
+	return cache;
+}
+
+/**
+ * @brief Loads a YAML scene, compiling it first if it's changed since it was last compiled, see TSEE_Map_CompileScene.
+ *        The compiled map is loaded like any other.
+ *
+ * @param tsee TSEE object to load the scene into.
+ * @param path Path of the scene.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_LoadScene(TSEE *tsee, const char *path) {
+	char *map = TSEE_Map_CompileScene(tsee, path);
+	if (!map) {
+		return false;
+	}
+	bool success = TSEE_Map_Load(tsee, map);
+	xfree(map);
+	return success;
+}
@@ -0,0 +1,471 @@
+#include "../tsee.h"
+
+#define TSEE_MAPSTREAM_DEFAULT_LOAD_RADIUS 1
+#define TSEE_MAPSTREAM_DEFAULT_UNLOAD_RADIUS 2
+#define TSEE_MAPSTREAM_DEFAULT_BUDGET 2.0
+
+/**
+ * @brief Sets the size of the chunks maps are saved in. Objects in chunked maps are streamed in around the camera when loaded.
+ *
+ * @param tsee TSEE object to set it for.
+ * @param size Width and height of a chunk, 0 to save maps whole.
+ */
+void TSEE_Map_SetChunkSize(TSEE *tsee, float size) {
+	tsee->world->chunk_size = size > 0 ? size : 0;
+}
+
+/**
+ * @brief Starts streaming a chunked map's chunks, after the objects outside every chunk have been loaded.
+ *        Chunks are read from the map file on a background thread, or on the render thread if it can't be started.
+ *
+ * @param tsee TSEE object the map was loaded into.
+ * @param path Path of the map, it's mapped into memory while it streams.
+ * @param header The map's header.
+ * @param strings The map's strings, the stream takes them.
+ * @param texturePaths Path of each of the map's textures, pointing into the strings. The stream takes them.
+ * @param chunks The map's chunk table in host order, freed once it's copied.
+ * @return true on success, false on fail.
+ */
+bool TSEE_MapStream_Create(TSEE *tsee, const char *path, const TSEE_Map_Header *header, TSEE_Map_StringTable *strings, const char **texturePaths, TSEE_Map_Chunk *chunks) {
+	TSEE_MapStream *stream = xmalloc(sizeof(*stream));
+	if (!stream) {
+		xfree(chunks);
+		xfree(texturePaths);
+		TSEE_Map_FreeStrings(strings);
+		return false;
+	}
+	memset(stream, 0, sizeof(*stream));
+	stream->header = *header;
+	stream->strings = *strings;
+	strings->offsets = NULL;
+	strings->data = NULL;
+	stream->texture_paths = texturePaths;
+	stream->chunk_count = header->chunk_count;
+	stream->chunks = xmalloc(sizeof(*stream->chunks) * (stream->chunk_count ? stream->chunk_count : 1));
+	size_t textureCount = header->texture_count ? header->texture_count : 1;
+	stream->marks = xmalloc(sizeof(*stream->marks) * textureCount);
+	stream->assets = xmalloc(sizeof(*stream->assets) * textureCount);
+	stream->loaded = TSEE_Array_Create();
+	stream->load_radius = TSEE_MAPSTREAM_DEFAULT_LOAD_RADIUS;
+	stream->unload_radius = TSEE_MAPSTREAM_DEFAULT_UNLOAD_RADIUS;
+	stream->budget = TSEE_MAPSTREAM_DEFAULT_BUDGET;
+	tsee->world->stream = stream;
+	if (!stream->chunks || !stream->marks || !stream->assets) {
+		xfree(chunks);
+		TSEE_MapStream_Destroy(tsee);
+		return false;
+	}
+	memset(stream->marks, 0, sizeof(*stream->marks) * textureCount);
+	for (Uint32 i = 0; i < stream->chunk_count; i++) {
+		TSEE_MapStream_Chunk *chunk = &stream->chunks[i];
+		chunk->x = chunks[i].x;
+		chunk->y = chunks[i].y;
+		chunk->first_object = chunks[i].first_object;
+		chunk->object_count = chunks[i].object_count;
+		chunk->state = TSEE_MAPSTREAM_UNLOADED;
+		chunk->records = NULL;
+		chunk->next = NULL;
+	}
+	xfree(chunks);
+
+	if (!TSEE_Pak_Map(tsee, path, &stream->file) || stream->file.size < header->objects_offset
+		|| (stream->file.size - header->objects_offset) / sizeof(TSEE_Map_Object) < header->object_count) {
+		TSEE_Error("Couldn't map `%s` to stream its chunks.\n", path);
+		TSEE_MapStream_Destroy(tsee);
+		return false;
+	}
+	// The component data is before the objects, so it's inside the file too.
+	stream->components = (TSEE_Map_ComponentData){(Uint8 *)stream->file.data + header->components_offset, header->components_size};
+	stream->lock = SDL_CreateMutex();
+	stream->wake = SDL_CreateCond();
+	if (stream->lock && stream->wake) {
+		stream->thread = SDL_CreateThread(TSEE_MapStream_Thread, "TSEE_MapStream", stream);
+	}
+	if (!stream->thread) {
+		TSEE_Warn("Couldn't start the map stream thread (%s), chunks will be read on the render thread.\n", SDL_GetError());
+	}
+	TSEE_Log("Streaming %u chunks of %g units from %s\n", stream->chunk_count, header->chunk_size, path);
+	return true;
+}
+
+/**
+ * @brief Sets how far from the screen chunks are loaded and unloaded, in chunks.
+ *        Chunks between the two radii stay as they are, so moving back and forth over a chunk's edge doesn't reload it.
+ *
+ * @param tsee TSEE object with the streamed map.
+ * @param load Chunks this many chunks from the screen or closer are loaded.
+ * @param unload Chunks further than this are unloaded, at least the load radius.
+ */
+void TSEE_MapStream_SetRadius(TSEE *tsee, int load, int unload) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	if (!stream) return;
+	stream->load_radius = load > 0 ? load : 0;
+	stream->unload_radius = unload > stream->load_radius ? unload : stream->load_radius;
+	stream->view_valid = false;
+}
+
+/**
+ * @brief Finds the first chunk at or after a position in the chunk table's order.
+ *
+ * @param stream Stream to search.
+ * @param x Chunk x.
+ * @param y Chunk y.
+ * @return Uint32 Index of the chunk, chunk_count if every chunk is before it.
+ */
+Uint32 TSEE_MapStream_Find(TSEE_MapStream *stream, Sint32 x, Sint32 y) {
+	Uint32 low = 0;
+	Uint32 high = stream->chunk_count;
+	while (low < high) {
+		Uint32 middle = low + (high - low) / 2;
+		TSEE_MapStream_Chunk *chunk = &stream->chunks[middle];
+		if (chunk->y < y || (chunk->y == y && chunk->x < x)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @brief Finds the chunks the screen covers.
+ *
+ * @param tsee TSEE object with the streamed map.
+ * @return SDL_Rect The first chunk covered and how many chunks across and up are covered.
+ */
+SDL_Rect TSEE_MapStream_GetView(TSEE *tsee) {
+	float size = tsee->world->stream->header.chunk_size;
+	// Objects are drawn at their x minus scroll_x, and their y flipped then moved down by scroll_y.
+	float left = tsee->world->scroll_x;
+	float bottom = -tsee->world->scroll_y;
+	Sint32 x = TSEE_Map_ChunkCoordinate(left, size);
+	Sint32 y = TSEE_Map_ChunkCoordinate(bottom, size);
+	Sint32 right = TSEE_Map_ChunkCoordinate(left + tsee->window->width, size);
+	Sint32 top = TSEE_Map_ChunkCoordinate(bottom + tsee->window->height, size);
+	return (SDL_Rect){x, y, right - x + 1, top - y + 1};
+}
+
+/**
+ * @brief Finds how many chunks away from the screen a chunk is.
+ *
+ * @param chunk Chunk to measure.
+ * @param view Chunks the screen covers, from TSEE_MapStream_GetView.
+ * @return Sint64 Distance in chunks along the furthest axis, 0 if it's on screen.
+ */
+Sint64 TSEE_MapStream_Distance(const TSEE_MapStream_Chunk *chunk, const SDL_Rect *view) {
+	Sint64 right = (Sint64)view->x + view->w - 1;
+	Sint64 top = (Sint64)view->y + view->h - 1;
+	Sint64 dx = chunk->x < view->x ? (Sint64)view->x - chunk->x : (chunk->x > right ? chunk->x - right : 0);
+	Sint64 dy = chunk->y < view->y ? (Sint64)view->y - chunk->y : (chunk->y > top ? chunk->y - top : 0);
+	return dx > dy ? dx : dy;
+}
+
+/**
+ * @brief Copies a chunk's object records out of the mapped map, converting them to host order.
+ *        Run by the stream thread, it only touches the chunk and the mapped file.
+ *
+ * @param stream Stream the chunk is in.
+ * @param chunk Chunk to read.
+ * @return true on success, false on fail.
+ */
+bool TSEE_MapStream_ReadChunk(TSEE_MapStream *stream, TSEE_MapStream_Chunk *chunk) {
+	chunk->records = xmalloc(sizeof(*chunk->records) * (chunk->object_count ? chunk->object_count : 1));
+	if (!chunk->records) {
+		return false;
+	}
+	const Uint8 *data = (const Uint8 *)stream->file.data + stream->header.objects_offset + chunk->first_object * sizeof(TSEE_Map_Object);
+	memcpy(chunk->records, data, sizeof(*chunk->records) * chunk->object_count);
+	for (Uint64 i = 0; i < chunk->object_count; i++) {
+		TSEE_Map_SwapObject(&chunk->records[i]);
+	}
+	return true;
+}
+
+/**
+ * @brief Reads queued chunks until the stream is destroyed, DO NOT CALL.
+ *
+ * @param data The TSEE_MapStream.
+ * @return int 0
+ */
+int TSEE_MapStream_Thread(void *data) {
+	TSEE_MapStream *stream = data;
+	SDL_LockMutex(stream->lock);
+	while (!stream->quit) {
+		TSEE_MapStream_Chunk *chunk = stream->queued;
+		if (!chunk) {
+			SDL_CondWait(stream->wake, stream->lock);
+			continue;
+		}
+		stream->queued = chunk->next;
+		if (!stream->queued) stream->queued_tail = NULL;
+		SDL_UnlockMutex(stream->lock);
+
+		TSEE_MapStream_ReadChunk(stream, chunk);
+
+		SDL_LockMutex(stream->lock);
+		chunk->next = NULL;
+		if (stream->read_tail) stream->read_tail->next = chunk;
+		else stream->read = chunk;
+		stream->read_tail = chunk;
+	}
+	SDL_UnlockMutex(stream->lock);
+	return 0;
+}
+
+/**
+ * @brief Queues the chunks near the screen that aren't loaded, in one batch for the stream thread.
+ *
+ * @param tsee TSEE object with the streamed map.
+ */
+void TSEE_MapStream_QueueNearby(TSEE *tsee) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	TSEE_MapStream_Chunk *first = NULL;
+	TSEE_MapStream_Chunk *last = NULL;
+	// Chunk coordinates are clamped to 32 bits, so the range is too.
+	Sint64 left = (Sint64)stream->view.x - stream->load_radius;
+	Sint64 right = (Sint64)stream->view.x + stream->view.w - 1 + stream->load_radius;
+	Sint64 bottom = (Sint64)stream->view.y - stream->load_radius;
+	Sint64 top = (Sint64)stream->view.y + stream->view.h - 1 + stream->load_radius;
+	if (left < INT32_MIN) left = INT32_MIN;
+	if (bottom < INT32_MIN) bottom = INT32_MIN;
+	if (top > INT32_MAX) top = INT32_MAX;
+	for (Sint64 y = bottom; y <= top; y++) {
+		// Chunks are sorted by y then x, so each row's chunks in range follow each other.
+		for (Uint32 i = TSEE_MapStream_Find(stream, (Sint32)left, (Sint32)y); i < stream->chunk_count; i++) {
+			TSEE_MapStream_Chunk *chunk = &stream->chunks[i];
+			if (chunk->y != y || chunk->x > right) break;
+			if (chunk->state != TSEE_MAPSTREAM_UNLOADED) continue;
+			chunk->state = TSEE_MAPSTREAM_QUEUED;
+			chunk->next = NULL;
+			if (!stream->thread) {
+				// Read now, then it's treated as if the thread had read it.
+				TSEE_MapStream_ReadChunk(stream, chunk);
+			}
+			if (last) last->next = chunk;
+			else first = chunk;
+			last = chunk;
+		}
+	}
+	if (!first) return;
+	if (!stream->thread) {
+		if (stream->ready_tail) stream->ready_tail->next = first;
+		else stream->ready = first;
+		stream->ready_tail = last;
+		return;
+	}
+	SDL_LockMutex(stream->lock);
+	if (stream->queued_tail) stream->queued_tail->next = first;
+	else stream->queued = first;
+	stream->queued_tail = last;
+	SDL_CondSignal(stream->wake);
+	SDL_UnlockMutex(stream->lock);
+}
+
+/**
+ * @brief Creates a read chunk's objects, pinning their textures. Textures that aren't loaded are loaded on the loader's threads.
+ *
+ * @param tsee TSEE object with the streamed map.
+ * @param chunk Chunk to create the objects of.
+ */
+void TSEE_MapStream_Place(TSEE *tsee, TSEE_MapStream_Chunk *chunk) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	if (!chunk->records) {
+		TSEE_Error("Couldn't read chunk (%d, %d) of the map.\n", chunk->x, chunk->y);
+		chunk->state = TSEE_MAPSTREAM_UNLOADED;
+		return;
+	}
+	// Marks which textures have been used by this chunk, so each is only looked up once.
+	Uint32 mark = ++stream->placements;
+	if (mark == 0) {
+		memset(stream->marks, 0, sizeof(*stream->marks) * (stream->header.texture_count ? stream->header.texture_count : 1));
+		mark = ++stream->placements;
+	}
+	TSEE_Array_Reserve(tsee->world->objects, tsee->world->objects->size + chunk->object_count);
+	TSEE_Array_Reserve(tsee->textures, tsee->textures->size + chunk->object_count);
+	size_t skipped = 0;
+	size_t invalid = 0;
+	for (Uint64 i = 0; i < chunk->object_count; i++) {
+		TSEE_Map_Object *record = &chunk->records[i];
+		if (record->texture >= stream->header.texture_count) {
+			invalid++;
+			continue;
+		}
+		TSEE_Texture *texture = NULL;
+		if (stream->marks[record->texture] != mark) {
+			stream->marks[record->texture] = mark;
+			texture = TSEE_Texture_CreateAsync(tsee, (char *)stream->texture_paths[record->texture], NULL, NULL);
+			stream->assets[record->texture] = texture ? texture->asset : NULL;
+		} else if (stream->assets[record->texture]) {
+			texture = TSEE_Texture_CreateFromAsset(tsee, stream->assets[record->texture]);
+		}
+		if (!texture) {
+			skipped++;
+			continue;
+		}
+		TSEE_Object *object = TSEE_Map_CreateObject(tsee, record, texture, &stream->components, &stream->strings);
+		if (!object) {
+			if (texture->asset && texture->asset->users->size == 1) {
+				// Destroying the texture destroys the asset too.
+				stream->marks[record->texture] = 0;
+			}
+			TSEE_Texture_Destroy(tsee, texture);
+			invalid++;
+			continue;
+		}
+		object->chunk = chunk;
+		if (texture->asset) {
+			TSEE_TextureCache_Pin(tsee, texture->asset);
+		}
+	}
+	if (skipped > 0) {
+		TSEE_Warn("Skipped %zu objects in chunk (%d, %d) with textures that couldn't be loaded.\n", skipped, chunk->x, chunk->y);
+	}
+	if (invalid > 0) {
+		TSEE_Warn("Skipped %zu invalid objects in chunk (%d, %d).\n", invalid, chunk->x, chunk->y);
+	}
+	xfree(chunk->records);
+	chunk->records = NULL;
+	chunk->state = TSEE_MAPSTREAM_LOADED;
+	TSEE_Array_Append(stream->loaded, chunk);
+}
+
+/**
+ * @brief Destroys the objects of every chunk being unloaded, unpinning their textures.
+ *        The world's objects and textures are each compacted in one pass, however many objects are unloaded.
+ *
+ * @param tsee TSEE object with the streamed map.
+ */
+void TSEE_MapStream_Unload(TSEE *tsee) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	TSEE_Array *objects = tsee->world->objects;
+	TSEE_Array *textures = TSEE_Array_Create();
+	size_t kept = 0;
+	for (size_t i = 0; i < objects->size; i++) {
+		TSEE_Object *object = objects->data[i];
+		if (!object->chunk || object->chunk->state != TSEE_MAPSTREAM_UNLOADING) {
+			objects->data[kept++] = object;
+			continue;
+		}
+		if (object->texture->asset) {
+			TSEE_TextureCache_Unpin(tsee, object->texture->asset);
+		}
+		if (TSEE_Physics_IsStaticCollider(object)) {
+			tsee->world->colliders_valid = false;
+		}
+		TSEE_Array_Append(textures, object->texture);
+		TSEE_Object_Destroy(tsee, object, false);
+	}
+	objects->size = kept;
+	TSEE_Texture_DestroyBatch(tsee, (TSEE_Texture **)textures->data, textures->size);
+	TSEE_Array_Destroy(textures);
+
+	kept = 0;
+	for (size_t i = 0; i < stream->loaded->size; i++) {
+		TSEE_MapStream_Chunk *chunk = stream->loaded->data[i];
+		if (chunk->state == TSEE_MAPSTREAM_UNLOADING) {
+			chunk->state = TSEE_MAPSTREAM_UNLOADED;
+		} else {
+			stream->loaded->data[kept++] = chunk;
+		}
+	}
+	stream->loaded->size = kept;
+}
+
+/**
+ * @brief Loads chunks coming near the screen and unloads ones that have moved away, called once a frame by TSEE_RenderAll.
+ *        Read chunks have their objects created until the frame's budget is used, at least one a frame.
+ *
+ * @param tsee TSEE object with the streamed map.
+ */
+void TSEE_MapStream_Update(TSEE *tsee) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	if (!stream) return;
+	SDL_Rect view = TSEE_MapStream_GetView(tsee);
+	if (!stream->view_valid || view.x != stream->view.x || view.y != stream->view.y || view.w != stream->view.w || view.h != stream->view.h) {
+		stream->view = view;
+		stream->view_valid = true;
+		TSEE_MapStream_QueueNearby(tsee);
+		bool unload = false;
+		for (size_t i = 0; i < stream->loaded->size; i++) {
+			TSEE_MapStream_Chunk *chunk = stream->loaded->data[i];
+			if (TSEE_MapStream_Distance(chunk, &view) > stream->unload_radius) {
+				chunk->state = TSEE_MAPSTREAM_UNLOADING;
+				unload = true;
+			}
+		}
+		if (unload) {
+			TSEE_MapStream_Unload(tsee);
+		}
+	}
+
+	if (stream->thread) {
+		SDL_LockMutex(stream->lock);
+		if (stream->read) {
+			if (stream->ready_tail) stream->ready_tail->next = stream->read;
+			else stream->ready = stream->read;
+			stream->ready_tail = stream->read_tail;
+			stream->read = NULL;
+			stream->read_tail = NULL;
+		}
+		SDL_UnlockMutex(stream->lock);
+	}
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = stream->budget * SDL_GetPerformanceFrequency() / 1000;
+	while (stream->ready) {
+		TSEE_MapStream_Chunk *chunk = stream->ready;
+		stream->ready = chunk->next;
+		if (!stream->ready) stream->ready_tail = NULL;
+		chunk->next = NULL;
+		// The camera may have moved on while it was read.
+		if (TSEE_MapStream_Distance(chunk, &view) > stream->unload_radius) {
+			if (chunk->records) xfree(chunk->records);
+			chunk->records = NULL;
+			chunk->state = TSEE_MAPSTREAM_UNLOADED;
+		} else {
+			TSEE_MapStream_Place(tsee, chunk);
+		}
+		if (SDL_GetPerformanceCounter() - start >= budget) break;
+	}
+}
+
+/**
+ * @brief Stops streaming the loaded map. Objects already loaded stay in the world, they're just no longer unloaded.
+ *
+ * @param tsee TSEE object with the streamed map.
+ */
+void TSEE_MapStream_Destroy(TSEE *tsee) {
+	TSEE_MapStream *stream = tsee->world->stream;
+	if (!stream) return;
+	if (stream->thread) {
+		SDL_LockMutex(stream->lock);
+		stream->quit = true;
+		SDL_CondSignal(stream->wake);
+		SDL_UnlockMutex(stream->lock);
+		SDL_WaitThread(stream->thread, NULL);
+	}
+	for (size_t i = 0; i < tsee->world->objects->size; i++) {
+		TSEE_Object *object = tsee->world->objects->data[i];
+		if (!object->chunk) continue;
+		if (object->texture->asset) {
+			TSEE_TextureCache_Unpin(tsee, object->texture->asset);
+		}
+		object->chunk = NULL;
+	}
+	if (stream->chunks) {
+		for (Uint32 i = 0; i < stream->chunk_count; i++) {
+			if (stream->chunks[i].records) xfree(stream->chunks[i].records);
+		}
+		xfree(stream->chunks);
+	}
+	if (stream->lock) SDL_DestroyMutex(stream->lock);
+	if (stream->wake) SDL_DestroyCond(stream->wake);
+	TSEE_File_Unmap(&stream->file);
+	TSEE_Map_FreeStrings(&stream->strings);
+	xfree(stream->texture_paths);
+	if (stream->marks) xfree(stream->marks);
+	if (stream->assets) xfree(stream->assets);
+	TSEE_Array_Destroy(stream->loaded);
+	xfree(stream);
+	tsee->world->stream = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#define TSEE_MAP_MAGIC "TSEEMAP"
+#define TSEE_MAP_ZLIB_MAGIC "TSEEMAPZ" // Starts a compressed map, followed by the map compressed with zlib
+#define TSEE_MAP_VERSION 3
+#define TSEE_MAP_ALIGNMENT 8
+#define TSEE_MAP_NO_PREFAB 0xFFFFFFFF
+#define TSEE_MAP_FLAG_MORTON (1 << 0) // Each run of objects and instances is in Morton order, see TSEE_Map_SortObjects
+
+// Header at the start of a v2 map. All map fields are little endian, floats included.
+// Sections are aligned to TSEE_MAP_ALIGNMENT so they can be read in place from a mapped file.
+typedef struct TSEE_Map_Header {
+	char magic[8];
+	Uint32 version;
+	Uint32 header_size; // sizeof(TSEE_Map_Header) when written, so fields can be added later
+	Uint32 name; // String indices
+	Uint32 author;
+	Uint32 map_version;
+	Uint32 description;
+	float gravity_x;
+	float gravity_y;
+	float player_speed;
+	float player_jump_force;
+	Uint32 string_count;
+	Uint32 texture_count;
+	Uint64 object_count;
+	Uint64 strings_offset; // Uint32 offset into the string data per string
+	Uint64 string_data_offset; // NUL terminated strings
+	Uint64 string_data_size;
+	Uint64 textures_offset; // Uint32 string index of each texture's path
+	Uint64 objects_offset; // TSEE_Map_Object per object
+	// Only in headers at least this big, maps saved before chunking stop at chunk_size.
+	float chunk_size; // Width and height of a chunk, 0 if the map isn't chunked
+	Uint32 chunk_count;
+	Uint64 chunks_offset; // TSEE_Map_Chunk per chunk, sorted by y then x
+	// Only in headers at least this big, maps saved before prefabs stop at prefab_count.
+	Uint32 prefab_count;
+	Uint32 flags; // TSEE_MAP_FLAG_*
+	Uint64 instance_count;
+	Uint64 prefabs_offset; // TSEE_Map_Prefab per prefab, after the objects
+	Uint64 instances_offset; // TSEE_Map_Instance per instance, grouped by prefab
+	// Only in headers at least this big, maps saved before component data have none.
+	Uint64 components_offset; // Component fields of the objects and prefabs, between the chunks and the objects, see TSEE_Map_ComponentData
+	Uint64 components_size;
+} TSEE_Map_Header;
+
+// An object in a v2 map.
+typedef struct TSEE_Map_Object {
+	Uint32 texture; // Index into the map's textures
+	Uint32 attributes; // TSEE_Object_Attributes
+	float x;
+	float y;
+	Uint64 components; // Offset of its component fields in the map's component data
+	Uint64 reserved;
+} TSEE_Map_Object;
+
+// Objects in a map that only differ by position, stored once and created in bulk.
+typedef struct TSEE_Map_Prefab {
+	Uint32 texture; // Index into the map's textures
+	Uint32 attributes; // TSEE_Object_Attributes, never a player, parallax or text object
+	Uint64 components; // Offset of its component fields in the map's component data, shared by every instance
+	Uint64 first_instance; // The prefab's instances are a run of the map's instances
+	Uint64 instance_count;
+} TSEE_Map_Prefab;
+
+// An instance of a prefab in a map, the prefab is whichever one's run it's in.
+typedef struct TSEE_Map_Instance {
+	float x;
+	float y;
+} TSEE_Map_Instance;
+
+// A square of a chunked map, holding the objects saved inside it.
+// Objects before the first chunk's aren't in any chunk, they're loaded with the map and never unloaded.
+typedef struct TSEE_Map_Chunk {
+	Sint32 x; // Position in chunks, the chunk covers x * chunk_size up to (x + 1) * chunk_size
+	Sint32 y;
+	Uint64 first_object;
+	Uint64 object_count;
+} TSEE_Map_Chunk;
+
+// The component fields of a map's objects and prefabs. Each one's fields are a run of 4 byte little endian words,
+// the fields of every component its attributes give it in the order of the component table, see TSEE_Component_GetAll.
+// Float fields are stored as they are, string fields as string indices.
+typedef struct TSEE_Map_ComponentData {
+	Uint8 *data; // Read into memory, or pointing into a streamed map's mapped file
+	Uint64 size;
+} TSEE_Map_ComponentData;
+
+// A map file opened to read, decompressed as it's read if it's compressed.
+typedef struct TSEE_Map_File {
+	TSEE_Stream file; // The mapped file
+	TSEE_Stream zlib; // Decompresses the file, only opened if it's compressed
+	TSEE_Stream *stream; // Whichever one the map is read from
+	bool compressed;
+} TSEE_Map_File;
+
+// A v2 map's strings, read into memory while it loads.
+typedef struct TSEE_Map_StringTable {
+	Uint32 *offsets;
+	char *data;
+	Uint32 count;
+	Uint64 size;
+} TSEE_Map_StringTable;
+
+// A map's strings while it's being saved, each string is only stored once.
+typedef struct TSEE_Map_Strings {
+	TSEE_HashMap *indices; // String -> index + 1
+	TSEE_Array *strings; // Copies of the strings
+	size_t size; // Bytes of string data
+} TSEE_Map_Strings;
+
+// An object being saved, with the chunk it's saved in.
+typedef struct TSEE_Map_SaveObject {
+	TSEE_Map_Object record; // In host order, its components are an index into the snapshot's components until it's written
+	Sint32 chunk_x;
+	Sint32 chunk_y;
+	bool chunked; // False for objects that are never unloaded
+	bool spatial; // False for players, parallax backgrounds and UI, which keep the order they were added in
+	Uint64 morton; // Morton code of its position in its chunk, or in the square around every unchunked object
+	Uint32 prefab; // Prefab it's saved as an instance of, TSEE_MAP_NO_PREFAB if it's saved whole
+	size_t order; // Order it was added in, keeps the save stable
+} TSEE_Map_SaveObject;
+
+// Everything a map saves, copied out of the world so it can be written on another thread.
+typedef struct TSEE_Map_Snapshot {
+	TSEE_Map_Strings strings;
+	TSEE_Array *textures; // String index of each texture's path
+	TSEE_HashMap *texture_indices; // Texture path -> index + 1
+	TSEE_Map_SaveObject *objects;
+	size_t count;
+	Uint32 *components; // Component fields of every object in host order, see TSEE_Map_SaveComponents
+	size_t component_count;
+	size_t component_capacity;
+	Uint32 name; // String indices
+	Uint32 author;
+	Uint32 version;
+	Uint32 description;
+	TSEE_Vec2 gravity;
+	float player_speed;
+	float player_jump_force;
+	float chunk_size; // 0 if the map is saved whole
+	bool compressed; // Written compressed with zlib
+} TSEE_Map_Snapshot;
+
+// Called on the render thread once a background map save finishes.
+typedef void (*TSEE_Map_SaveCallback)(void *tsee, bool success, void *userdata);
+
+// A map being written by a background thread, from a snapshot of the world.
+typedef struct TSEE_MapSave {
+	TSEE_Map_Snapshot *snapshot;
+	char *path;
+	TSEE_Map_SaveCallback callback;
+	void *userdata;
+	SDL_Thread *thread; // NULL if it was written on the render thread
+	SDL_atomic_t done; // Set by the save thread once the file is written, success is then the render thread's
+	bool success;
+	Uint64 start;
+} TSEE_MapSave;
+
+// Where a chunk of a streamed map is up to.
+typedef enum TSEE_MapStream_State {
+	TSEE_MAPSTREAM_UNLOADED,
+	TSEE_MAPSTREAM_QUEUED, // Waiting for or being read by the stream thread
+	TSEE_MAPSTREAM_READ, // Records read, waiting for its objects to be created
+	TSEE_MAPSTREAM_LOADED,
+	TSEE_MAPSTREAM_UNLOADING, // Its objects are about to be destroyed
+} TSEE_MapStream_State;
+
+// A chunk of a streamed map.
+typedef struct TSEE_MapStream_Chunk {
+	Sint32 x;
+	Sint32 y;
+	Uint64 first_object;
+	Uint64 object_count;
+	TSEE_MapStream_State state; // Only touched by the render thread
+	TSEE_Map_Object *records; // Read by the stream thread in host order, freed once the objects are created
+	struct TSEE_MapStream_Chunk *next; // In the queue it's waiting in
+} TSEE_MapStream_Chunk;
+
+// A chunked map whose chunks are loaded around the camera by a background thread, and unloaded once it moves away.
+// Textures used by loaded chunks are pinned, so the texture cache doesn't evict them while they're nearby but off screen.
+typedef struct TSEE_MapStream {
+	TSEE_MappedFile file; // The map, chunks are read from it directly
+	TSEE_Map_Header header;
+	TSEE_Map_StringTable strings;
+	const char **texture_paths; // Point into the strings
+	TSEE_Map_ComponentData components; // Points into the mapped file
+	TSEE_MapStream_Chunk *chunks; // Sorted by y then x, like the map's chunk table
+	Uint32 chunk_count;
+	Uint32 *marks; // Per texture, the placement that last used it
+	TSEE_Texture_Asset **assets; // Per texture, its asset as of the placement in marks
+	Uint32 placements; // Chunks placed so far
+	TSEE_Array *loaded; // Chunks with objects in the world
+	int load_radius; // Chunks this far from the screen are loaded
+	int unload_radius; // Chunks further than this from the screen are unloaded
+	SDL_Rect view; // Chunks the screen covered when chunks were last queued
+	bool view_valid;
+	double budget; // Milliseconds per frame spent creating objects
+	SDL_Thread *thread; // NULL if chunks are read on the render thread
+	SDL_mutex *lock;
+	SDL_cond *wake;
+	TSEE_MapStream_Chunk *queued; // Waiting for the stream thread, oldest first
+	TSEE_MapStream_Chunk *queued_tail;
+	TSEE_MapStream_Chunk *read; // Read by the stream thread, oldest first
+	TSEE_MapStream_Chunk *read_tail;
+	TSEE_MapStream_Chunk *ready; // Taken from read, only touched by the render thread
+	TSEE_MapStream_Chunk *ready_tail;
+	bool quit;
+} TSEE_MapStream;
+
+// Where an asynchronous map load is up to.
+typedef enum TSEE_MapLoad_State {
+	TSEE_MAPLOAD_PARSING, // The load thread is reading the map
+	TSEE_MAPLOAD_TEXTURES, // Waiting for the loader to decode the map's textures
+	TSEE_MAPLOAD_BUILDING, // Creating the objects in the staged world, a batch a frame
+	TSEE_MAPLOAD_TEARDOWN, // Swapped in, the old world is destroyed a batch a frame
+} TSEE_MapLoad_State;
+
+// Called on the render thread once an asynchronous map load finishes, after the new world is swapped in on success.
+typedef void (*TSEE_Map_LoadCallback)(void *tsee, bool success, void *userdata);
+
+// A map being loaded in the background into a staged world, which replaces the current one once it's built.
+// The current world keeps being updated and drawn until then.
+typedef struct TSEE_MapLoad {
+	void *tsee; // For the load thread to open the map with
+	char *path;
+	TSEE_MapLoad_State state;
+	TSEE_Map_LoadCallback callback;
+	void *userdata;
+	SDL_Thread *thread; // NULL once joined, or if the map was read on the render thread
+	SDL_atomic_t read; // Thousandths of the records read by the load thread
+	SDL_atomic_t done; // Set by the load thread once it's finished, the fields below are then the render thread's
+	bool parsed; // The load thread read the map successfully
+	bool legacy; // The map isn't v2, so it's staged with TSEE_Map_LoadV1 on the render thread instead
+	TSEE_Map_Header header;
+	TSEE_Map_StringTable strings;
+	const char **texture_paths; // Point into the strings
+	bool *used; // Per texture, whether a record being loaded uses it
+	Uint32 textures_used;
+	Uint32 textures_ready; // Used textures the loader has finished with
+	bool pinned; // The used textures are pinned until the staged world is swapped in
+	TSEE_Map_Chunk *chunks; // NULL unless the map is chunked
+	TSEE_Map_ComponentData components;
+	TSEE_Map_Object *records; // The objects loaded with the map in host order, those outside every chunk if it's chunked
+	Uint64 record_count;
+	TSEE_Map_Prefab *prefabs; // In host order, NULL if the map has none
+	TSEE_Vec2 *instances;
+	Uint64 instance_count;
+	Uint32 prefab; // Prefab being instantiated once every record is built
+	Uint64 prefab_built; // Its instances created so far
+	TSEE_Prefab current; // Set up when its first instances are created, no asset if its texture couldn't be loaded
+	Uint64 built; // Records and instances turned into objects so far
+	size_t skipped; // Objects whose textures couldn't be loaded
+	size_t invalid; // Objects that couldn't be created, see TSEE_Map_CreateObject
+	TSEE_Texture **textures; // Per texture, the first texture created for it
+	bool *tried;
+	struct TSEE_World *world; // Staged world, or the old world while it's torn down
+	struct TSEE_Player *player; // Staged player
+	double budget; // Milliseconds per frame spent creating objects
+	Uint64 start;
+} TSEE_MapLoad;
@@ -0,0 +1,1172 @@
+#include "../tsee.h"
+
+#define TSEE_MAP_RECORD_BATCH 256
+#define TSEE_MAP_PREFAB_MIN_INSTANCES 2
+
+/**
+ * @brief Checks if a stream holds a v2 map, without reading past the magic.
+ *
+ * @param stream Stream to check.
+ * @return true if it starts with the map magic, false otherwise.
+ */
+bool TSEE_Map_IsV2(TSEE_Stream *stream) {
+	const void *magic = TSEE_Stream_Peek(stream, sizeof(((TSEE_Map_Header *)0)->magic));
+	return magic && memcmp(magic, TSEE_MAP_MAGIC, sizeof(((TSEE_Map_Header *)0)->magic)) == 0;
+}
+
+/**
+ * @brief Skips ahead to a section of a map. Sections are always stored in order.
+ *
+ * @param stream Stream the map is being read from.
+ * @param offset Offset of the section.
+ * @return true on success, false if the section is behind the stream or past its end.
+ */
+bool TSEE_Map_SkipTo(TSEE_Stream *stream, Uint64 offset) {
+	Uint64 position = TSEE_Stream_Tell(stream);
+	if (offset < position) {
+		TSEE_Error("Map sections are out of order.\n");
+		return false;
+	}
+	return TSEE_Stream_Skip(stream, offset - position);
+}
+
+/**
+ * @brief Reads a v2 map's header, checking its sections are in order.
+ *
+ * @param stream Stream to read from.
+ * @param header Header to fill in.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_ReadHeader(TSEE_Stream *stream, TSEE_Map_Header *header) {
+	TSEE_Stream_Read(stream, header->magic, sizeof(header->magic));
+	TSEE_Stream_ReadU32(stream, &header->version);
+	TSEE_Stream_ReadU32(stream, &header->header_size);
+	TSEE_Stream_ReadU32(stream, &header->name);
+	TSEE_Stream_ReadU32(stream, &header->author);
+	TSEE_Stream_ReadU32(stream, &header->map_version);
+	TSEE_Stream_ReadU32(stream, &header->description);
+	TSEE_Stream_ReadF32(stream, &header->gravity_x);
+	TSEE_Stream_ReadF32(stream, &header->gravity_y);
+	TSEE_Stream_ReadF32(stream, &header->player_speed);
+	TSEE_Stream_ReadF32(stream, &header->player_jump_force);
+	TSEE_Stream_ReadU32(stream, &header->string_count);
+	TSEE_Stream_ReadU32(stream, &header->texture_count);
+	TSEE_Stream_ReadU64(stream, &header->object_count);
+	TSEE_Stream_ReadU64(stream, &header->strings_offset);
+	TSEE_Stream_ReadU64(stream, &header->string_data_offset);
+	TSEE_Stream_ReadU64(stream, &header->string_data_size);
+	TSEE_Stream_ReadU64(stream, &header->textures_offset);
+	TSEE_Stream_ReadU64(stream, &header->objects_offset);
+	header->chunk_size = 0;
+	header->chunk_count = 0;
+	header->chunks_offset = header->objects_offset;
+	if (header->header_size >= offsetof(TSEE_Map_Header, prefab_count)) {
+		TSEE_Stream_ReadF32(stream, &header->chunk_size);
+		TSEE_Stream_ReadU32(stream, &header->chunk_count);
+		TSEE_Stream_ReadU64(stream, &header->chunks_offset);
+	}
+	header->prefab_count = 0;
+	header->flags = 0;
+	header->instance_count = 0;
+	header->prefabs_offset = header->objects_offset + header->object_count * sizeof(TSEE_Map_Object);
+	header->instances_offset = header->prefabs_offset;
+	if (header->header_size >= offsetof(TSEE_Map_Header, components_offset)) {
+		TSEE_Stream_ReadU32(stream, &header->prefab_count);
+		TSEE_Stream_ReadU32(stream, &header->flags);
+		TSEE_Stream_ReadU64(stream, &header->instance_count);
+		TSEE_Stream_ReadU64(stream, &header->prefabs_offset);
+		TSEE_Stream_ReadU64(stream, &header->instances_offset);
+	}
+	header->components_offset = header->objects_offset;
+	header->components_size = 0;
+	if (header->header_size >= sizeof(*header)) {
+		TSEE_Stream_ReadU64(stream, &header->components_offset);
+		TSEE_Stream_ReadU64(stream, &header->components_size);
+	}
+	if (stream->failed) {
+		TSEE_Error("Map is too small for its header.\n");
+		return false;
+	}
+	if (header->version != TSEE_MAP_VERSION) {
+		TSEE_Error("Map is version %u, only version %u is supported.\n", header->version, TSEE_MAP_VERSION);
+		return false;
+	}
+	if (header->header_size < offsetof(TSEE_Map_Header, chunk_size) || header->string_data_size > UINT32_MAX
+		|| header->strings_offset < header->header_size
+		|| header->string_data_offset < header->strings_offset + (Uint64)header->string_count * sizeof(Uint32)
+		|| header->textures_offset < header->string_data_offset + header->string_data_size
+		|| header->chunks_offset < header->textures_offset + (Uint64)header->texture_count * sizeof(Uint32)
+		|| header->components_offset < header->chunks_offset + (Uint64)header->chunk_count * sizeof(TSEE_Map_Chunk)
+		|| header->components_size > SIZE_MAX || header->components_size > UINT64_MAX - header->components_offset
+		|| header->objects_offset < header->components_offset + header->components_size
+		|| header->object_count > (UINT64_MAX - header->objects_offset) / sizeof(TSEE_Map_Object)
+		|| header->prefabs_offset < header->objects_offset + header->object_count * sizeof(TSEE_Map_Object)
+		|| header->instances_offset < header->prefabs_offset + (Uint64)header->prefab_count * sizeof(TSEE_Map_Prefab)
+		|| header->instance_count > SIZE_MAX / sizeof(TSEE_Map_Instance)) {
+		TSEE_Error("Map has overlapping sections.\n");
+		return false;
+	}
+	if (header->chunk_count > 0 && !(header->chunk_size > 0)) {
+		TSEE_Error("Map has chunks with no size.\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Reads a chunked map's chunk table, checking the chunks are sorted and hold the map's objects.
+ *
+ * @param stream Stream to read from, before the chunk table.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @return TSEE_Map_Chunk* in host order, free it with xfree. NULL on fail.
+ */
+TSEE_Map_Chunk *TSEE_Map_ReadChunks(TSEE_Stream *stream, const TSEE_Map_Header *header) {
+	TSEE_Map_Chunk *chunks = xmalloc(sizeof(*chunks) * (header->chunk_count ? header->chunk_count : 1));
+	if (!chunks || !TSEE_Map_SkipTo(stream, header->chunks_offset)) {
+		if (chunks) xfree(chunks);
+		return NULL;
+	}
+	Uint64 end = 0;
+	for (Uint32 i = 0; i < header->chunk_count; i++) {
+		TSEE_Map_Chunk *chunk = &chunks[i];
+		TSEE_Stream_ReadU32(stream, (Uint32 *)&chunk->x);
+		TSEE_Stream_ReadU32(stream, (Uint32 *)&chunk->y);
+		TSEE_Stream_ReadU64(stream, &chunk->first_object);
+		TSEE_Stream_ReadU64(stream, &chunk->object_count);
+		bool sorted = i == 0 || chunk->y > chunks[i - 1].y || (chunk->y == chunks[i - 1].y && chunk->x > chunks[i - 1].x);
+		if (stream->failed || !sorted || chunk->first_object < end || chunk->first_object > header->object_count || chunk->object_count > header->object_count - chunk->first_object) {
+			TSEE_Error("Map's chunk table is invalid at chunk %u.\n", i);
+			xfree(chunks);
+			return NULL;
+		}
+		end = chunk->first_object + chunk->object_count;
+	}
+	return chunks;
+}
+
+/**
+ * @brief Reads a map's prefab table, checking each prefab's instances are in the map.
+ *
+ * @param stream Stream to read from, before the prefab table.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @return TSEE_Map_Prefab* in host order, free it with xfree. NULL on fail.
+ */
+TSEE_Map_Prefab *TSEE_Map_ReadPrefabs(TSEE_Stream *stream, const TSEE_Map_Header *header) {
+	TSEE_Map_Prefab *prefabs = xmalloc(sizeof(*prefabs) * (header->prefab_count ? header->prefab_count : 1));
+	if (!prefabs || !TSEE_Map_SkipTo(stream, header->prefabs_offset)) {
+		if (prefabs) xfree(prefabs);
+		return NULL;
+	}
+	for (Uint32 i = 0; i < header->prefab_count; i++) {
+		TSEE_Map_Prefab *prefab = &prefabs[i];
+		TSEE_Stream_ReadU32(stream, &prefab->texture);
+		TSEE_Stream_ReadU32(stream, &prefab->attributes);
+		TSEE_Stream_ReadU64(stream, &prefab->components);
+		TSEE_Stream_ReadU64(stream, &prefab->first_instance);
+		TSEE_Stream_ReadU64(stream, &prefab->instance_count);
+		if (stream->failed || prefab->first_instance > header->instance_count || prefab->instance_count > header->instance_count - prefab->first_instance) {
+			TSEE_Error("Map's prefab table is invalid at prefab %u.\n", i);
+			xfree(prefabs);
+			return NULL;
+		}
+	}
+	return prefabs;
+}
+
+/**
+ * @brief Reads every prefab instance in a map at once.
+ *
+ * @param stream Stream to read from, before the instances.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @return TSEE_Vec2* Position of each instance in host order, free it with xfree. NULL on fail.
+ */
+TSEE_Vec2 *TSEE_Map_ReadInstances(TSEE_Stream *stream, const TSEE_Map_Header *header) {
+	TSEE_Vec2 *instances = xmalloc(sizeof(*instances) * (header->instance_count ? header->instance_count : 1));
+	if (!instances || !TSEE_Map_SkipTo(stream, header->instances_offset)) {
+		if (instances) xfree(instances);
+		return NULL;
+	}
+	// Instances are two floats like TSEE_Vec2, so they're read in one go and swapped in place.
+	if (!TSEE_Stream_Read(stream, instances, sizeof(TSEE_Map_Instance) * header->instance_count)) {
+		TSEE_Error("Map's instances are truncated.\n");
+		xfree(instances);
+		return NULL;
+	}
+	for (Uint64 i = 0; i < header->instance_count; i++) {
+		instances[i].x = SDL_SwapFloatLE(instances[i].x);
+		instances[i].y = SDL_SwapFloatLE(instances[i].y);
+	}
+	return instances;
+}
+
+/**
+ * @brief Reads a map's component data into memory.
+ *
+ * @param stream Stream to read from, before the component data.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @param components Set to the data, free its data with xfree even on fail.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_ReadComponents(TSEE_Stream *stream, const TSEE_Map_Header *header, TSEE_Map_ComponentData *components) {
+	components->size = header->components_size;
+	components->data = xmalloc(components->size ? components->size : 1);
+	if (!components->data || !TSEE_Map_SkipTo(stream, header->components_offset)) {
+		return false;
+	}
+	if (!TSEE_Stream_Read(stream, components->data, components->size)) {
+		TSEE_Error("Map's component data is truncated.\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Finds how much component data an object or prefab with a set of attributes has in a map.
+ *
+ * @param attributes TSEE_Object_Attributes OR'd together.
+ * @return Uint64 Size in bytes.
+ */
+Uint64 TSEE_Map_ComponentsSize(TSEE_Object_Attributes attributes) {
+	return sizeof(Uint32) * (Uint64)TSEE_Component_CountFields(attributes);
+}
+
+/**
+ * @brief Checks the component fields of an object or prefab are inside a map's component data.
+ *
+ * @param components The map's component data.
+ * @param attributes The record's attributes.
+ * @param offset The record's offset into the component data.
+ * @return true if they are.
+ */
+bool TSEE_Map_CheckComponents(const TSEE_Map_ComponentData *components, TSEE_Object_Attributes attributes, Uint64 offset) {
+	return offset <= components->size && TSEE_Map_ComponentsSize(attributes) <= components->size - offset;
+}
+
+/**
+ * @brief Sets up a prefab from a map's prefab record, see TSEE_Prefab_Init.
+ *
+ * @param prefab Prefab to set up, its asset is left for the caller to set.
+ * @param record Record in host order.
+ * @param components The map's component data.
+ * @return true on success, false if the record isn't a valid prefab.
+ */
+bool TSEE_Map_CreatePrefab(TSEE_Prefab *prefab, const TSEE_Map_Prefab *record, const TSEE_Map_ComponentData *components) {
+	if (!TSEE_Map_CheckComponents(components, record->attributes, record->components)) {
+		TSEE_Error("Map prefab's component data is out of bounds.\n");
+		return false;
+	}
+	if (!TSEE_Prefab_Init(prefab, NULL, record->attributes)) {
+		return false;
+	}
+	TSEE_Map_LoadComponents(&prefab->object, record->attributes, components, record->components, NULL);
+	return true;
+}
+
+/**
+ * @brief Adds the fields of every component an object has to a snapshot's component fields, in the order of the component table.
+ *
+ * @param snapshot Snapshot being built.
+ * @param object Object to save the components of.
+ * @param record The object's record, its components are set to where its fields start.
+ * @return true on success, false if memory ran out.
+ */
+bool TSEE_Map_SaveComponents(TSEE_Map_Snapshot *snapshot, const TSEE_Object *object, TSEE_Map_Object *record) {
+	size_t needed = snapshot->component_count + TSEE_Component_CountFields(object->attributes);
+	if (needed > snapshot->component_capacity) {
+		size_t capacity = snapshot->component_capacity ? snapshot->component_capacity : 64;
+		while (capacity < needed) {
+			capacity *= 2;
+		}
+		Uint32 *grown = xrealloc(snapshot->components, sizeof(*grown) * capacity);
+		if (!grown) {
+			return false;
+		}
+		snapshot->components = grown;
+		snapshot->component_capacity = capacity;
+	}
+	record->components = snapshot->component_count;
+	size_t count;
+	const TSEE_Component *components = TSEE_Component_GetAll(&count);
+	for (size_t i = 0; i < count; i++) {
+		if (!TSEE_Attributes_Check(object->attributes, components[i].attribute)) continue;
+		for (size_t f = 0; f < components[i].field_count; f++) {
+			const TSEE_Field *field = &components[i].fields[f];
+			Uint32 word;
+			if (field->type == TSEE_FIELD_STRING) {
+				const char *string = TSEE_Field_GetString(object, field);
+				word = TSEE_Map_AddString(&snapshot->strings, string ? string : "");
+			} else {
+				float value = TSEE_Field_GetFloat(object, field);
+				memcpy(&word, &value, sizeof(word));
+			}
+			snapshot->components[snapshot->component_count++] = word;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Loads a map record's component fields into an object, see TSEE_Map_SaveComponents.
+ *        The record's fields must be inside the component data, see TSEE_Map_CheckComponents.
+ *
+ * @param object Object to load the fields into, with no component strings yet.
+ *               Components the record has but the object doesn't, like a parallax object's physics, are skipped.
+ * @param attributes The record's attributes, which lay out its fields.
+ * @param components The map's component data.
+ * @param offset The record's offset into the component data.
+ * @param strings The map's strings, NULL if the record can't have any.
+ */
+void TSEE_Map_LoadComponents(TSEE_Object *object, TSEE_Object_Attributes attributes, const TSEE_Map_ComponentData *components, Uint64 offset, const TSEE_Map_StringTable *strings) {
+	const Uint8 *data = components->data + offset;
+	size_t count;
+	const TSEE_Component *table = TSEE_Component_GetAll(&count);
+	for (size_t i = 0; i < count; i++) {
+		if (!TSEE_Attributes_Check(attributes, table[i].attribute)) continue;
+		bool kept = TSEE_Object_CheckAttribute(object, table[i].attribute);
+		for (size_t f = 0; f < table[i].field_count; f++, data += sizeof(Uint32)) {
+			const TSEE_Field *field = &table[i].fields[f];
+			Uint32 word;
+			memcpy(&word, data, sizeof(word));
+			word = SDL_SwapLE32(word);
+			if (!kept) continue;
+			if (field->type == TSEE_FIELD_STRING) {
+				TSEE_Field_SetString(object, field, strings ? TSEE_Map_GetString(strings, word) : NULL);
+			} else {
+				float value;
+				memcpy(&value, &word, sizeof(value));
+				TSEE_Field_SetFloat(object, field, value);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Converts an object record between host byte order and a map's little endian order, in place.
+ *
+ * @param record Record to convert, converting it twice gives back the same record.
+ */
+void TSEE_Map_SwapObject(TSEE_Map_Object *record) {
+	record->texture = SDL_SwapLE32(record->texture);
+	record->attributes = SDL_SwapLE32(record->attributes);
+	record->x = SDL_SwapFloatLE(record->x);
+	record->y = SDL_SwapFloatLE(record->y);
+	record->components = SDL_SwapLE64(record->components);
+	record->reserved = SDL_SwapLE64(record->reserved);
+}
+
+/**
+ * @brief Creates an object from a map's object record.
+ *
+ * @param tsee TSEE object to create it in.
+ * @param record Record in host order.
+ * @param texture Texture for the object, it isn't destroyed if the object can't be created.
+ * @param components The map's component data.
+ * @param strings The map's strings, for text objects.
+ * @return TSEE_Object* or NULL if the record isn't a valid object.
+ */
+TSEE_Object *TSEE_Map_CreateObject(TSEE *tsee, const TSEE_Map_Object *record, TSEE_Texture *texture, const TSEE_Map_ComponentData *components, const TSEE_Map_StringTable *strings) {
+	TSEE_Object_Attributes attr = record->attributes;
+	if (!TSEE_Map_CheckComponents(components, attr, record->components)) {
+		TSEE_Error("Map object's component data is out of bounds.\n");
+		return NULL;
+	}
+	TSEE_Object *object;
+	if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PARALLAX)) {
+		object = TSEE_Parallax_Create(tsee, texture, 1000);
+	} else {
+		object = TSEE_Object_Create(tsee, texture, attr, record->x, record->y);
+	}
+	if (!object) {
+		return NULL;
+	}
+	TSEE_Map_LoadComponents(object, attr, components, record->components, strings);
+	return object;
+}
+
+/**
+ * @brief Reads a v2 map's string table.
+ *
+ * @param stream Stream to read from, just after the header.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @param table Table to fill in, free it with TSEE_Map_FreeStrings.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_ReadStrings(TSEE_Stream *stream, const TSEE_Map_Header *header, TSEE_Map_StringTable *table) {
+	table->count = header->string_count;
+	table->size = header->string_data_size;
+	table->offsets = xmalloc(sizeof(*table->offsets) * (table->count ? table->count : 1));
+	// One extra byte so the last string is always terminated.
+	table->data = xmalloc(table->size + 1);
+	if (!table->offsets || !table->data) {
+		return false;
+	}
+	if (!TSEE_Map_SkipTo(stream, header->strings_offset)) {
+		return false;
+	}
+	for (Uint32 i = 0; i < table->count; i++) {
+		TSEE_Stream_ReadU32(stream, &table->offsets[i]);
+	}
+	if (!TSEE_Map_SkipTo(stream, header->string_data_offset) || !TSEE_Stream_Read(stream, table->data, table->size)) {
+		TSEE_Error("Map's strings are truncated.\n");
+		return false;
+	}
+	table->data[table->size] = '\0';
+	return true;
+}
+
+/**
+ * @brief Reads a v2 map's texture table.
+ *
+ * @param stream Stream to read from, before the texture table.
+ * @param header Header read with TSEE_Map_ReadHeader.
+ * @param strings The map's strings, read with TSEE_Map_ReadStrings.
+ * @return const char** Path of each texture pointing into the strings, free it with xfree. NULL on fail.
+ */
+const char **TSEE_Map_ReadTextures(TSEE_Stream *stream, const TSEE_Map_Header *header, const TSEE_Map_StringTable *strings) {
+	const char **paths = xmalloc(sizeof(*paths) * (header->texture_count ? header->texture_count : 1));
+	if (!paths || !TSEE_Map_SkipTo(stream, header->textures_offset)) {
+		if (paths) xfree(paths);
+		return NULL;
+	}
+	for (Uint32 i = 0; i < header->texture_count; i++) {
+		Uint32 index = 0;
+		TSEE_Stream_ReadU32(stream, &index);
+		paths[i] = TSEE_Map_GetString(strings, index);
+		if (!paths[i]) {
+			TSEE_Error("Map texture %u has an invalid path.\n", i);
+			xfree(paths);
+			return NULL;
+		}
+	}
+	return paths;
+}
+
+/**
+ * @brief Gets a string from a v2 map's string table.
+ *
+ * @param table Table read with TSEE_Map_ReadStrings.
+ * @param index Index of the string.
+ * @return const char* pointing into the table, or NULL if the index is invalid.
+ */
+const char *TSEE_Map_GetString(const TSEE_Map_StringTable *table, Uint32 index) {
+	if (index >= table->count || table->offsets[index] >= table->size) {
+		return NULL;
+	}
+	return table->data + table->offsets[index];
+}
+
+/**
+ * @brief Frees a string table read with TSEE_Map_ReadStrings.
+ *
+ * @param table Table to free.
+ */
+void TSEE_Map_FreeStrings(TSEE_Map_StringTable *table) {
+	if (table->offsets) xfree(table->offsets);
+	if (table->data) xfree(table->data);
+	table->offsets = NULL;
+	table->data = NULL;
+}
+
+/**
+ * @brief Loads a v2 map. Textures are loaded up front, then objects are created
+ *        from the record array in batches, with their arrays reserved ahead of time.
+ *        Chunked maps opened from a path only load the objects outside chunks, the chunks are streamed in around the camera.
+ *
+ * @param tsee TSEE object to load the map into.
+ * @param stream Stream to read the map from.
+ * @param path Path the map was opened from, or NULL to load every chunk now.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_LoadV2(TSEE *tsee, TSEE_Stream *stream, const char *path) {
+	Uint64 start = SDL_GetPerformanceCounter();
+	TSEE_Map_Header header;
+	if (!TSEE_Map_ReadHeader(stream, &header)) {
+		return false;
+	}
+	TSEE_Map_StringTable strings = {NULL, NULL, 0, 0};
+	if (!TSEE_Map_ReadStrings(stream, &header, &strings)) {
+		TSEE_Map_FreeStrings(&strings);
+		return false;
+	}
+	size_t textureCount = header.texture_count ? header.texture_count : 1;
+	const char **texturePaths = TSEE_Map_ReadTextures(stream, &header, &strings);
+	bool success = texturePaths != NULL;
+	bool streamed = success && path && header.chunk_count > 0;
+	TSEE_Map_Chunk *chunks = streamed ? TSEE_Map_ReadChunks(stream, &header) : NULL;
+	TSEE_Map_ComponentData components = {NULL, 0};
+	if (!success || (streamed && !chunks) || !TSEE_Map_ReadComponents(stream, &header, &components) || !TSEE_Map_SkipTo(stream, header.objects_offset)) {
+		if (components.data) xfree(components.data);
+		if (chunks) xfree(chunks);
+		if (texturePaths) xfree(texturePaths);
+		TSEE_Map_FreeStrings(&strings);
+		return false;
+	}
+	// Objects before the first chunk are the ones outside every chunk.
+	Uint64 objectCount = streamed ? chunks[0].first_object : header.object_count;
+	TSEE_Map_Clear(tsee);
+
+	const char *name = TSEE_Map_GetString(&strings, header.name);
+	const char *author = TSEE_Map_GetString(&strings, header.author);
+	const char *version = TSEE_Map_GetString(&strings, header.map_version);
+	const char *description = TSEE_Map_GetString(&strings, header.description);
+	TSEE_Log("Loading into %s by %s\nVersion: %s\n%s\n", name ? name : "", author ? author : "", version ? version : "", description ? description : "");
+	TSEE_World_SetGravity(tsee, (TSEE_Vec2){header.gravity_x, header.gravity_y});
+
+	// Read and decode every texture at once, rather than one by one as objects use them.
+	// Streamed maps load textures with their chunks instead.
+	if (!streamed) {
+		TSEE_Log("Loading %u textures\n", header.texture_count);
+		TSEE_Loader_Preload(tsee, (char **)texturePaths, header.texture_count, true);
+	}
+
+	TSEE_Texture_Asset **assets = xmalloc(sizeof(*assets) * textureCount);
+	bool *tried = xmalloc(sizeof(*tried) * textureCount);
+	memset(tried, 0, sizeof(*tried) * textureCount);
+	TSEE_Array_Reserve(tsee->world->objects, tsee->world->objects->size + objectCount + header.instance_count);
+	TSEE_Array_Reserve(tsee->textures, tsee->textures->size + objectCount + header.instance_count);
+
+	TSEE_Log("Loading %zu objects\n", (size_t)objectCount);
+	size_t skipped = 0;
+	size_t invalid = 0;
+	TSEE_Map_Object records[TSEE_MAP_RECORD_BATCH];
+	for (Uint64 first = 0; first < objectCount; first += TSEE_MAP_RECORD_BATCH) {
+		size_t count = objectCount - first < TSEE_MAP_RECORD_BATCH ? objectCount - first : TSEE_MAP_RECORD_BATCH;
+		if (!TSEE_Stream_Read(stream, records, sizeof(*records) * count)) {
+			TSEE_Error("Map's objects are truncated, loaded %zu of them.\n", (size_t)first);
+			success = false;
+			break;
+		}
+		for (size_t i = 0; i < count; i++) {
+			TSEE_Map_Object *record = &records[i];
+			TSEE_Map_SwapObject(record);
+			if (record->texture >= header.texture_count) {
+				invalid++;
+				continue;
+			}
+			TSEE_Texture *texture = NULL;
+			if (!tried[record->texture]) {
+				// The first use goes through TSEE_Texture_Create, which loads it here if preloading didn't.
+				tried[record->texture] = true;
+				texture = TSEE_Texture_Create(tsee, (char *)texturePaths[record->texture]);
+				assets[record->texture] = texture ? texture->asset : NULL;
+			} else if (assets[record->texture]) {
+				texture = TSEE_Texture_CreateFromAsset(tsee, assets[record->texture]);
+			}
+			if (!texture) {
+				skipped++;
+				continue;
+			}
+			if (!TSEE_Map_CreateObject(tsee, record, texture, &components, &strings)) {
+				if (texture->asset && texture->asset->users->size == 1) {
+					// Destroying the texture destroys the asset too, so the next object loads it again.
+					tried[record->texture] = false;
+				}
+				TSEE_Texture_Destroy(tsee, texture);
+				invalid++;
+			}
+		}
+	}
+	// Prefab instances are always loaded with the map, even if it's chunked.
+	if (success && header.prefab_count > 0) {
+		TSEE_Map_Prefab *prefabs = TSEE_Map_ReadPrefabs(stream, &header);
+		TSEE_Vec2 *instances = prefabs ? TSEE_Map_ReadInstances(stream, &header) : NULL;
+		success = instances != NULL;
+		TSEE_Log("Loading %zu instances of %u prefabs\n", (size_t)header.instance_count, header.prefab_count);
+		for (Uint32 i = 0; success && i < header.prefab_count; i++) {
+			TSEE_Map_Prefab *record = &prefabs[i];
+			TSEE_Prefab prefab;
+			if (record->texture >= header.texture_count || !TSEE_Map_CreatePrefab(&prefab, record, &components)) {
+				invalid += record->instance_count;
+				continue;
+			}
+			if (!tried[record->texture]) {
+				tried[record->texture] = true;
+				assets[record->texture] = TSEE_Texture_LoadAsset(tsee, (char *)texturePaths[record->texture]);
+			}
+			prefab.asset = assets[record->texture];
+			size_t created = prefab.asset ? TSEE_Prefab_Instantiate(tsee, &prefab, &instances[record->first_instance], record->instance_count) : 0;
+			skipped += record->instance_count - created;
+		}
+		if (prefabs) xfree(prefabs);
+		if (instances) xfree(instances);
+	}
+	if (skipped > 0) {
+		TSEE_Warn("Skipped %zu objects with textures that couldn't be loaded.\n", skipped);
+	}
+	if (invalid > 0) {
+		TSEE_Warn("Skipped %zu invalid objects.\n", invalid);
+	}
+
+	TSEE_Map_FindPlayer(tsee);
+	TSEE_Player_SetSpeed(tsee, header.player_speed);
+	TSEE_Player_SetJumpForce(tsee, header.player_jump_force);
+	TSEE_Log("Map %s loaded %zu objects in %.3f ms.\n", name ? name : "", tsee->world->objects->size, (SDL_GetPerformanceCounter() - start) * 1000 / (double)SDL_GetPerformanceFrequency());
+	xfree(tried);
+	xfree(assets);
+	xfree(components.data);
+	if (success && streamed) {
+		// The stream takes the strings, paths and chunks.
+		return TSEE_MapStream_Create(tsee, path, &header, &strings, texturePaths, chunks);
+	}
+	if (chunks) xfree(chunks);
+	xfree(texturePaths);
+	TSEE_Map_FreeStrings(&strings);
+	return success;
+}
+
+/**
+ * @brief Adds a string to a map being saved, reusing it if it's already there.
+ *        The string is copied, so it can be written after whatever it came from is gone.
+ * 
+ * @param strings String table being built.
+ * @param string String to add.
+ * @return Uint32 Index of the string.
+ */
+Uint32 TSEE_Map_AddString(TSEE_Map_Strings *strings, const char *string) {
+	uintptr_t index = (uintptr_t)TSEE_HashMap_Get(strings->indices, string);
+	if (index) {
+		return index - 1;
+	}
+	char *copy = strdup(string);
+	TSEE_Array_Append(strings->strings, copy);
+	TSEE_HashMap_Set(strings->indices, copy, (void *)(uintptr_t)strings->strings->size);
+	strings->size += strlen(string) + 1;
+	return strings->strings->size - 1;
+}
+
+/**
+ * @brief Adds a texture to a map being saved, reusing it if it's already there.
+ * 
+ * @param snapshot Snapshot being built.
+ * @param path Path of the texture, it's copied.
+ * @return Uint32 Index of the texture.
+ */
+Uint32 TSEE_Map_AddTexture(TSEE_Map_Snapshot *snapshot, const char *path) {
+	uintptr_t index = (uintptr_t)TSEE_HashMap_Get(snapshot->texture_indices, path);
+	if (index) {
+		return index - 1;
+	}
+	Uint32 string = TSEE_Map_AddString(&snapshot->strings, path);
+	TSEE_Array_Append(snapshot->textures, (void *)(uintptr_t)string);
+	TSEE_HashMap_Set(snapshot->texture_indices, snapshot->strings.strings->data[string], (void *)(uintptr_t)snapshot->textures->size);
+	return snapshot->textures->size - 1;
+}
+
+/**
+ * @brief Orders objects being saved. Players, parallax backgrounds and UI come first in the order they were added,
+ *        then the other unchunked objects, then each chunk's objects (y then x). Each run is in Morton order.
+ *
+ * @param a First TSEE_Map_SaveObject.
+ * @param b Second TSEE_Map_SaveObject.
+ * @return int qsort ordering.
+ */
+int TSEE_Map_CompareSaveObjects(const void *a, const void *b) {
+	const TSEE_Map_SaveObject *first = a;
+	const TSEE_Map_SaveObject *second = b;
+	if (first->chunked != second->chunked) return first->chunked ? 1 : -1;
+	if (first->spatial != second->spatial) return first->spatial ? 1 : -1;
+	if (first->chunk_y != second->chunk_y) return first->chunk_y < second->chunk_y ? -1 : 1;
+	if (first->chunk_x != second->chunk_x) return first->chunk_x < second->chunk_x ? -1 : 1;
+	if (first->morton != second->morton) return first->morton < second->morton ? -1 : 1;
+	return first->order < second->order ? -1 : first->order > second->order;
+}
+
+/**
+ * @brief Spreads a number's bits out with a zero between each of them, so two can be interleaved.
+ *
+ * @param value Number to spread.
+ * @return Uint64 The spread bits.
+ */
+Uint64 TSEE_Map_SpreadBits(Uint32 value) {
+	Uint64 bits = value;
+	bits = (bits | bits << 16) & 0x0000FFFF0000FFFFULL;
+	bits = (bits | bits << 8) & 0x00FF00FF00FF00FFULL;
+	bits = (bits | bits << 4) & 0x0F0F0F0F0F0F0F0FULL;
+	bits = (bits | bits << 2) & 0x3333333333333333ULL;
+	bits = (bits | bits << 1) & 0x5555555555555555ULL;
+	return bits;
+}
+
+/**
+ * @brief Finds the Morton (Z-order) code of a position inside a square. Positions close together get close codes,
+ *        and every quarter of the square, and every quarter of those, is a run of codes.
+ *
+ * @param x Position in the world.
+ * @param y Position in the world.
+ * @param left Left edge of the square.
+ * @param top Top edge of the square.
+ * @param size Width and height of the square, positions outside it are clamped into it.
+ * @return Uint64 The position's y and x bits interleaved, y first.
+ */
+Uint64 TSEE_Map_MortonCode(float x, float y, float left, float top, float size) {
+	double scale = 4294967296.0 / size;
+	double cells[2] = {(x - (double)left) * scale, (y - (double)top) * scale};
+	Uint32 quantised[2];
+	for (int i = 0; i < 2; i++) {
+		if (!(cells[i] > 0)) quantised[i] = 0;
+		else if (cells[i] >= UINT32_MAX) quantised[i] = UINT32_MAX;
+		else quantised[i] = (Uint32)cells[i];
+	}
+	return TSEE_Map_SpreadBits(quantised[1]) << 1 | TSEE_Map_SpreadBits(quantised[0]);
+}
+
+/**
+ * @brief Sorts a snapshot's objects into the order they're saved in, see TSEE_Map_CompareSaveObjects.
+ *        Objects near each other in the world end up near each other in the map, and so in the world once it's loaded.
+ *
+ * @param snapshot Snapshot to sort.
+ */
+void TSEE_Map_SortObjects(TSEE_Map_Snapshot *snapshot) {
+	TSEE_Map_SaveObject *saved = snapshot->objects;
+	size_t count = snapshot->count;
+	// Unchunked objects are ordered inside the square around all of them, chunked ones inside their chunk.
+	float left = 0, top = 0, right = 0, bottom = 0;
+	bool found = false;
+	for (size_t i = 0; i < count; i++) {
+		if (!saved[i].spatial || saved[i].chunked) continue;
+		float x = saved[i].record.x;
+		float y = saved[i].record.y;
+		if (!found || x < left) left = x;
+		if (!found || y < top) top = y;
+		if (!found || x > right) right = x;
+		if (!found || y > bottom) bottom = y;
+		found = true;
+	}
+	float size = right - left > bottom - top ? right - left : bottom - top;
+	if (!(size > 0) || isinf(size)) {
+		size = 1;
+	}
+	for (size_t i = 0; i < count; i++) {
+		TSEE_Map_SaveObject *entry = &saved[i];
+		if (!entry->spatial) {
+			entry->morton = 0;
+		} else if (entry->chunked) {
+			float chunkSize = snapshot->chunk_size;
+			entry->morton = TSEE_Map_MortonCode(entry->record.x, entry->record.y, entry->chunk_x * chunkSize, entry->chunk_y * chunkSize, chunkSize);
+		} else {
+			entry->morton = TSEE_Map_MortonCode(entry->record.x, entry->record.y, left, top, size);
+		}
+	}
+	qsort(saved, count, sizeof(*saved), TSEE_Map_CompareSaveObjects);
+}
+
+/**
+ * @brief Finds the chunk a coordinate is in, clamped to the range chunk coordinates are saved in.
+ *
+ * @param position Coordinate in the world.
+ * @param chunkSize Width and height of a chunk.
+ * @return Sint32 Chunk coordinate.
+ */
+Sint32 TSEE_Map_ChunkCoordinate(float position, float chunkSize) {
+	float chunk = floorf(position / chunkSize);
+	if (!(chunk > INT32_MIN)) return INT32_MIN;
+	if (chunk >= INT32_MAX) return INT32_MAX;
+	return (Sint32)chunk;
+}
+
+/**
+ * @brief Adds an object to a snapshot, placing it in its chunk if the snapshot is chunked.
+ *        The snapshot must have room for it, see TSEE_Map_CreateSnapshot.
+ *
+ * @param snapshot Snapshot being built, its chunk size must already be set.
+ * @param record Object's record in host order.
+ */
+void TSEE_Map_AddObject(TSEE_Map_Snapshot *snapshot, const TSEE_Map_Object *record) {
+	TSEE_Map_SaveObject *entry = &snapshot->objects[snapshot->count];
+	// Kept in host order until written.
+	entry->record = *record;
+	entry->spatial = !TSEE_Attributes_Check(record->attributes, TSEE_ATTRIB_PLAYER | TSEE_ATTRIB_PARALLAX | TSEE_ATTRIB_UI);
+	entry->chunked = snapshot->chunk_size > 0 && entry->spatial;
+	entry->chunk_x = entry->chunked ? TSEE_Map_ChunkCoordinate(record->x, snapshot->chunk_size) : 0;
+	entry->chunk_y = entry->chunked ? TSEE_Map_ChunkCoordinate(record->y, snapshot->chunk_size) : 0;
+	entry->order = snapshot->count++;
+}
+
+/**
+ * @brief Creates an empty snapshot to build a map in, with room for a number of objects.
+ *        Its name, author, version and description must be set before it's written.
+ *
+ * @param capacity Number of objects it can hold.
+ * @return TSEE_Map_Snapshot* Free it with TSEE_Map_FreeSnapshot. NULL on fail.
+ */
+TSEE_Map_Snapshot *TSEE_Map_CreateSnapshot(size_t capacity) {
+	TSEE_Map_Snapshot *snapshot = xmalloc(sizeof(*snapshot));
+	if (!snapshot) {
+		return NULL;
+	}
+	memset(snapshot, 0, sizeof(*snapshot));
+	snapshot->strings = (TSEE_Map_Strings){TSEE_HashMap_Create(), TSEE_Array_Create(), 0};
+	snapshot->textures = TSEE_Array_Create();
+	snapshot->texture_indices = TSEE_HashMap_Create();
+	snapshot->objects = xmalloc(sizeof(*snapshot->objects) * (capacity ? capacity : 1));
+	if (!snapshot->objects) {
+		TSEE_Map_FreeSnapshot(snapshot);
+		return NULL;
+	}
+	return snapshot;
+}
+
+/**
+ * @brief Copies everything a v2 map saves out of the world, deduplicating textures and strings as they're found.
+ *        Nothing in the snapshot points into the world, so it can be written on another thread while the world changes.
+ *
+ * @param tsee TSEE object to snapshot.
+ * @return TSEE_Map_Snapshot* Free it with TSEE_Map_FreeSnapshot. NULL on fail.
+ */
+TSEE_Map_Snapshot *TSEE_Map_TakeSnapshot(TSEE *tsee) {
+	TSEE_Array *objects = tsee->world->objects;
+	TSEE_Map_Snapshot *snapshot = TSEE_Map_CreateSnapshot(objects->size);
+	if (!snapshot) {
+		return NULL;
+	}
+	snapshot->gravity = tsee->world->gravity;
+	snapshot->player_speed = tsee->player->speed;
+	snapshot->player_jump_force = tsee->player->jump_force;
+	snapshot->chunk_size = tsee->world->chunk_size > 0 ? tsee->world->chunk_size : 0;
+	// Chunks are read in place from the mapped map while it streams, so chunked maps aren't compressed.
+	snapshot->compressed = tsee->world->compress_maps && snapshot->chunk_size == 0;
+	if (tsee->world->compress_maps && !snapshot->compressed) {
+		TSEE_Warn("Saving the map uncompressed, chunked maps can't be compressed.\n");
+	}
+	TSEE_Map_Strings *strings = &snapshot->strings;
+	snapshot->name = TSEE_Map_AddString(strings, "Test Map");
+	snapshot->author = TSEE_Map_AddString(strings, "Test Author");
+	snapshot->version = TSEE_Map_AddString(strings, "1.0");
+	snapshot->description = TSEE_Map_AddString(strings, "Test Description");
+	for (size_t i = 0; i < objects->size; i++) {
+		TSEE_Object *object = objects->data[i];
+		if (!object->texture || !object->texture->path) {
+			TSEE_Warn("Not saving object %zu, its texture isn't from a file.\n", i);
+			continue;
+		}
+		TSEE_Map_Object record;
+		memset(&record, 0, sizeof(record));
+		record.texture = TSEE_Map_AddTexture(snapshot, object->texture->path);
+		record.attributes = object->attributes;
+		record.x = object->position.x;
+		record.y = object->position.y;
+		if (!TSEE_Map_SaveComponents(snapshot, object, &record)) {
+			TSEE_Map_FreeSnapshot(snapshot);
+			return NULL;
+		}
+		TSEE_Map_AddObject(snapshot, &record);
+	}
+	TSEE_Log("Found %zu unique textures.\n", snapshot->textures->size);
+	return snapshot;
+}
+
+/**
+ * @brief Frees a snapshot taken with TSEE_Map_TakeSnapshot.
+ *
+ * @param snapshot Snapshot to free.
+ */
+void TSEE_Map_FreeSnapshot(TSEE_Map_Snapshot *snapshot) {
+	for (size_t i = 0; i < snapshot->strings.strings->size; i++) {
+		xfree(snapshot->strings.strings->data[i]);
+	}
+	TSEE_Array_Destroy(snapshot->strings.strings);
+	TSEE_HashMap_Destroy(snapshot->strings.indices);
+	TSEE_Array_Destroy(snapshot->textures);
+	TSEE_HashMap_Destroy(snapshot->texture_indices);
+	if (snapshot->objects) xfree(snapshot->objects);
+	if (snapshot->components) xfree(snapshot->components);
+	xfree(snapshot);
+}
+
+/**
+ * @brief Finds the objects in a snapshot that only differ by position, so they can be saved as instances of a prefab.
+ *        Objects whose texture, attributes and components all match at least TSEE_MAP_PREFAB_MIN_INSTANCES - 1 others share a prefab.
+ *        Chunked snapshots keep every object whole, so each chunk's objects can still be read from one run.
+ *
+ * @param snapshot Snapshot to search, each object's prefab is set.
+ * @param prefabCount Set to the number of prefabs found.
+ * @return TSEE_Map_Prefab* Prefabs in host order with their instance runs, their components index into the snapshot's like its records'.
+ *         Free it with xfree. NULL on fail.
+ */
+TSEE_Map_Prefab *TSEE_Map_FindPrefabs(TSEE_Map_Snapshot *snapshot, Uint32 *prefabCount) {
+	TSEE_Map_SaveObject *saved = snapshot->objects;
+	size_t count = snapshot->count;
+	*prefabCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		saved[i].prefab = TSEE_MAP_NO_PREFAB;
+	}
+	TSEE_Map_Prefab *prefabs = xmalloc(sizeof(*prefabs) * (count ? count : 1));
+	if (!prefabs || snapshot->chunk_size > 0) {
+		return prefabs;
+	}
+	TSEE_HashMap *indices = TSEE_HashMap_Create();
+	TSEE_Array *keys = TSEE_Array_Create();
+	char *key = NULL;
+	size_t keyCapacity = 0;
+	Uint32 found = 0;
+	for (size_t i = 0; i < count; i++) {
+		TSEE_Map_Object *record = &saved[i].record;
+		if (TSEE_Attributes_Check(record->attributes, TSEE_ATTRIB_PLAYER | TSEE_ATTRIB_PARALLAX | TSEE_ATTRIB_TEXT)) continue;
+		// The attributes lay out the component fields, so records with the same attributes and fields have the same components.
+		size_t fields = TSEE_Component_CountFields(record->attributes);
+		const Uint32 *words = &snapshot->components[record->components];
+		size_t length = 8 * (2 + fields) + 1;
+		if (length > keyCapacity) {
+			char *grown = xrealloc(key, length);
+			if (!grown) continue;
+			key = grown;
+			keyCapacity = length;
+		}
+		int written = snprintf(key, length, "%08x%08x", record->texture, record->attributes);
+		for (size_t f = 0; f < fields; f++) {
+			written += snprintf(key + written, length - written, "%08x", words[f]);
+		}
+		uintptr_t index = (uintptr_t)TSEE_HashMap_Get(indices, key);
+		if (!index) {
+			char *copy = strdup(key);
+			TSEE_Array_Append(keys, copy);
+			index = ++found;
+			TSEE_HashMap_Set(indices, copy, (void *)index);
+			prefabs[index - 1] = (TSEE_Map_Prefab){record->texture, record->attributes, record->components, 0, 0};
+		}
+		prefabs[index - 1].instance_count++;
+		saved[i].prefab = index - 1;
+	}
+	if (key) xfree(key);
+	for (size_t i = 0; i < keys->size; i++) {
+		xfree(keys->data[i]);
+	}
+	TSEE_Array_Destroy(keys);
+	TSEE_HashMap_Destroy(indices);
+
+	// Drop prefabs with too few instances to be worth it, then lay the rest's instances out one run after another.
+	Uint32 *remap = xmalloc(sizeof(*remap) * (found ? found : 1));
+	if (!remap) {
+		xfree(prefabs);
+		return NULL;
+	}
+	Uint64 instances = 0;
+	for (Uint32 i = 0; i < found; i++) {
+		if (prefabs[i].instance_count < TSEE_MAP_PREFAB_MIN_INSTANCES) {
+			remap[i] = TSEE_MAP_NO_PREFAB;
+			continue;
+		}
+		remap[i] = *prefabCount;
+		prefabs[*prefabCount] = prefabs[i];
+		prefabs[*prefabCount].first_instance = instances;
+		instances += prefabs[i].instance_count;
+		(*prefabCount)++;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (saved[i].prefab != TSEE_MAP_NO_PREFAB) {
+			saved[i].prefab = remap[saved[i].prefab];
+		}
+	}
+	xfree(remap);
+	return prefabs;
+}
+
+/**
+ * @brief Writes a snapshot as a v2 map. If it was taken with a chunk size, objects are saved in chunks
+ *        which are streamed in around the camera when the map is loaded. Players, parallax backgrounds and UI are never chunked.
+ *        Only touches the snapshot and the stream, so it can be run on any thread.
+ *
+ * @param snapshot Snapshot to write, its objects are sorted into the order they're saved in.
+ * @param stream Stream to write to.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_WriteSnapshot(TSEE_Map_Snapshot *snapshot, TSEE_Stream *stream) {
+	TSEE_Map_Strings *strings = &snapshot->strings;
+	TSEE_Array *textures = snapshot->textures;
+	TSEE_Map_SaveObject *saved = snapshot->objects;
+	size_t count = snapshot->count;
+
+	// Group each chunk's objects together, then build the chunk table from the runs.
+	TSEE_Map_SortObjects(snapshot);
+	TSEE_Array *chunks = TSEE_Array_Create();
+	if (snapshot->chunk_size > 0) {
+		for (size_t i = 0; i < count; i++) {
+			if (!saved[i].chunked) continue;
+			if (i == 0 || !saved[i - 1].chunked || saved[i].chunk_x != saved[i - 1].chunk_x || saved[i].chunk_y != saved[i - 1].chunk_y) {
+				TSEE_Array_Append(chunks, (void *)i);
+			}
+		}
+	}
+	TSEE_Log("Saving %zu chunks.\n", chunks->size);
+
+	Uint32 prefabCount;
+	TSEE_Map_Prefab *prefabs = TSEE_Map_FindPrefabs(snapshot, &prefabCount);
+	Uint64 instanceCount = prefabCount > 0 ? prefabs[prefabCount - 1].first_instance + prefabs[prefabCount - 1].instance_count : 0;
+	TSEE_Vec2 *instances = xmalloc(sizeof(*instances) * (instanceCount ? instanceCount : 1));
+	if (!prefabs || !instances) {
+		if (prefabs) xfree(prefabs);
+		if (instances) xfree(instances);
+		TSEE_Array_Destroy(chunks);
+		return false;
+	}
+	// Each prefab's instances are gathered into its run, in the order they're in the snapshot.
+	for (Uint32 i = 0; i < prefabCount; i++) {
+		prefabs[i].instance_count = 0;
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (saved[i].prefab == TSEE_MAP_NO_PREFAB) continue;
+		TSEE_Map_Prefab *prefab = &prefabs[saved[i].prefab];
+		instances[prefab->first_instance + prefab->instance_count++] = (TSEE_Vec2){saved[i].record.x, saved[i].record.y};
+	}
+	size_t recordCount = count - instanceCount;
+	// The component fields of each record are written in the order of the records, then those of each prefab.
+	Uint64 componentsSize = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (saved[i].prefab == TSEE_MAP_NO_PREFAB) {
+			componentsSize += TSEE_Map_ComponentsSize(saved[i].record.attributes);
+		}
+	}
+	for (Uint32 i = 0; i < prefabCount; i++) {
+		componentsSize += TSEE_Map_ComponentsSize(prefabs[i].attributes);
+	}
+
+	Uint64 stringsOffset = TSEE_PAK_ALIGN(sizeof(TSEE_Map_Header), TSEE_MAP_ALIGNMENT);
+	Uint64 stringDataOffset = stringsOffset + sizeof(Uint32) * strings->strings->size;
+	Uint64 texturesOffset = TSEE_PAK_ALIGN(stringDataOffset + strings->size, TSEE_MAP_ALIGNMENT);
+	Uint64 chunksOffset = TSEE_PAK_ALIGN(texturesOffset + sizeof(Uint32) * textures->size, TSEE_MAP_ALIGNMENT);
+	Uint64 componentsOffset = TSEE_PAK_ALIGN(chunksOffset + sizeof(TSEE_Map_Chunk) * chunks->size, TSEE_MAP_ALIGNMENT);
+	Uint64 objectsOffset = TSEE_PAK_ALIGN(componentsOffset + componentsSize, TSEE_MAP_ALIGNMENT);
+	Uint64 prefabsOffset = objectsOffset + sizeof(TSEE_Map_Object) * recordCount;
+	Uint64 instancesOffset = prefabsOffset + sizeof(TSEE_Map_Prefab) * prefabCount;
+
+	TSEE_Stream_Write(stream, TSEE_MAP_MAGIC, sizeof(((TSEE_Map_Header *)0)->magic));
+	TSEE_Stream_WriteU32(stream, TSEE_MAP_VERSION);
+	TSEE_Stream_WriteU32(stream, sizeof(TSEE_Map_Header));
+	TSEE_Stream_WriteU32(stream, snapshot->name);
+	TSEE_Stream_WriteU32(stream, snapshot->author);
+	TSEE_Stream_WriteU32(stream, snapshot->version);
+	TSEE_Stream_WriteU32(stream, snapshot->description);
+	TSEE_Stream_WriteF32(stream, snapshot->gravity.x);
+	TSEE_Stream_WriteF32(stream, snapshot->gravity.y);
+	TSEE_Stream_WriteF32(stream, snapshot->player_speed);
+	TSEE_Stream_WriteF32(stream, snapshot->player_jump_force);
+	TSEE_Stream_WriteU32(stream, strings->strings->size);
+	TSEE_Stream_WriteU32(stream, textures->size);
+	TSEE_Stream_WriteU64(stream, recordCount);
+	TSEE_Stream_WriteU64(stream, stringsOffset);
+	TSEE_Stream_WriteU64(stream, stringDataOffset);
+	TSEE_Stream_WriteU64(stream, strings->size);
+	TSEE_Stream_WriteU64(stream, texturesOffset);
+	TSEE_Stream_WriteU64(stream, objectsOffset);
+	TSEE_Stream_WriteF32(stream, snapshot->chunk_size);
+	TSEE_Stream_WriteU32(stream, chunks->size);
+	TSEE_Stream_WriteU64(stream, chunksOffset);
+	TSEE_Stream_WriteU32(stream, prefabCount);
+	TSEE_Stream_WriteU32(stream, TSEE_MAP_FLAG_MORTON);
+	TSEE_Stream_WriteU64(stream, instanceCount);
+	TSEE_Stream_WriteU64(stream, prefabsOffset);
+	TSEE_Stream_WriteU64(stream, instancesOffset);
+	TSEE_Stream_WriteU64(stream, componentsOffset);
+	TSEE_Stream_WriteU64(stream, componentsSize);
+
+	TSEE_Stream_Align(stream, TSEE_MAP_ALIGNMENT);
+	Uint32 stringOffset = 0;
+	for (size_t i = 0; i < strings->strings->size; i++) {
+		TSEE_Stream_WriteU32(stream, stringOffset);
+		stringOffset += strlen(strings->strings->data[i]) + 1;
+	}
+	for (size_t i = 0; i < strings->strings->size; i++) {
+		const char *string = strings->strings->data[i];
+		TSEE_Stream_Write(stream, string, strlen(string) + 1);
+	}
+	TSEE_Stream_Align(stream, TSEE_MAP_ALIGNMENT);
+	for (size_t i = 0; i < textures->size; i++) {
+		TSEE_Stream_WriteU32(stream, (Uint32)(uintptr_t)textures->data[i]);
+	}
+	TSEE_Stream_Align(stream, TSEE_MAP_ALIGNMENT);
+	for (size_t i = 0; i < chunks->size; i++) {
+		size_t first = (size_t)chunks->data[i];
+		size_t end = i + 1 < chunks->size ? (size_t)chunks->data[i + 1] : count;
+		TSEE_Stream_WriteU32(stream, (Uint32)saved[first].chunk_x);
+		TSEE_Stream_WriteU32(stream, (Uint32)saved[first].chunk_y);
+		TSEE_Stream_WriteU64(stream, first);
+		TSEE_Stream_WriteU64(stream, end - first);
+	}
+	TSEE_Stream_Align(stream, TSEE_MAP_ALIGNMENT);
+	Uint32 words[TSEE_MAP_RECORD_BATCH];
+	size_t wordCount = 0;
+	for (size_t i = 0; i < count + prefabCount; i++) {
+		TSEE_Object_Attributes attributes;
+		const Uint32 *fields;
+		if (i < count) {
+			if (saved[i].prefab != TSEE_MAP_NO_PREFAB) continue;
+			attributes = saved[i].record.attributes;
+			fields = &snapshot->components[saved[i].record.components];
+		} else {
+			attributes = prefabs[i - count].attributes;
+			fields = &snapshot->components[prefabs[i - count].components];
+		}
+		for (size_t f = TSEE_Component_CountFields(attributes); f > 0; f--) {
+			words[wordCount++] = SDL_SwapLE32(*fields++);
+			if (wordCount == TSEE_MAP_RECORD_BATCH) {
+				TSEE_Stream_Write(stream, words, sizeof(*words) * wordCount);
+				wordCount = 0;
+			}
+		}
+	}
+	if (wordCount > 0) {
+		TSEE_Stream_Write(stream, words, sizeof(*words) * wordCount);
+	}
+	TSEE_Stream_Align(stream, TSEE_MAP_ALIGNMENT);
+	// Records are gathered in the map's byte order and written a batch at a time, the same way they're read.
+	TSEE_Map_Object batch[TSEE_MAP_RECORD_BATCH];
+	size_t batched = 0;
+	Uint64 componentOffset = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (saved[i].prefab != TSEE_MAP_NO_PREFAB) continue;
+		batch[batched] = saved[i].record;
+		batch[batched].components = componentOffset;
+		componentOffset += TSEE_Map_ComponentsSize(saved[i].record.attributes);
+		TSEE_Map_SwapObject(&batch[batched]);
+		if (++batched == TSEE_MAP_RECORD_BATCH) {
+			TSEE_Stream_Write(stream, batch, sizeof(*batch) * batched);
+			batched = 0;
+		}
+	}
+	if (batched > 0) {
+		TSEE_Stream_Write(stream, batch, sizeof(*batch) * batched);
+	}
+	for (Uint32 i = 0; i < prefabCount; i++) {
+		TSEE_Stream_WriteU32(stream, prefabs[i].texture);
+		TSEE_Stream_WriteU32(stream, prefabs[i].attributes);
+		TSEE_Stream_WriteU64(stream, componentOffset);
+		componentOffset += TSEE_Map_ComponentsSize(prefabs[i].attributes);
+		TSEE_Stream_WriteU64(stream, prefabs[i].first_instance);
+		TSEE_Stream_WriteU64(stream, prefabs[i].instance_count);
+	}
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	// TSEE_Vec2 is laid out like TSEE_Map_Instance, so the instances are already in the map's order.
+	TSEE_Stream_Write(stream, instances, sizeof(*instances) * instanceCount);
+#else
+	for (Uint64 i = 0; i < instanceCount; i++) {
+		TSEE_Stream_WriteF32(stream, instances[i].x);
+		TSEE_Stream_WriteF32(stream, instances[i].y);
+	}
+#endif
+	bool success = !stream->failed && TSEE_Stream_Tell(stream) == instancesOffset + sizeof(TSEE_Map_Instance) * instanceCount;
+	if (prefabCount > 0) {
+		TSEE_Log("Saved %zu objects as %u prefabs.\n", (size_t)instanceCount, prefabCount);
+	}
+	xfree(prefabs);
+	xfree(instances);
+	TSEE_Array_Destroy(chunks);
+	TSEE_Log("Writing %zu objects.\n", count);
+	return success;
+}
+
+/**
+ * @brief Saves the current world as a v2 map, see TSEE_Map_WriteSnapshot.
+ *
+ * @param tsee TSEE object to save.
+ * @param stream Stream to write to.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Map_SaveV2(TSEE *tsee, TSEE_Stream *stream) {
+	TSEE_Map_Snapshot *snapshot = TSEE_Map_TakeSnapshot(tsee);
+	if (!snapshot) {
+		return false;
+	}
+	bool success = TSEE_Map_WriteSnapshot(snapshot, stream);
+	TSEE_Map_FreeSnapshot(snapshot);
+	return success;
+}
\ No newline at end of file
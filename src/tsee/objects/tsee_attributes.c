@@ -19,4 +19,36 @@ bool TSEE_Attributes_Check(TSEE_Object_Attributes attr, TSEE_Object_Attributes a
  */
 void TSEE_Attributes_Set(TSEE_Object_Attributes *attr, TSEE_Object_Attributes to_set) {
 	*attr |= to_set;
+}
+
+/**
+ * @brief Adds the attributes other attributes imply, players are always physics objects.
+ * 
+ * @param attr Attributes to resolve.
+ * @return TSEE_Object_Attributes The attributes an object created with them ends up with.
+ */
+TSEE_Object_Attributes TSEE_Attributes_Resolve(TSEE_Object_Attributes attr) {
+	if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PLAYER)) {
+		TSEE_Attributes_Set(&attr, TSEE_ATTRIB_PHYS);
+	}
+	return attr;
+}
+
+/**
+ * @brief Checks an object can have a set of attributes, logging why if it can't.
+ * 
+ * @param attr Attributes to check, they're resolved first.
+ * @return true if they're valid.
+ */
+bool TSEE_Attributes_IsValid(TSEE_Object_Attributes attr) {
+	if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_PLAYER) && TSEE_Attributes_Check(attr, TSEE_ATTRIB_UI)) {
+		TSEE_Error("Cannot create object with player and UI attributes.\n");
+		return false;
+	}
+	attr = TSEE_Attributes_Resolve(attr);
+	if (TSEE_Attributes_Check(attr, TSEE_ATTRIB_UI) && TSEE_Attributes_Check(attr, TSEE_ATTRIB_PHYS)) {
+		TSEE_Error("Cannot create object with UI and physics attributes.\n");
+		return false;
+	}
+	return true;
 }
\ No newline at end of file
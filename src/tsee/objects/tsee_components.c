@@ -0,0 +1,122 @@
+#include "../tsee.h"
+
+/**
+ * @brief Gets the table of every component and the fields of it that are saved, in the order they're saved in.
+ *        Maps, scenes and snapshots read and write components through this table, so adding a field to it is enough to save it.
+ *
+ * @param count Set to the number of components.
+ * @return const TSEE_Component* The table.
+ */
+const TSEE_Component *TSEE_Component_GetAll(size_t *count) {
+	static const TSEE_Field physics[] = {
+		{"mass", TSEE_FIELD_FLOAT, offsetof(TSEE_Object, physics.mass), sizeof(float), 1, false, TSEE_Physics_SetObjectMass},
+		{"restitution", TSEE_FIELD_FLOAT, offsetof(TSEE_Object, physics.restitution), sizeof(float), 0, false, NULL},
+	};
+	static const TSEE_Field parallax[] = {
+		{"distance", TSEE_FIELD_FLOAT, offsetof(TSEE_Object, parallax.distance), sizeof(float), 1, true, TSEE_Parallax_SetDistance},
+	};
+	static const TSEE_Field text[] = {
+		{"text", TSEE_FIELD_STRING, offsetof(TSEE_Object, text.text), sizeof(char *), 0, false, NULL},
+	};
+	static const TSEE_Component components[] = {
+		{TSEE_ATTRIB_PHYS, "physics", physics, sizeof(physics) / sizeof(physics[0])},
+		{TSEE_ATTRIB_PARALLAX, "parallax", parallax, sizeof(parallax) / sizeof(parallax[0])},
+		{TSEE_ATTRIB_TEXT, "text", text, sizeof(text) / sizeof(text[0])},
+	};
+	*count = sizeof(components) / sizeof(components[0]);
+	return components;
+}
+
+/**
+ * @brief Counts the saved fields of every component a set of attributes gives an object.
+ *
+ * @param attributes TSEE_Object_Attributes OR'd together.
+ * @return size_t Number of fields.
+ */
+size_t TSEE_Component_CountFields(TSEE_Object_Attributes attributes) {
+	size_t count;
+	const TSEE_Component *components = TSEE_Component_GetAll(&count);
+	size_t fields = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (TSEE_Attributes_Check(attributes, components[i].attribute)) {
+			fields += components[i].field_count;
+		}
+	}
+	return fields;
+}
+
+/**
+ * @brief Gets a float field of an object's component.
+ *
+ * @param object Object to get it from.
+ * @param field Field to get, of type TSEE_FIELD_FLOAT.
+ * @return float The field's value.
+ */
+float TSEE_Field_GetFloat(const TSEE_Object *object, const TSEE_Field *field) {
+	float value;
+	memcpy(&value, (const char *)object + field->offset, field->size);
+	return value;
+}
+
+/**
+ * @brief Sets a float field of an object's component, through the field's setter if it has one.
+ *
+ * @param object Object to set it on.
+ * @param field Field to set, of type TSEE_FIELD_FLOAT.
+ * @param value New value.
+ */
+void TSEE_Field_SetFloat(TSEE_Object *object, const TSEE_Field *field, float value) {
+	if (field->set) {
+		field->set(object, value);
+		return;
+	}
+	memcpy((char *)object + field->offset, &value, field->size);
+}
+
+/**
+ * @brief Gets a string field of an object's component.
+ *
+ * @param object Object to get it from.
+ * @param field Field to get, of type TSEE_FIELD_STRING.
+ * @return const char* The string, NULL if it isn't set.
+ */
+const char *TSEE_Field_GetString(const TSEE_Object *object, const TSEE_Field *field) {
+	char *value;
+	memcpy(&value, (const char *)object + field->offset, field->size);
+	return value;
+}
+
+/**
+ * @brief Sets a string field of an object's component to a copy of a string.
+ *        The old string isn't freed, so only use it on objects being created.
+ *
+ * @param object Object to set it on.
+ * @param field Field to set, of type TSEE_FIELD_STRING.
+ * @param value String to copy, NULL for an empty string.
+ */
+void TSEE_Field_SetString(TSEE_Object *object, const TSEE_Field *field, const char *value) {
+	char *copy = strdup(value ? value : "");
+	memcpy((char *)object + field->offset, &copy, field->size);
+}
+
+/**
+ * @brief Frees the string fields of every component of an object that isn't in the world, like one fields are read into before they're saved.
+ *        Objects in the world free theirs with TSEE_Object_Destroy.
+ *
+ * @param object Object to free the strings of, they're set to NULL.
+ */
+void TSEE_Field_FreeStrings(TSEE_Object *object) {
+	size_t count;
+	const TSEE_Component *components = TSEE_Component_GetAll(&count);
+	for (size_t i = 0; i < count; i++) {
+		if (!TSEE_Object_CheckAttribute(object, components[i].attribute)) continue;
+		for (size_t f = 0; f < components[i].field_count; f++) {
+			const TSEE_Field *field = &components[i].fields[f];
+			char *string = field->type == TSEE_FIELD_STRING ? (char *)TSEE_Field_GetString(object, field) : NULL;
+			if (!string) continue;
+			xfree(string);
+			string = NULL;
+			memcpy((char *)object + field->offset, &string, field->size);
+		}
+	}
+}
@@ -1,7 +1,46 @@
 #include "../tsee.h"
 
+/**
+ * @brief Opens a font file, sharing its memory if it's already open.
+ *        Fonts in mounted archives are used in place.
+ * 
+ * @param tsee TSEE object to open the file in.
+ * @param path Path to the font file.
+ * @return TSEE_FontFile* or NULL on fail.
+ */
+TSEE_FontFile *TSEE_Font_OpenFile(TSEE *tsee, char *path) {
+	TSEE_FontFile *file = TSEE_HashMap_Get(tsee->font_files, path);
+	if (!file) {
+		file = xmalloc(sizeof(*file));
+		if (!TSEE_Pak_Map(tsee, path, &file->file)) {
+			xfree(file);
+			return NULL;
+		}
+		file->path = strdup(path);
+		file->references = 0;
+		TSEE_HashMap_Set(tsee->font_files, path, file);
+	}
+	file->references++;
+	return file;
+}
+
+/**
+ * @brief Releases a font file, unmapping it once no fonts use it.
+ * 
+ * @param tsee TSEE object the file is open in.
+ * @param file File to release.
+ */
+void TSEE_Font_CloseFile(TSEE *tsee, TSEE_FontFile *file) {
+	if (--file->references > 0) return;
+	TSEE_HashMap_Delete(tsee->font_files, file->path);
+	TSEE_File_Unmap(&file->file);
+	xfree(file->path);
+	xfree(file);
+}
+
 /**
  * @brief Load a font into a TSEE object
+ *        Each file is only read once, all sizes of it share the same memory.
  * 
  * @param tsee TSEE object to load the font into.
  * @param path Path to the font file.
@@ -10,18 +49,46 @@
  * @return true on success, false on fail.
  */
 bool TSEE_Font_Load(TSEE *tsee, char *path, int size, char *name) {
+	if (TSEE_HashMap_Get(tsee->font_index, name)) {
+		TSEE_Warn("Font `%s` is already loaded\n", name);
+		return false;
+	}
+	TSEE_FontFile *file = TSEE_Font_OpenFile(tsee, path);
+	if (!file) {
+		TSEE_Warn("Failed to open font file `%s`\n", path);
+		return false;
+	}
 	TSEE_Font *font = xmalloc(sizeof(*font));
-	font->font = TTF_OpenFont(path, size);
+	font->font = TTF_OpenFontRW(SDL_RWFromConstMem(file->file.data, file->file.size), 1, size);
 	if (font->font == NULL) {
 		TSEE_Warn("Failed to load font `%s` (%s)\n", path, TTF_GetError());
+		TSEE_Font_CloseFile(tsee, file);
+		xfree(font);
 		return false;
 	}
 	font->name = strdup(name);
 	font->size = size;
+	font->file = file;
+	font->glyphs = NULL;
 	TSEE_Array_Append(tsee->fonts, font);
+	TSEE_HashMap_Set(tsee->font_index, name, font);
 	return true;
 }
 
+/**
+ * @brief Frees a font and releases its file.
+ * 
+ * @param tsee TSEE object the font is in.
+ * @param font Font to free.
+ */
+void TSEE_Font_Free(TSEE *tsee, TSEE_Font *font) {
+	TSEE_GlyphCache_Destroy(font->glyphs);
+	TTF_CloseFont(font->font);
+	TSEE_Font_CloseFile(tsee, font->file);
+	xfree(font->name);
+	xfree(font);
+}
+
 /**
  * @brief Unloads a font from a TSEE object
  * 
@@ -30,18 +97,20 @@ bool TSEE_Font_Load(TSEE *tsee, char *path, int size, char *name) {
  * @return true on success, false on fail.
  */
 bool TSEE_Font_Unload(TSEE *tsee, char *name) {
+	TSEE_Font *font = TSEE_HashMap_Get(tsee->font_index, name);
+	if (!font) {
+		TSEE_Warn("Attempted to unload non-existant font `%s`\n", name);
+		return false;
+	}
 	for (size_t i = 0; i < tsee->fonts->size; i++) {
-		TSEE_Font *font = tsee->fonts->data[i];
-		if (strcmp(font->name, name) == 0) {
-			TTF_CloseFont(font->font);
-			xfree(font->name);
-			xfree(font);
+		if (tsee->fonts->data[i] == font) {
 			TSEE_Array_Delete(tsee->fonts, i);
-			return true;
+			break;
 		}
 	}
-	TSEE_Warn("Attempted to unload non-existant font `%s`\n", name);
-	return false;
+	TSEE_HashMap_Delete(tsee->font_index, name);
+	TSEE_Font_Free(tsee, font);
+	return true;
 }
 
 /**
@@ -51,16 +120,35 @@ bool TSEE_Font_Unload(TSEE *tsee, char *name) {
  * @return true on success, false on fail.
  */
 bool TSEE_Font_UnloadAll(TSEE *tsee) {
+	if (!tsee->fonts) return false;
 	for (size_t i = 0; i < tsee->fonts->size; i++) {
 		TSEE_Font *font = TSEE_Array_Get(tsee->fonts, i);
-		TTF_CloseFont(font->font);
-		xfree(font->name);
-		xfree(font);
+		TSEE_Font_Free(tsee, font);
 	}
 	TSEE_Array_Destroy(tsee->fonts);
+	TSEE_HashMap_Destroy(tsee->font_index);
+	TSEE_HashMap_Destroy(tsee->font_files);
+	tsee->fonts = NULL;
+	tsee->font_index = NULL;
+	tsee->font_files = NULL;
 	return true;
 }
 
+/**
+ * @brief Finds an already loaded font in a TSEE object by its name.
+ * 
+ * @param tsee TSEE object to find the font in.
+ * @param name Name of the font.
+ * @return TSEE_Font* 
+ */
+TSEE_Font *TSEE_Font_Find(TSEE *tsee, char *name) {
+	TSEE_Font *font = TSEE_HashMap_Get(tsee->font_index, name);
+	if (!font) {
+		TSEE_Warn("Failed to find font `%s`\n", name);
+	}
+	return font;
+}
+
 /**
  * @brief Gets an already loaded font from a TSEE object by its name.
  * 
@@ -69,12 +157,6 @@ bool TSEE_Font_UnloadAll(TSEE *tsee) {
  * @return TTF_Font* 
  */
 TTF_Font *TSEE_Font_Get(TSEE *tsee, char *name) {
-	for (size_t i = 0; i < tsee->fonts->size; i++) {
-		TSEE_Font *data = TSEE_Array_Get(tsee->fonts, i);
-		if (strcmp(data->name, name) == 0) {
-			return data->font;
-		}
-	}
-	TSEE_Warn("Failed to find font `%s`\n", name);
-	return NULL;
+	TSEE_Font *font = TSEE_Font_Find(tsee, name);
+	return font ? font->font : NULL;
 }
\ No newline at end of file
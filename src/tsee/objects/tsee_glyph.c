@@ -0,0 +1,284 @@
+#include "../tsee.h"
+
+#define TSEE_GLYPH_ATLAS_WIDTH 512
+#define TSEE_GLYPH_ATLAS_HEIGHT 128
+
+/**
+ * @brief Creates a glyph cache for a font, rasterising printable ASCII up front.
+ * 
+ * @param tsee TSEE object to create the atlas texture with.
+ * @param font Font to cache glyphs for.
+ * @return TSEE_GlyphCache* or NULL on fail.
+ */
+TSEE_GlyphCache *TSEE_GlyphCache_Create(TSEE *tsee, TSEE_Font *font) {
+	TSEE_GlyphCache *cache = xmalloc(sizeof(*cache));
+	if (!cache) {
+		return NULL;
+	}
+	memset(cache, 0, sizeof(*cache));
+	cache->height = TSEE_GLYPH_ATLAS_HEIGHT;
+	cache->surface = SDL_CreateRGBSurfaceWithFormat(0, TSEE_GLYPH_ATLAS_WIDTH, cache->height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!cache->surface) {
+		TSEE_Error("Failed to create glyph atlas surface for font `%s` (%s)\n", font->name, SDL_GetError());
+		xfree(cache);
+		return NULL;
+	}
+	cache->atlas = SDL_CreateTexture(tsee->window->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, TSEE_GLYPH_ATLAS_WIDTH, cache->height);
+	if (!cache->atlas) {
+		TSEE_Error("Failed to create glyph atlas for font `%s` (%s)\n", font->name, SDL_GetError());
+		SDL_FreeSurface(cache->surface);
+		xfree(cache);
+		return NULL;
+	}
+	SDL_SetTextureBlendMode(cache->atlas, SDL_BLENDMODE_BLEND);
+	SDL_UpdateTexture(cache->atlas, NULL, cache->surface->pixels, cache->surface->pitch);
+	font->glyphs = cache;
+	for (int ch = ' '; ch <= '~'; ch++) {
+		TSEE_GlyphCache_Load(tsee, font, ch);
+	}
+	return cache;
+}
+
+/**
+ * @brief Doubles the height of a glyph atlas, keeping the glyphs already in it.
+ * 
+ * @param tsee TSEE object which owns the atlas.
+ * @param cache Glyph cache to grow.
+ * @return true on success, false on fail.
+ */
+bool TSEE_GlyphCache_Grow(TSEE *tsee, TSEE_GlyphCache *cache) {
+	SDL_RendererInfo info;
+	int height = cache->height * 2;
+	if (SDL_GetRendererInfo(tsee->window->renderer, &info) == 0 && info.max_texture_height > 0 && height > info.max_texture_height) {
+		TSEE_Warn("Glyph atlas can't grow past %d pixels\n", info.max_texture_height);
+		return false;
+	}
+	SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, TSEE_GLYPH_ATLAS_WIDTH, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!surface) {
+		return false;
+	}
+	SDL_Texture *atlas = SDL_CreateTexture(tsee->window->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, TSEE_GLYPH_ATLAS_WIDTH, height);
+	if (!atlas) {
+		SDL_FreeSurface(surface);
+		return false;
+	}
+	SDL_SetSurfaceBlendMode(cache->surface, SDL_BLENDMODE_NONE);
+	SDL_BlitSurface(cache->surface, NULL, surface, NULL);
+	SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+	SDL_UpdateTexture(atlas, NULL, surface->pixels, surface->pitch);
+	SDL_FreeSurface(cache->surface);
+	SDL_DestroyTexture(cache->atlas);
+	cache->surface = surface;
+	cache->atlas = atlas;
+	cache->height = height;
+	return true;
+}
+
+/**
+ * @brief Rasterises a glyph into a font's atlas if it isn't there already.
+ * 
+ * @param tsee TSEE object which owns the atlas.
+ * @param font Font to load the glyph from.
+ * @param ch Character to load.
+ * @return true on success, false on fail.
+ */
+bool TSEE_GlyphCache_Load(TSEE *tsee, TSEE_Font *font, unsigned char ch) {
+	TSEE_GlyphCache *cache = font->glyphs;
+	TSEE_Glyph *glyph = &cache->glyphs[ch];
+	if (glyph->loaded) {
+		return true;
+	}
+	glyph->loaded = true;
+	glyph->rect = (SDL_Rect){0, 0, 0, 0};
+	glyph->advance = 0;
+	if (TTF_GlyphMetrics(font->font, ch, NULL, NULL, NULL, NULL, &glyph->advance) != 0) {
+		return false;
+	}
+	SDL_Surface *surf = TTF_RenderGlyph_Blended(font->font, ch, (SDL_Color){255, 255, 255, 255});
+	if (!surf) {
+		// Glyphs such as spaces have nothing to draw, only an advance.
+		return true;
+	}
+	if (cache->pen_x + surf->w > TSEE_GLYPH_ATLAS_WIDTH) {
+		cache->pen_x = 0;
+		cache->pen_y += cache->row_height + 1;
+		cache->row_height = 0;
+	}
+	while (cache->pen_y + surf->h > cache->height) {
+		if (!TSEE_GlyphCache_Grow(tsee, cache)) {
+			SDL_FreeSurface(surf);
+			return false;
+		}
+	}
+	SDL_Rect dst = {cache->pen_x, cache->pen_y, surf->w, surf->h};
+	SDL_SetSurfaceBlendMode(surf, SDL_BLENDMODE_NONE);
+	SDL_BlitSurface(surf, NULL, cache->surface, &dst);
+	SDL_FreeSurface(surf);
+	Uint8 *pixels = (Uint8 *)cache->surface->pixels + dst.y * cache->surface->pitch + dst.x * 4;
+	SDL_UpdateTexture(cache->atlas, &dst, pixels, cache->surface->pitch);
+
+	glyph->rect = dst;
+	cache->pen_x += dst.w + 1;
+	if (dst.h > cache->row_height) {
+		cache->row_height = dst.h;
+	}
+	return true;
+}
+
+/**
+ * @brief Gets the kerning between two glyphs, 0 if SDL_ttf is too old to support it.
+ * 
+ * @param font Font to get the kerning from.
+ * @param previous Previous glyph.
+ * @param ch Current glyph.
+ * @return int 
+ */
+int TSEE_GlyphCache_GetKerning(TTF_Font *font, Uint16 previous, Uint16 ch) {
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+	return TTF_GetFontKerningSizeGlyphs(font, previous, ch);
+#endif
+#endif
+	(void)font;
+	(void)previous;
+	(void)ch;
+	return 0;
+}
+
+/**
+ * @brief Destroys a glyph cache.
+ * 
+ * @param cache Glyph cache to destroy.
+ */
+void TSEE_GlyphCache_Destroy(TSEE_GlyphCache *cache) {
+	if (!cache) return;
+	SDL_DestroyTexture(cache->atlas);
+	SDL_FreeSurface(cache->surface);
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (cache->vertices)
+		xfree(cache->vertices);
+#endif
+	xfree(cache);
+}
+
+/**
+ * @brief Measures a string as TSEE_Text_Draw would draw it.
+ * 
+ * @param tsee TSEE object the font is loaded in.
+ * @param fontName Name of the font to use.
+ * @param text Text to measure.
+ * @param w Width of the text (can be NULL).
+ * @param h Height of the text (can be NULL).
+ * @return true on success, false on fail.
+ */
+bool TSEE_Text_Measure(TSEE *tsee, char *fontName, char *text, int *w, int *h) {
+	TSEE_Font *font = TSEE_Font_Find(tsee, fontName);
+	if (!font) {
+		return false;
+	}
+	if (!font->glyphs && !TSEE_GlyphCache_Create(tsee, font)) {
+		return false;
+	}
+	int width = 0;
+	Uint16 previous = 0;
+	for (unsigned char *c = (unsigned char *)text; *c; c++) {
+		TSEE_GlyphCache_Load(tsee, font, *c);
+		if (previous) {
+			width += TSEE_GlyphCache_GetKerning(font->font, previous, *c);
+		}
+		width += font->glyphs->glyphs[*c].advance;
+		previous = *c;
+	}
+	if (w) *w = width;
+	if (h) *h = TTF_FontHeight(font->font);
+	return true;
+}
+
+/**
+ * @brief Draws text from a font's glyph atlas, without creating any textures.
+ *        Use this for text which changes often, such as scores or timers.
+ * 
+ * @param tsee TSEE object to draw to.
+ * @param fontName Name of the font to use.
+ * @param text Text to draw.
+ * @param x X position of the top-left of the text.
+ * @param y Y position of the top-left of the text.
+ * @param color Colour of the text.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Text_Draw(TSEE *tsee, char *fontName, char *text, int x, int y, SDL_Color color) {
+	TSEE_Font *font = TSEE_Font_Find(tsee, fontName);
+	if (!font) {
+		return false;
+	}
+	if (!font->glyphs && !TSEE_GlyphCache_Create(tsee, font)) {
+		return false;
+	}
+	TSEE_GlyphCache *cache = font->glyphs;
+	size_t len = 0;
+	for (unsigned char *c = (unsigned char *)text; *c; c++, len++) {
+		TSEE_GlyphCache_Load(tsee, font, *c);
+	}
+	if (len == 0) {
+		return true;
+	}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (cache->vertex_capacity < len * 6) {
+		SDL_Vertex *vertices = xrealloc(cache->vertices, sizeof(*vertices) * len * 6);
+		if (!vertices) {
+			return false;
+		}
+		cache->vertices = vertices;
+		cache->vertex_capacity = len * 6;
+	}
+	float atlas_w = cache->surface->w;
+	float atlas_h = cache->surface->h;
+	int count = 0;
+	int pen_x = x;
+	Uint16 previous = 0;
+	for (unsigned char *c = (unsigned char *)text; *c; c++) {
+		TSEE_Glyph *glyph = &cache->glyphs[*c];
+		if (previous) {
+			pen_x += TSEE_GlyphCache_GetKerning(font->font, previous, *c);
+		}
+		previous = *c;
+		if (glyph->rect.w > 0) {
+			float x0 = pen_x, y0 = y, x1 = pen_x + glyph->rect.w, y1 = y + glyph->rect.h;
+			float u0 = glyph->rect.x / atlas_w, v0 = glyph->rect.y / atlas_h;
+			float u1 = (glyph->rect.x + glyph->rect.w) / atlas_w, v1 = (glyph->rect.y + glyph->rect.h) / atlas_h;
+			SDL_Vertex *v = &cache->vertices[count];
+			v[0] = (SDL_Vertex){{x0, y0}, color, {u0, v0}};
+			v[1] = (SDL_Vertex){{x1, y0}, color, {u1, v0}};
+			v[2] = (SDL_Vertex){{x0, y1}, color, {u0, v1}};
+			v[3] = (SDL_Vertex){{x1, y0}, color, {u1, v0}};
+			v[4] = (SDL_Vertex){{x1, y1}, color, {u1, v1}};
+			v[5] = (SDL_Vertex){{x0, y1}, color, {u0, v1}};
+			count += 6;
+		}
+		pen_x += glyph->advance;
+	}
+	if (count > 0 && SDL_RenderGeometry(tsee->window->renderer, cache->atlas, cache->vertices, count, NULL, 0) != 0) {
+		TSEE_Error("Failed to draw text `%s` (%s)\n", text, SDL_GetError());
+		return false;
+	}
+#else
+	SDL_SetTextureColorMod(cache->atlas, color.r, color.g, color.b);
+	SDL_SetTextureAlphaMod(cache->atlas, color.a);
+	int pen_x = x;
+	Uint16 previous = 0;
+	for (unsigned char *c = (unsigned char *)text; *c; c++) {
+		TSEE_Glyph *glyph = &cache->glyphs[*c];
+		if (previous) {
+			pen_x += TSEE_GlyphCache_GetKerning(font->font, previous, *c);
+		}
+		previous = *c;
+		if (glyph->rect.w > 0) {
+			SDL_Rect dst = {pen_x, y, glyph->rect.w, glyph->rect.h};
+			SDL_RenderCopy(tsee->window->renderer, cache->atlas, &glyph->rect, &dst);
+		}
+		pen_x += glyph->advance;
+	}
+#endif
+	return true;
+}
@@ -3,6 +3,7 @@
 bool TSEE_Object_CheckAttribute(TSEE_Object *obj, TSEE_Object_Attributes attr);
 TSEE_Object *TSEE_Object_Create(TSEE *tsee, TSEE_Texture *texture, TSEE_Object_Attributes attributes, float x, float y);
 bool TSEE_Player_Create(TSEE *tsee, TSEE_Object *pobj);
+void TSEE_Object_SetLayer(TSEE_Object *obj, TSEE_Render_Layer layer, int depth);
 bool TSEE_Object_SetPosition(TSEE *tsee, TSEE_Object *obj, float x, float y);
 bool TSEE_Object_SetPositionVec2(TSEE *tsee, TSEE_Object *obj, TSEE_Vec2 vec);
 SDL_Rect TSEE_Object_GetCollisionRect(TSEE_Object *obj, TSEE_Object *other);
@@ -14,21 +15,57 @@ void TSEE_Object_Destroy(TSEE *tsee, TSEE_Object *object, bool destroyTexture);
 
 bool TSEE_Attributes_Check(TSEE_Object_Attributes attr, TSEE_Object_Attributes attr2);
 void TSEE_Attributes_Set(TSEE_Object_Attributes *attr, TSEE_Object_Attributes to_set);
+TSEE_Object_Attributes TSEE_Attributes_Resolve(TSEE_Object_Attributes attr);
+bool TSEE_Attributes_IsValid(TSEE_Object_Attributes attr);
+
+// Components
+
+const TSEE_Component *TSEE_Component_GetAll(size_t *count);
+size_t TSEE_Component_CountFields(TSEE_Object_Attributes attributes);
+float TSEE_Field_GetFloat(const TSEE_Object *object, const TSEE_Field *field);
+void TSEE_Field_SetFloat(TSEE_Object *object, const TSEE_Field *field, float value);
+const char *TSEE_Field_GetString(const TSEE_Object *object, const TSEE_Field *field);
+void TSEE_Field_SetString(TSEE_Object *object, const TSEE_Field *field, const char *value);
+void TSEE_Field_FreeStrings(TSEE_Object *object);
+
+// Prefabs
+
+bool TSEE_Prefab_Init(TSEE_Prefab *prefab, TSEE_Texture_Asset *asset, TSEE_Object_Attributes attributes);
+size_t TSEE_Prefab_Instantiate(TSEE *tsee, const TSEE_Prefab *prefab, const TSEE_Vec2 *positions, size_t count);
 
 // Parallax
 
 TSEE_Object *TSEE_Parallax_Create(TSEE *tsee, TSEE_Texture *texture, float distanceFromCamera);
 TSEE_Object *TSEE_Parallax_CreateFromObject(TSEE *tsee, TSEE_Object *obj, float distanceFromCamera);
+void TSEE_Parallax_SetDistance(TSEE_Object *parallax, float distanceFromCamera);
+bool TSEE_Parallax_CreateStrip(TSEE *tsee, TSEE_Object *parallax);
+void TSEE_Parallax_ResetStrips(TSEE *tsee);
 bool TSEE_Parallax_Render(TSEE *tsee, TSEE_Object *parallax);
 void TSEE_Parallax_Destroy(TSEE *tsee, TSEE_Object *para, bool destroyTexture);
 
 // Text
 
 bool TSEE_Object_Init(TSEE *tsee, bool loadDefault);
+TSEE_FontFile *TSEE_Font_OpenFile(TSEE *tsee, char *path);
+void TSEE_Font_CloseFile(TSEE *tsee, TSEE_FontFile *file);
 bool TSEE_Font_Load(TSEE *tsee, char *path, int size, char *name);
+void TSEE_Font_Free(TSEE *tsee, TSEE_Font *font);
 bool TSEE_Font_Unload(TSEE *tsee, char *name);
 bool TSEE_Font_UnloadAll(TSEE *tsee);
+TSEE_Font *TSEE_Font_Find(TSEE *tsee, char *name);
 TTF_Font *TSEE_Font_Get(TSEE *tsee, char *name);
 TSEE_Object *TSEE_Text_Create(TSEE *tsee, char *fontName, char *text, SDL_Color color);
+bool TSEE_Text_Rasterise(TSEE *tsee, TSEE_Object *textObj);
+bool TSEE_Text_Set(TSEE *tsee, TSEE_Object *textObj, char *text);
 bool TSEE_Text_Render(TSEE *tsee, TSEE_Object *text);
-void TSEE_Text_Destroy(TSEE *tsee, TSEE_Object *text, bool destroyTexture);
\ No newline at end of file
+void TSEE_Text_Destroy(TSEE *tsee, TSEE_Object *text, bool destroyTexture);
+
+// Glyphs
+
+TSEE_GlyphCache *TSEE_GlyphCache_Create(TSEE *tsee, TSEE_Font *font);
+bool TSEE_GlyphCache_Grow(TSEE *tsee, TSEE_GlyphCache *cache);
+bool TSEE_GlyphCache_Load(TSEE *tsee, TSEE_Font *font, unsigned char ch);
+int TSEE_GlyphCache_GetKerning(TTF_Font *font, Uint16 previous, Uint16 ch);
+void TSEE_GlyphCache_Destroy(TSEE_GlyphCache *cache);
+bool TSEE_Text_Measure(TSEE *tsee, char *fontName, char *text, int *w, int *h);
+bool TSEE_Text_Draw(TSEE *tsee, char *fontName, char *text, int x, int y, SDL_Color color);
\ No newline at end of file
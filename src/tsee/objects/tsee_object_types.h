@@ -18,10 +18,16 @@ typedef struct TSEE_Physics_Data {
 
 typedef struct TSEE_Parallax_Data {
 	float distance;
+	SDL_Texture *strip; // Pre-tiled copy of the texture at least one screen wide, NULL if not needed.
+	int strip_width;
 } TSEE_Parallax_Data;
 
 typedef struct TSEE_Text_Data {
 	char *text;
+	char *font; // Name of the font it's rasterised with, looked up each time so unloading the font can't leave it dangling. NULL if it has none
+	SDL_Color color;
+	int capacity_w; // Size of the streaming texture, which can be larger than the text.
+	int capacity_h;
 } TSEE_Text_Data;
 
 // TSEE's Object type, keeps track of texture and position.
@@ -30,16 +36,86 @@ typedef struct TSEE_Object {
 	TSEE_Vec2 position;
 	TSEE_Vec2 render_position;
 	TSEE_Object_Attributes attributes;
-	union {
-		TSEE_Physics_Data physics;
-		TSEE_Parallax_Data parallax;
-		TSEE_Text_Data text;
-	};
+	TSEE_Render_Layer layer;
+	int depth;
+	struct TSEE_MapStream_Chunk *chunk; // Chunk of a streamed map it was loaded from, NULL otherwise
+	// Each component is only used if the object has its attribute
+	TSEE_Physics_Data physics;
+	TSEE_Parallax_Data parallax;
+	TSEE_Text_Data text;
 } TSEE_Object;
 
+// What every object made from a prefab shares. Instances copy the template and draw the prefab's asset.
+typedef struct TSEE_Prefab {
+	TSEE_Texture_Asset *asset;
+	TSEE_Object object; // Template for the instances, their texture and position are set per instance
+} TSEE_Prefab;
+
+// How a component's field is stored in the object.
+typedef enum TSEE_Field_Type {
+	TSEE_FIELD_FLOAT,
+	TSEE_FIELD_STRING, // char *, owned by the object
+} TSEE_Field_Type;
+
+// Sets a float field for fields that need more than the value stored, like TSEE_Parallax_SetDistance.
+typedef void (*TSEE_Field_Setter)(TSEE_Object *object, float value);
+
+// A field of a component that's saved with its object, in the order the component's fields are saved in.
+typedef struct TSEE_Field {
+	const char *name; // Key of the field in scenes
+	TSEE_Field_Type type;
+	size_t offset; // Offset from the start of the object
+	size_t size;
+	float fallback; // Value of a float field a scene leaves out
+	bool positive; // Float field that has to be greater than 0
+	TSEE_Field_Setter set; // NULL to store the value as it is
+} TSEE_Field;
+
+// The data an attribute gives an object, with the fields of it that are saved.
+// Every component has its own storage in the object, so an object can have any of them.
+typedef struct TSEE_Component {
+	TSEE_Object_Attributes attribute;
+	const char *name;
+	const TSEE_Field *fields;
+	size_t field_count;
+} TSEE_Component;
+
+#define TSEE_GLYPH_COUNT 256
+
+// A glyph rasterised into a glyph atlas.
+typedef struct TSEE_Glyph {
+	SDL_Rect rect; // Where the glyph is in the atlas
+	int advance;
+	bool loaded;
+} TSEE_Glyph;
+
+// Atlas of every glyph used from one font, rasterised once and drawn as batched quads.
+typedef struct TSEE_GlyphCache {
+	SDL_Texture *atlas;
+	SDL_Surface *surface; // CPU copy of the atlas, used to add glyphs and grow it.
+	int pen_x;
+	int pen_y;
+	int row_height;
+	int height;
+	TSEE_Glyph glyphs[TSEE_GLYPH_COUNT];
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	SDL_Vertex *vertices; // Reused between draws
+	size_t vertex_capacity;
+#endif
+} TSEE_GlyphCache;
+
+// A font file's contents, mapped once and shared by every size loaded from it.
+typedef struct TSEE_FontFile {
+	char *path;
+	TSEE_MappedFile file;
+	int references;
+} TSEE_FontFile;
+
 // TSEE fonts, stores the font, its name and size.
 typedef struct TSEE_Font {
 	TTF_Font *font;
 	char *name;
 	int size;
+	TSEE_FontFile *file;
+	TSEE_GlyphCache *glyphs; // Created on first use by TSEE_Text_Draw
 } TSEE_Font;
\ No newline at end of file
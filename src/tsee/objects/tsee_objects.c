@@ -22,21 +22,19 @@ bool TSEE_Object_CheckAttribute(TSEE_Object *obj, TSEE_Object_Attributes attr) {
  * @return TSEE_Object* or NULL
  */
 TSEE_Object *TSEE_Object_Create(TSEE *tsee, TSEE_Texture *texture, TSEE_Object_Attributes attributes, float x, float y) {
-	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_UI) && TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PHYS)) {
-		TSEE_Error("Cannot create object with UI and physics attributes.\n");
+	if (!TSEE_Attributes_IsValid(attributes)) {
 		return NULL;
 	}
+	attributes = TSEE_Attributes_Resolve(attributes);
 	TSEE_Object *obj = xmalloc(sizeof(*obj));
+	// Components it doesn't have are left zeroed.
+	memset(obj, 0, sizeof(*obj));
 	obj->texture = texture;
+	obj->chunk = NULL;
+	obj->attributes = TSEE_ATTRIB_NONE;
 	TSEE_Object_SetPosition(tsee, obj, x, y);
 
 	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PLAYER)) {
-		if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_UI)) {
-			TSEE_Error("Cannot create object with player and UI attributes.\n");
-			xfree(obj);
-			return NULL;
-		}
-		TSEE_Attributes_Set(&attributes, TSEE_ATTRIB_PHYS);
 		tsee->player->object = obj;
 		tsee->player->movement = (TSEE_Player_Movement){0, 0, 0, 0};
 	}
@@ -48,14 +46,47 @@ TSEE_Object *TSEE_Object_Create(TSEE *tsee, TSEE_Texture *texture, TSEE_Object_A
 		obj->physics.force = (TSEE_Vec2){0, 0};
 	}
 
+	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PARALLAX)) {
+		TSEE_Parallax_SetDistance(obj, 1);
+		obj->parallax.strip = NULL;
+		obj->parallax.strip_width = texture->rect.w;
+	}
+
+	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_TEXT)) {
+		// Drawn from its texture, it has no font to change the text with.
+		obj->text.text = NULL;
+		obj->text.font = NULL;
+		obj->text.color = (SDL_Color){255, 255, 255, 255};
+		obj->text.capacity_w = 0;
+		obj->text.capacity_h = 0;
+	}
+
 	obj->attributes = attributes;
+	if (!TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PARALLAX)) {
+		TSEE_Object_SetLayer(obj, TSEE_Attributes_Check(attributes, TSEE_ATTRIB_UI) ? TSEE_LAYER_UI : TSEE_LAYER_WORLD, 0);
+	}
 
-	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PARALLAX) && tsee->world->objects->size > 0) TSEE_Array_Insert(tsee->world->objects, obj, 0);
-	else TSEE_Array_Append(tsee->world->objects, obj);
+	TSEE_Array_Append(tsee->world->objects, obj);
+	if (TSEE_Physics_IsStaticCollider(obj)) {
+		tsee->world->colliders_valid = false;
+	}
 
 	return obj;
 }
 
+/**
+ * @brief Sets the layer and depth an object is drawn at.
+ *        Objects are drawn by layer, then depth (lowest first), then grouped by texture.
+ * 
+ * @param obj Object to set
+ * @param layer Layer to draw the object in
+ * @param depth Depth inside the layer, clamped to a 16-bit range
+ */
+void TSEE_Object_SetLayer(TSEE_Object *obj, TSEE_Render_Layer layer, int depth) {
+	obj->layer = layer;
+	obj->depth = depth;
+}
+
 /**
  * @brief Set the position of an object
  * 
@@ -75,6 +106,10 @@ bool TSEE_Object_SetPosition(TSEE *tsee, TSEE_Object *obj, float x, float y) {
 	}
 	obj->position.x = x;
 	obj->position.y = y;
+	if (TSEE_Physics_IsStaticCollider(obj)) {
+		// Static objects are collided with through the world's merged colliders, which need rebuilding.
+		tsee->world->colliders_valid = false;
+	}
 
 	obj->texture->rect.x = x - tsee->world->scroll_x;
 	obj->texture->rect.y = y * -1 + tsee->window->height - tsee->world->scroll_y;
@@ -119,20 +154,25 @@ SDL_Rect TSEE_Object_GetRect(TSEE_Object *obj) {
 
 /**
  * @brief Renders an object
+ *        Only text with its own streaming texture is drawn as text, text loaded from maps is an image like any other object.
  * 
  * @param tsee TSEE to render to
  * @param object Object to render
  * @return true on success, false on fail
  */
 bool TSEE_Object_Render(TSEE *tsee, TSEE_Object *object) {
-	if (!TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX)) {
+	if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_TEXT) && !object->texture->asset) {
+		return TSEE_Text_Render(tsee, object);
+	} else if (!TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX)) {
 		Uint64 start = 0;
 		if (tsee->debug->active) {
 			start = SDL_GetPerformanceCounter();
 		}
+		if (!TSEE_Texture_Use(tsee, object->texture)) {
+			return true;
+		}
 		SDL_Rect rect = TSEE_Object_GetRect(object);
-		int ret = SDL_RenderCopy(tsee->window->renderer, object->texture->texture, NULL, &rect);
-		if (ret != 0) {
+		if (!TSEE_Texture_Render(tsee, object->texture, NULL, &rect)) {
 			TSEE_Error("Failed to render object (%s)\n", SDL_GetError());
 			return false;
 		}
@@ -159,7 +199,15 @@ void TSEE_Object_Destroy(TSEE *tsee, TSEE_Object *object, bool destroyTexture) {
 		TSEE_Texture_Destroy(tsee, object->texture);
 	}
 	if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_TEXT)) {
-		xfree(object->text.text);
+		if (object->text.text) {
+			xfree(object->text.text);
+		}
+		if (object->text.font) {
+			xfree(object->text.font);
+		}
+	}
+	if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PARALLAX) && object->parallax.strip) {
+		SDL_DestroyTexture(object->parallax.strip);
 	}
 	xfree(object);
 }
\ No newline at end of file
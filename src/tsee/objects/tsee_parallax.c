@@ -19,24 +19,30 @@ TSEE_Object *TSEE_Parallax_Create(TSEE *tsee, TSEE_Texture *texture, float dista
 		return NULL;
 	}
 
-	parallax->parallax.distance = distanceFromCamera;
+	TSEE_Parallax_SetDistance(parallax, distanceFromCamera);
+	parallax->parallax.strip = NULL;
+	parallax->parallax.strip_width = texture->rect.w;
 	parallax->texture->rect.y = tsee->window->height - texture->rect.h;
-
-	size_t latest_good_index = 0;
-
-	for (size_t i = 1; i < tsee->world->objects->size; i++) {
-		TSEE_Object *obj = TSEE_Array_Get(tsee->world->objects, i);
-		if (!TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PARALLAX)) continue;
-
-		if (parallax->parallax.distance < obj->parallax.distance) latest_good_index = i;
-		else break;
-	}
-
-	TSEE_Array_Delete(tsee->world->objects, 0);
-	TSEE_Array_Insert(tsee->world->objects, parallax, latest_good_index);
 	return parallax;
 }
 
+/**
+ * @brief Sets how far a parallax object is from the camera, further objects are drawn first.
+ *        Depth follows the log of the distance, so every positive distance fits the render key's 16 bits
+ *        and distances that differ by more than about half a percent are always ordered.
+ * 
+ * @param parallax Parallax object to change.
+ * @param distanceFromCamera Distance from the camera to the object.
+ */
+void TSEE_Parallax_SetDistance(TSEE_Object *parallax, float distanceFromCamera) {
+	parallax->parallax.distance = distanceFromCamera;
+	// log2 of a positive float is within [-149, 128], 128 steps per doubling keeps that inside 16 bits.
+	float depth = log2f(distanceFromCamera) * 128;
+	if (!(depth > -32768)) depth = -32768;
+	if (depth > 32767) depth = 32767;
+	TSEE_Object_SetLayer(parallax, TSEE_LAYER_BACKGROUND, -(int)lroundf(depth));
+}
+
 /**
  * @brief Create a parallax object from another object.
  * 
@@ -49,8 +55,89 @@ TSEE_Object *TSEE_Parallax_CreateFromObject(TSEE *tsee, TSEE_Object *obj, float
 	return TSEE_Parallax_Create(tsee, obj->texture, distanceFromCamera);
 }
 
+/**
+ * @brief Pre-tiles a narrow parallax texture into a strip at least one screen wide,
+ *        so it can always be drawn with at most two copies.
+ *        Replaces any strip the object already has, which is kept if the new one can't be made.
+ * 
+ * @param tsee TSEE object the parallax is in.
+ * @param parallax Parallax object to create the strip for.
+ * @return true on success (or if no strip is needed), false on fail.
+ */
+bool TSEE_Parallax_CreateStrip(TSEE *tsee, TSEE_Object *parallax) {
+	TSEE_Texture *texture = parallax->texture;
+	if (texture->rect.w <= 0 || texture->rect.w >= tsee->window->width) {
+		return true;
+	}
+	if (!TSEE_Texture_Use(tsee, texture) || TSEE_Texture_IsLoading(tsee, texture)) {
+		return false;
+	}
+	if (texture->asset && texture->asset->tiles) {
+		// Tiled images are only drawn where they're on screen, a strip would upload all of them.
+		return true;
+	}
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(tsee->window->renderer, &info) != 0 || !(info.flags & SDL_RENDERER_TARGETTEXTURE)) {
+		return false;
+	}
+	int copies = (tsee->window->width + texture->rect.w - 1) / texture->rect.w;
+	int width = copies * texture->rect.w;
+	if (info.max_texture_width > 0 && width > info.max_texture_width) {
+		return false;
+	}
+	Uint32 format;
+	if (SDL_QueryTexture(texture->texture, &format, NULL, NULL, NULL) != 0) {
+		return false;
+	}
+	SDL_Texture *strip = SDL_CreateTexture(tsee->window->renderer, format, SDL_TEXTUREACCESS_TARGET, width, texture->rect.h);
+	if (!strip) {
+		return false;
+	}
+
+	// Copy the texture as-is, blending onto the cleared strip would premultiply its alpha.
+	SDL_BlendMode blend;
+	SDL_GetTextureBlendMode(texture->texture, &blend);
+	SDL_SetTextureBlendMode(texture->texture, SDL_BLENDMODE_NONE);
+	SDL_Texture *target = SDL_GetRenderTarget(tsee->window->renderer);
+	SDL_SetRenderTarget(tsee->window->renderer, strip);
+	SDL_SetRenderDrawColor(tsee->window->renderer, 0, 0, 0, 0);
+	SDL_RenderClear(tsee->window->renderer);
+	for (int i = 0; i < copies; i++) {
+		SDL_Rect dst = {i * texture->rect.w, 0, texture->rect.w, texture->rect.h};
+		SDL_RenderCopy(tsee->window->renderer, texture->texture, NULL, &dst);
+	}
+	SDL_SetRenderTarget(tsee->window->renderer, target);
+	SDL_SetTextureBlendMode(texture->texture, blend);
+	SDL_SetTextureBlendMode(strip, blend);
+
+	if (parallax->parallax.strip) {
+		SDL_DestroyTexture(parallax->parallax.strip);
+	}
+	parallax->parallax.strip = strip;
+	parallax->parallax.strip_width = width;
+	return true;
+}
+
+/**
+ * @brief Drops every parallax strip, so they're built again the next time they're rendered.
+ *        Needed when the renderer loses the contents of its target textures.
+ * 
+ * @param tsee TSEE object whose parallax objects to reset.
+ */
+void TSEE_Parallax_ResetStrips(TSEE *tsee) {
+	for (size_t i = 0; i < tsee->world->objects->size; i++) {
+		TSEE_Object *obj = tsee->world->objects->data[i];
+		if (TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PARALLAX) && obj->parallax.strip) {
+			SDL_DestroyTexture(obj->parallax.strip);
+			obj->parallax.strip = NULL;
+			obj->parallax.strip_width = obj->texture->rect.w;
+		}
+	}
+}
+
 /**
  * @brief Renders a parallax object in a TSEE object.
+ *        The offset is found with modulo arithmetic, so the cost doesn't depend on how far the camera has scrolled.
  * 
  * @param tsee TSEE object to render.
  * @param parallax Parallax object to render.
@@ -65,24 +152,35 @@ bool TSEE_Parallax_Render(TSEE *tsee, TSEE_Object *parallax) {
 		TSEE_Error("Attempted to parallax render a non parallax object.\n");
 		return false;
 	}
-	parallax->texture->rect.x = tsee->world->scroll_x * (-1 / parallax->parallax.distance);
-	while (parallax->texture->rect.x > tsee->window->width) {
-		parallax->texture->rect.x -= tsee->window->width;
+	if (!parallax->parallax.strip || parallax->parallax.strip_width < tsee->window->width) {
+		// Built here rather than on creation, the texture may still be loading or the window may have grown since.
+		// If it can't be made yet the texture is drawn in repeated copies instead.
+		TSEE_Parallax_CreateStrip(tsee, parallax);
 	}
-	while (parallax->texture->rect.x + parallax->texture->rect.w < 0) {
-		parallax->texture->rect.x += tsee->window->width;
+	SDL_Texture *strip = parallax->parallax.strip;
+	int width = parallax->texture->rect.w;
+	if (strip) {
+		width = parallax->parallax.strip_width;
+	} else if (!TSEE_Texture_Use(tsee, parallax->texture)) {
+		return true;
 	}
-	while (parallax->texture->rect.x > 0) {
-		parallax->texture->rect.x -= parallax->texture->rect.w;
+	if (width <= 0) {
+		return true;
 	}
-	if (SDL_RenderCopy(tsee->window->renderer, parallax->texture->texture, NULL, &parallax->texture->rect) != 0) {
-		return false;
-	};
-	while (parallax->texture->rect.x + parallax->texture->rect.w < tsee->window->width) {
-		parallax->texture->rect.x += parallax->texture->rect.w;
-		if (SDL_RenderCopy(tsee->window->renderer, parallax->texture->texture, NULL, &parallax->texture->rect) != 0) {
+	float offset = fmodf(tsee->world->scroll_x / parallax->parallax.distance, width);
+	if (offset < 0) {
+		offset += width;
+	}
+	parallax->texture->rect.x = -(int)offset;
+	parallax->texture->rect.y = tsee->window->height - parallax->texture->rect.h - tsee->world->scroll_y / parallax->parallax.distance;
+
+	// Strips are at least a screen wide, so this is at most two copies. Tiled images only draw their tiles on screen.
+	SDL_Rect dst = {parallax->texture->rect.x, parallax->texture->rect.y, width, parallax->texture->rect.h};
+	for (; dst.x < tsee->window->width; dst.x += width) {
+		bool drawn = strip ? SDL_RenderCopy(tsee->window->renderer, strip, NULL, &dst) == 0 : TSEE_Texture_Render(tsee, parallax->texture, NULL, &dst);
+		if (!drawn) {
 			return false;
-		};
+		}
 	}
 	if (tsee->debug->active) {
 		Uint64 end = SDL_GetPerformanceCounter();
@@ -98,6 +196,9 @@ bool TSEE_Parallax_Render(TSEE *tsee, TSEE_Object *parallax) {
  * @param destroyTexture Whether to destroy the texture or not.
  */
 void TSEE_Parallax_Destroy(TSEE *tsee, TSEE_Object *para, bool destroyTexture) {
+	if (para->parallax.strip) {
+		SDL_DestroyTexture(para->parallax.strip);
+	}
 	if (destroyTexture) {
 		TSEE_Texture_Destroy(tsee, para->texture);
 	}
@@ -0,0 +1,68 @@
+#include "../tsee.h"
+
+/**
+ * @brief Sets up a prefab, objects with the same texture and attributes that are created in bulk.
+ *        Physics prefabs start with a mass of 1, set prefab->object.physics to change it for every instance.
+ *        Players, parallax and text objects need their own data, so they can't be prefabs.
+ *
+ * @param prefab Prefab to set up.
+ * @param asset Asset every instance draws, or NULL to set it later.
+ * @param attributes TSEE_Object_Attributes OR'd together.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Prefab_Init(TSEE_Prefab *prefab, TSEE_Texture_Asset *asset, TSEE_Object_Attributes attributes) {
+	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PLAYER | TSEE_ATTRIB_PARALLAX | TSEE_ATTRIB_TEXT)) {
+		TSEE_Error("Prefabs can't be players, parallax or text objects.\n");
+		return false;
+	}
+	if (!TSEE_Attributes_IsValid(attributes)) {
+		return false;
+	}
+	memset(prefab, 0, sizeof(*prefab));
+	prefab->asset = asset;
+	prefab->object.attributes = attributes;
+	if (TSEE_Attributes_Check(attributes, TSEE_ATTRIB_PHYS)) {
+		prefab->object.physics.mass = 1;
+		prefab->object.physics.inv_mass = 1;
+	}
+	TSEE_Object_SetLayer(&prefab->object, TSEE_Attributes_Check(attributes, TSEE_ATTRIB_UI) ? TSEE_LAYER_UI : TSEE_LAYER_WORLD, 0);
+	return true;
+}
+
+/**
+ * @brief Creates many instances of a prefab at once. The world's objects, the textures and the asset's users
+ *        are reserved once for all of them, and each instance is a copy of the prefab's template, so nothing is looked up per object.
+ *
+ * @param tsee TSEE object to create the instances in.
+ * @param prefab Prefab to instantiate, its asset must be set.
+ * @param positions Position of each instance.
+ * @param count Number of instances.
+ * @return size_t Number of instances created, less than count if memory ran out.
+ */
+size_t TSEE_Prefab_Instantiate(TSEE *tsee, const TSEE_Prefab *prefab, const TSEE_Vec2 *positions, size_t count) {
+	TSEE_Texture_Asset *asset = prefab->asset;
+	if (!asset) {
+		TSEE_Error("Attempted to instantiate a prefab with no asset.\n");
+		return 0;
+	}
+	TSEE_Array_Reserve(tsee->world->objects, tsee->world->objects->size + count);
+	TSEE_Array_Reserve(tsee->textures, tsee->textures->size + count);
+	TSEE_Array_Reserve(asset->users, asset->users->size + count);
+	size_t created = 0;
+	for (; created < count; created++) {
+		TSEE_Texture *texture = TSEE_Texture_CreateFromAsset(tsee, asset);
+		if (!texture) {
+			break;
+		}
+		TSEE_Object *object = xmalloc(sizeof(*object));
+		if (!object) {
+			TSEE_Texture_Destroy(tsee, texture);
+			break;
+		}
+		*object = prefab->object;
+		object->texture = texture;
+		TSEE_Object_SetPosition(tsee, object, positions[created].x, positions[created].y);
+		TSEE_Array_Append(tsee->world->objects, object);
+	}
+	return created;
+}
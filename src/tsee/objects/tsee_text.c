@@ -16,6 +16,8 @@ bool TSEE_Object_Init(TSEE *tsee, bool loadDefault) {
 		return false;
 	}
 	tsee->fonts = TSEE_Array_Create();
+	tsee->font_index = TSEE_HashMap_Create();
+	tsee->font_files = TSEE_HashMap_Create();
 	if (loadDefault) {
 		if (TSEE_Font_Load(tsee, "fonts/default.ttf", 16, "_default")) {
 			tsee->init->text = true;
@@ -39,30 +41,147 @@ bool TSEE_Object_Init(TSEE *tsee, bool loadDefault) {
  * @return TSEE_Object* 
  */
 TSEE_Object *TSEE_Text_Create(TSEE *tsee, char *fontName, char *text, SDL_Color color) {
-	TSEE_Object *textObj = xmalloc(sizeof(*textObj));
 	TTF_Font *font = TSEE_Font_Get(tsee, fontName);
 	if (!font) {
 		TSEE_Warn("Failed to create text `%s` with font `%s` (Failed to get font)\n", text, fontName);
 		return NULL;
 	}
+	TSEE_Object *textObj = xmalloc(sizeof(*textObj));
+	// Zeroed like TSEE_Object_Create's objects, so the components and fields it doesn't set are empty.
+	memset(textObj, 0, sizeof(*textObj));
 	textObj->text.text = strdup(text);
+	textObj->text.font = strdup(fontName);
+	textObj->text.color = color;
+	textObj->text.capacity_w = 0;
+	textObj->text.capacity_h = 0;
 	textObj->texture = xmalloc(sizeof(*textObj->texture));
+	textObj->texture->texture = NULL;
 	textObj->texture->path = NULL;
-	SDL_Surface *surf = TTF_RenderText_Blended(font, text, color);
-	if (!surf) {
-		TSEE_Warn("Failed to create text `%s` with font `%s` (Failed to create surface)\n", text, fontName);
+	textObj->texture->asset = NULL;
+	textObj->texture->id = ++tsee->last_texture_id;
+	textObj->texture->rect = (SDL_Rect){0, 0, 0, 0};
+	textObj->attributes = TSEE_ATTRIB_TEXT | TSEE_ATTRIB_UI;
+	textObj->layer = TSEE_LAYER_UI;
+	textObj->depth = 0;
+	if (!TSEE_Text_Rasterise(tsee, textObj)) {
+		TSEE_Warn("Failed to create text `%s` with font `%s` (Failed to create texture)\n", text, fontName);
+		xfree(textObj->text.text);
+		xfree(textObj->text.font);
+		xfree(textObj->texture);
+		xfree(textObj);
 		return NULL;
 	}
-	textObj->texture->texture = SDL_CreateTextureFromSurface(tsee->window->renderer, surf);
-	textObj->texture->rect.x = 0;
-	textObj->texture->rect.y = 0;
-	textObj->attributes = TSEE_ATTRIB_TEXT | TSEE_ATTRIB_UI;
-	SDL_QueryTexture(textObj->texture->texture, NULL, NULL, &textObj->texture->rect.w, &textObj->texture->rect.h);
-	SDL_FreeSurface(surf);
 	TSEE_Array_Append(tsee->textures, textObj->texture);
 	return textObj;
 }
 
+/**
+ * @brief Rasterises a text object's string into its streaming texture, with the font it was created with.
+ *        The texture is only recreated when the text outgrows it.
+ * 
+ * @param tsee TSEE object the text is in.
+ * @param textObj Text object to rasterise.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Text_Rasterise(TSEE *tsee, TSEE_Object *textObj) {
+	TTF_Font *font = textObj->text.font ? TSEE_Font_Get(tsee, textObj->text.font) : NULL;
+	if (!font) {
+		TSEE_Warn("Failed to render text `%s` (Font `%s` isn't loaded)\n", textObj->text.text, textObj->text.font ? textObj->text.font : "");
+		return false;
+	}
+	if (textObj->text.text[0] == '\0') {
+		// SDL_ttf can't render empty strings, there's nothing to draw anyway.
+		textObj->texture->rect.w = 0;
+		textObj->texture->rect.h = TTF_FontHeight(font);
+		return true;
+	}
+	SDL_Surface *rendered = TTF_RenderText_Blended(font, textObj->text.text, textObj->text.color);
+	if (!rendered) {
+		TSEE_Warn("Failed to render text `%s` (%s)\n", textObj->text.text, TTF_GetError());
+		return false;
+	}
+	SDL_Surface *surf = rendered;
+	if (rendered->format->format != SDL_PIXELFORMAT_ARGB8888) {
+		surf = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(rendered);
+		if (!surf) {
+			TSEE_Warn("Failed to convert text `%s` (%s)\n", textObj->text.text, SDL_GetError());
+			return false;
+		}
+	}
+
+	if (!textObj->texture->texture || surf->w > textObj->text.capacity_w || surf->h > textObj->text.capacity_h) {
+		// Leave headroom so small changes, like a counter gaining a digit, don't reallocate.
+		int width = (surf->w + surf->w / 2 + 31) & ~31;
+		int height = (surf->h + 7) & ~7;
+		SDL_Texture *texture = SDL_CreateTexture(tsee->window->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+		if (!texture) {
+			TSEE_Warn("Failed to create texture for text `%s` (%s)\n", textObj->text.text, SDL_GetError());
+			SDL_FreeSurface(surf);
+			return false;
+		}
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		if (textObj->texture->texture) {
+			SDL_DestroyTexture(textObj->texture->texture);
+		}
+		textObj->texture->texture = texture;
+		textObj->text.capacity_w = width;
+		textObj->text.capacity_h = height;
+	}
+
+	void *pixels;
+	int pitch;
+	SDL_Rect area = {0, 0, surf->w, surf->h};
+	if (SDL_LockTexture(textObj->texture->texture, &area, &pixels, &pitch) != 0) {
+		TSEE_Warn("Failed to lock texture for text `%s` (%s)\n", textObj->text.text, SDL_GetError());
+		SDL_FreeSurface(surf);
+		return false;
+	}
+	for (int y = 0; y < surf->h; y++) {
+		memcpy((Uint8 *)pixels + y * pitch, (Uint8 *)surf->pixels + y * surf->pitch, surf->w * 4);
+	}
+	SDL_UnlockTexture(textObj->texture->texture);
+
+	textObj->texture->rect.w = surf->w;
+	textObj->texture->rect.h = surf->h;
+	SDL_FreeSurface(surf);
+	return true;
+}
+
+/**
+ * @brief Changes the text of a text object, reusing its texture where possible.
+ *        Only text created with TSEE_Text_Create can be changed, text loaded from maps has no font.
+ * 
+ * @param tsee TSEE object the text is in.
+ * @param textObj Text object to change.
+ * @param text New text to display.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Text_Set(TSEE *tsee, TSEE_Object *textObj, char *text) {
+	if (!TSEE_Object_CheckAttribute(textObj, TSEE_ATTRIB_TEXT)) return false;
+	if (!textObj->text.font) {
+		TSEE_Warn("Can't set text `%s`, the object has no font to render it with.\n", text);
+		return false;
+	}
+	if (strcmp(textObj->text.text, text) == 0) {
+		return true;
+	}
+	char *newText = strdup(text);
+	if (!newText) {
+		return false;
+	}
+	char *oldText = textObj->text.text;
+	textObj->text.text = newText;
+	if (!TSEE_Text_Rasterise(tsee, textObj)) {
+		// Keep the text the texture still shows, so setting the new text again retries it.
+		textObj->text.text = oldText;
+		xfree(newText);
+		return false;
+	}
+	xfree(oldText);
+	return true;
+}
+
 /**
  * @brief Destroy a text object.
  * 
@@ -75,6 +194,9 @@ void TSEE_Text_Destroy(TSEE *tsee, TSEE_Object *text, bool destroyTexture) {
 		TSEE_Texture_Destroy(tsee, text->texture);
 	}
 	xfree(text->text.text);
+	if (text->text.font) {
+		xfree(text->text.font);
+	}
 	xfree(text);
 }
 
@@ -91,7 +213,12 @@ bool TSEE_Text_Render(TSEE *tsee, TSEE_Object *text) {
 		TSEE_Warn("Failed to render text `%s` (No texture)\n", text->text.text);
 		return false;
 	}
-	if (SDL_RenderCopy(tsee->window->renderer, text->texture->texture, NULL, &text->texture->rect) != 0) {
+	if (text->texture->rect.w == 0) {
+		return true;
+	}
+	// The texture can be larger than the text, only copy the part with text in.
+	SDL_Rect src = {0, 0, text->texture->rect.w, text->texture->rect.h};
+	if (SDL_RenderCopy(tsee->window->renderer, text->texture->texture, &src, &text->texture->rect) != 0) {
 		TSEE_Error("Failed to render text `%s` (%s)\n", text->text.text, SDL_GetError());
 		return false;
 	}
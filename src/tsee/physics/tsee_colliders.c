@@ -0,0 +1,163 @@
+#include "../tsee.h"
+
+/**
+ * @brief Checks if an object is solid and never moves, so it can be merged into the world's static colliders.
+ *
+ * @param obj Object to check.
+ * @return true if it's static and not a physics, player, parallax, text or UI object.
+ */
+bool TSEE_Physics_IsStaticCollider(TSEE_Object *obj) {
+	return TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_STATIC) && !TSEE_Object_CheckAttribute(obj, TSEE_ATTRIB_PHYS | TSEE_ATTRIB_PLAYER | TSEE_ATTRIB_PARALLAX | TSEE_ATTRIB_TEXT | TSEE_ATTRIB_UI);
+}
+
+/**
+ * @brief Orders colliders into rows, by top edge then height, then from left to right.
+ *
+ * @param a First TSEE_Collider.
+ * @param b Second TSEE_Collider.
+ * @return int qsort ordering.
+ */
+int TSEE_Collider_CompareRows(const void *a, const void *b) {
+	const TSEE_Collider *first = a;
+	const TSEE_Collider *second = b;
+	if (first->y != second->y) return first->y < second->y ? -1 : 1;
+	if (first->height != second->height) return first->height < second->height ? -1 : 1;
+	if (first->x != second->x) return first->x < second->x ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Orders colliders into columns, by left edge then width, then from top to bottom.
+ *
+ * @param a First TSEE_Collider.
+ * @param b Second TSEE_Collider.
+ * @return int qsort ordering.
+ */
+int TSEE_Collider_CompareColumns(const void *a, const void *b) {
+	const TSEE_Collider *first = a;
+	const TSEE_Collider *second = b;
+	if (first->x != second->x) return first->x < second->x ? -1 : 1;
+	if (first->width != second->width) return first->width < second->width ? -1 : 1;
+	if (first->y != second->y) return first->y > second->y ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Merges colliders with the same top and bottom that touch or overlap side by side.
+ *
+ * @param colliders Colliders to merge, merged in place.
+ * @param count Number of colliders.
+ * @return size_t Number of colliders left, at the start of the array.
+ */
+size_t TSEE_Collider_MergeRows(TSEE_Collider *colliders, size_t count) {
+	if (count == 0) return 0;
+	qsort(colliders, count, sizeof(*colliders), TSEE_Collider_CompareRows);
+	size_t merged = 0;
+	for (size_t i = 1; i < count; i++) {
+		TSEE_Collider *last = &colliders[merged];
+		TSEE_Collider *next = &colliders[i];
+		if (next->y == last->y && next->height == last->height && next->x <= last->x + last->width) {
+			float right = next->x + next->width;
+			if (right > last->x + last->width) {
+				last->width = right - last->x;
+			}
+		} else {
+			colliders[++merged] = *next;
+		}
+	}
+	return merged + 1;
+}
+
+/**
+ * @brief Merges colliders with the same left and right edges that touch or overlap one above the other.
+ *
+ * @param colliders Colliders to merge, merged in place.
+ * @param count Number of colliders.
+ * @return size_t Number of colliders left, at the start of the array.
+ */
+size_t TSEE_Collider_MergeColumns(TSEE_Collider *colliders, size_t count) {
+	if (count == 0) return 0;
+	qsort(colliders, count, sizeof(*colliders), TSEE_Collider_CompareColumns);
+	size_t merged = 0;
+	for (size_t i = 1; i < count; i++) {
+		TSEE_Collider *last = &colliders[merged];
+		TSEE_Collider *next = &colliders[i];
+		if (next->x == last->x && next->width == last->width && next->y >= last->y - last->height) {
+			float bottom = next->y - next->height;
+			if (bottom < last->y - last->height) {
+				last->height = last->y - bottom;
+			}
+		} else {
+			colliders[++merged] = *next;
+		}
+	}
+	return merged + 1;
+}
+
+/**
+ * @brief Merges the world's static objects into as few colliders as it can, so physics objects test a few rectangles instead of every tile.
+ *        Rows of touching or overlapping objects of the same height are merged first, then stacks of the merged rows of the same width.
+ *        The colliders cover exactly what the objects did, and the objects are still drawn as they were.
+ *        Called by TSEE_Physics_PerformStep whenever static objects have been added, moved or removed, so maps are merged once they're loaded.
+ *
+ * @param tsee TSEE whose world to build them for.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Physics_BuildColliders(TSEE *tsee) {
+	TSEE_World *world = tsee->world;
+	TSEE_Array *objects = world->objects;
+	size_t count = 0;
+	for (size_t i = 0; i < objects->size; i++) {
+		if (TSEE_Physics_IsStaticCollider(objects->data[i])) count++;
+	}
+	TSEE_Collider *colliders = xmalloc(sizeof(*colliders) * (count ? count : 1));
+	if (!colliders) {
+		return false;
+	}
+	size_t found = 0;
+	for (size_t i = 0; i < objects->size; i++) {
+		TSEE_Object *object = objects->data[i];
+		if (!TSEE_Physics_IsStaticCollider(object)) continue;
+		SDL_Rect rect = TSEE_Object_GetRect(object);
+		// Empty objects never collide, and objects at infinity can't be sorted.
+		if (rect.w <= 0 || rect.h <= 0 || !isfinite(object->position.x) || !isfinite(object->position.y)) continue;
+		colliders[found++] = (TSEE_Collider){object->position.x, object->position.y, rect.w, rect.h};
+	}
+	size_t merged = TSEE_Collider_MergeColumns(colliders, TSEE_Collider_MergeRows(colliders, found));
+	TSEE_Physics_FreeColliders(world);
+	world->colliders = colliders;
+	world->collider_count = merged;
+	world->colliders_valid = true;
+	TSEE_Log("Merged %zu static objects into %zu colliders.\n", found, merged);
+	return true;
+}
+
+/**
+ * @brief Frees a world's static colliders, they're rebuilt on the next physics step.
+ *
+ * @param world World to free them for.
+ */
+void TSEE_Physics_FreeColliders(TSEE_World *world) {
+	if (world->colliders) {
+		xfree(world->colliders);
+	}
+	world->colliders = NULL;
+	world->collider_count = 0;
+	world->colliders_valid = false;
+}
+
+/**
+ * @brief Gets where a collider is on the screen, like TSEE_Object_GetRect.
+ *
+ * @param tsee TSEE the collider's world is in.
+ * @param collider Collider to get it for.
+ * @return SDL_Rect The collider's screen rect.
+ */
+SDL_Rect TSEE_Collider_GetRect(TSEE *tsee, const TSEE_Collider *collider) {
+	SDL_Rect rect;
+	rect.x = collider->x - tsee->world->scroll_x;
+	rect.y = collider->y * -1 + tsee->window->height - tsee->world->scroll_y;
+	rect.w = collider->width;
+	rect.h = collider->height;
+	return rect;
+}
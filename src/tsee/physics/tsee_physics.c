@@ -19,6 +19,9 @@ void TSEE_Physics_SetObjectMass(TSEE_Object *obj, float mass) {
  */
 void TSEE_Physics_PerformStep(TSEE *tsee) {
 	Uint64 start = SDL_GetPerformanceCounter();
+	if (!tsee->world->colliders_valid) {
+		TSEE_Physics_BuildColliders(tsee);
+	}
 	for (size_t i = 0; i < tsee->world->objects->size; i++) {
 		TSEE_Object *object = tsee->world->objects->data[i];
 		if (TSEE_Object_CheckAttribute(object, TSEE_ATTRIB_PHYS)) {
@@ -76,21 +79,34 @@ void TSEE_Physics_UpdateObject(TSEE *tsee, TSEE_Object *obj) {
 }
 
 /**
- * @brief Check for collisions with other objects
+ * @brief Check for collisions with other objects, and with the world's merged static colliders
  * 
  * @param tsee TSEE to check for collisions in
  * @param obj Object to check collisions for
  */
 void TSEE_Physics_CheckCollisions(TSEE *tsee, TSEE_Object *obj) {
-	for (size_t i = 0; i < tsee->world->objects->size; i++) {
-		TSEE_Object *other = tsee->world->objects->data[i];
+	TSEE_World *world = tsee->world;
+	for (size_t i = 0; i < world->objects->size; i++) {
+		TSEE_Object *other = world->objects->data[i];
 		if (TSEE_Object_CheckAttribute(other, TSEE_ATTRIB_PARALLAX)) continue;
 		if (other == obj) continue;
+		// Collided with through the collider it was merged into instead.
+		if (world->colliders_valid && TSEE_Physics_IsStaticCollider(other)) continue;
 
 		if (!TSEE_IsRectNull( TSEE_Object_GetCollisionRect(obj, other) )) {
 			TSEE_Physics_ResolveCollision(tsee, obj, other);
 		}
 	}
+	if (!world->colliders_valid) return;
+	for (size_t i = 0; i < world->collider_count; i++) {
+		TSEE_Collider *collider = &world->colliders[i];
+		SDL_Rect rect = TSEE_Object_GetRect(obj);
+		SDL_Rect other = TSEE_Collider_GetRect(tsee, collider);
+		SDL_Rect overlap;
+		if (SDL_IntersectRect(&rect, &other, &overlap) == SDL_TRUE) {
+			TSEE_Physics_PushOut(tsee, obj, (TSEE_Vec2){collider->x, collider->y}, collider->width, collider->height);
+		}
+	}
 }
 
 /**
@@ -127,6 +143,8 @@ void TSEE_Physics_ResolveCollision(TSEE *tsee, TSEE_Object *first, TSEE_Object *
 		// Apply the overlap to the objects
 		TSEE_Vec2_Add(&first->physics.velocity, overlap);
 		TSEE_Vec2_Subtract(&second->physics.velocity, overlap);
+	} else if (TSEE_Object_CheckAttribute(first, TSEE_ATTRIB_PHYS)) {
+		TSEE_Physics_PushOut(tsee, first, second->position, second->texture->rect.w, second->texture->rect.h);
 	} else {
 		int amtRight = fabs(first->position.x + first->texture->rect.w - second->position.x);
 		int amtLeft = fabs(second->position.x + second->texture->rect.w - first->position.x);
@@ -142,64 +160,87 @@ void TSEE_Physics_ResolveCollision(TSEE *tsee, TSEE_Object *first, TSEE_Object *
 			}
 		}
 
-		if (TSEE_Object_CheckAttribute(first, TSEE_ATTRIB_PHYS)) {
-			if (lowest == amtRight) {
-				if (amtTop <= 5) {
-					TSEE_Object_SetPosition(tsee, first, first->position.x, second->position.y + first->texture->rect.h);
-				} else {
-					TSEE_Object_SetPosition(tsee, first, second->position.x - first->texture->rect.w, first->position.y);
-					first->physics.velocity.x = 0;
-				}
-			} else if (lowest == amtLeft) {
-				if (amtTop <= 5) {
-					TSEE_Object_SetPosition(tsee, first, first->position.x, second->position.y + first->texture->rect.h);
-				} else {
-					TSEE_Object_SetPosition(tsee, first, second->position.x + second->texture->rect.w, first->position.y);
-					first->physics.velocity.x = 0;
-				}
-			} else if (lowest == amtTop) {
-				TSEE_Object_SetPosition(tsee, first, first->position.x, second->position.y + first->texture->rect.h);
-				if (first == tsee->player->object) {
-					tsee->player->grounded = true;
-				}
-				if (first->physics.velocity.y < 0) {
-					first->physics.velocity.y = 0;
-				}
-			} else if (lowest == amtBottom) {
-				TSEE_Object_SetPosition(tsee, first, first->position.x, second->position.y - second->texture->rect.h);
-				if (first->physics.velocity.y > 0) {
-					first->physics.velocity.y = 0;
-				}
+		if (lowest == amtRight) {
+			if (amtTop < 5) {
+				TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y + second->texture->rect.h);
+			} else {
+				TSEE_Object_SetPosition(tsee, second, first->position.x - second->texture->rect.w, second->position.y);
+				second->physics.velocity.x = 0;
 			}
-		} else {
-			if (lowest == amtRight) {
-				if (amtTop < 5) {
-					TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y + second->texture->rect.h);
-				} else {
-					TSEE_Object_SetPosition(tsee, second, first->position.x - second->texture->rect.w, second->position.y);
-					second->physics.velocity.x = 0;
-				}
-			} else if (lowest == amtLeft) {
-				if (amtTop < 5) {
-					TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y + second->texture->rect.h);
-				} else {
-					TSEE_Object_SetPosition(tsee, second, first->position.x + first->texture->rect.w, second->position.y);
-					second->physics.velocity.x = 0;
-				}
-			} else if (lowest == amtTop) {
+		} else if (lowest == amtLeft) {
+			if (amtTop < 5) {
 				TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y + second->texture->rect.h);
-				if (second == tsee->player->object) {
-					tsee->player->grounded = true;
-				}
-				if (second->physics.velocity.y < 0) {
-					second->physics.velocity.y = 0;
-				}
-			} else if (lowest == amtBottom) {
-				TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y - first->texture->rect.h);
-				if (second->physics.velocity.y > 0) {
-					second->physics.velocity.y = 0;
-				}
+			} else {
+				TSEE_Object_SetPosition(tsee, second, first->position.x + first->texture->rect.w, second->position.y);
+				second->physics.velocity.x = 0;
+			}
+		} else if (lowest == amtTop) {
+			TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y + second->texture->rect.h);
+			if (second == tsee->player->object) {
+				tsee->player->grounded = true;
+			}
+			if (second->physics.velocity.y < 0) {
+				second->physics.velocity.y = 0;
+			}
+		} else if (lowest == amtBottom) {
+			TSEE_Object_SetPosition(tsee, second, second->position.x, first->position.y - first->texture->rect.h);
+			if (second->physics.velocity.y > 0) {
+				second->physics.velocity.y = 0;
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Moves a physics object out of a solid rectangle it overlaps, by the side it went in through.
+ *
+ * @param tsee TSEE the object is in
+ * @param obj Physics object to move
+ * @param position Top left of the rectangle, in world space
+ * @param width Width of the rectangle
+ * @param height Height of the rectangle
+ */
+void TSEE_Physics_PushOut(TSEE *tsee, TSEE_Object *obj, TSEE_Vec2 position, float width, float height) {
+	int amtRight = fabs(obj->position.x + obj->texture->rect.w - position.x);
+	int amtLeft = fabs(position.x + width - obj->position.x);
+	int amtTop = fabs(position.y - obj->position.y + obj->texture->rect.h);
+	int amtBottom = fabs(obj->position.y + obj->texture->rect.h - position.y);
+
+	int values[4] = {amtRight, amtLeft, amtTop, amtBottom};
+	int lowest = values[0];
+	// Get lowest value, side it collided on
+	for (int x = 1; x < 4; x++) {
+		if (values[x] < lowest) {
+			lowest = values[x];
+		}
+	}
+
+	if (lowest == amtRight) {
+		if (amtTop <= 5) {
+			TSEE_Object_SetPosition(tsee, obj, obj->position.x, position.y + obj->texture->rect.h);
+		} else {
+			TSEE_Object_SetPosition(tsee, obj, position.x - obj->texture->rect.w, obj->position.y);
+			obj->physics.velocity.x = 0;
+		}
+	} else if (lowest == amtLeft) {
+		if (amtTop <= 5) {
+			TSEE_Object_SetPosition(tsee, obj, obj->position.x, position.y + obj->texture->rect.h);
+		} else {
+			TSEE_Object_SetPosition(tsee, obj, position.x + width, obj->position.y);
+			obj->physics.velocity.x = 0;
+		}
+	} else if (lowest == amtTop) {
+		TSEE_Object_SetPosition(tsee, obj, obj->position.x, position.y + obj->texture->rect.h);
+		if (obj == tsee->player->object) {
+			tsee->player->grounded = true;
+		}
+		if (obj->physics.velocity.y < 0) {
+			obj->physics.velocity.y = 0;
+		}
+	} else if (lowest == amtBottom) {
+		TSEE_Object_SetPosition(tsee, obj, obj->position.x, position.y - height);
+		if (obj->physics.velocity.y > 0) {
+			obj->physics.velocity.y = 0;
+		}
+	}
+}
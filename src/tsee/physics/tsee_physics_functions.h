@@ -2,4 +2,16 @@ void TSEE_Physics_SetObjectMass(TSEE_Object *obj, float mass);
 void TSEE_Physics_PerformStep();
 void TSEE_Physics_UpdateObject(TSEE *tsee, TSEE_Object *obj);
 void TSEE_Physics_CheckCollisions(TSEE *tsee, TSEE_Object *obj);
-void TSEE_Physics_ResolveCollision(TSEE *tsee, TSEE_Object *first, TSEE_Object *second);
\ No newline at end of file
+void TSEE_Physics_ResolveCollision(TSEE *tsee, TSEE_Object *first, TSEE_Object *second);
+void TSEE_Physics_PushOut(TSEE *tsee, TSEE_Object *obj, TSEE_Vec2 position, float width, float height);
+
+// Static Colliders
+
+bool TSEE_Physics_IsStaticCollider(TSEE_Object *obj);
+int TSEE_Collider_CompareRows(const void *a, const void *b);
+int TSEE_Collider_CompareColumns(const void *a, const void *b);
+size_t TSEE_Collider_MergeRows(TSEE_Collider *colliders, size_t count);
+size_t TSEE_Collider_MergeColumns(TSEE_Collider *colliders, size_t count);
+bool TSEE_Physics_BuildColliders(TSEE *tsee);
+void TSEE_Physics_FreeColliders(TSEE_World *world);
+SDL_Rect TSEE_Collider_GetRect(TSEE *tsee, const TSEE_Collider *collider);
@@ -0,0 +1,7 @@
+// A rectangle static objects are collided with as, covering several adjacent or overlapping objects once they're merged.
+typedef struct TSEE_Collider {
+	float x; // Left edge, in world space like an object's position
+	float y; // Top edge, the collider covers y - height up to y
+	float width;
+	float height;
+} TSEE_Collider;
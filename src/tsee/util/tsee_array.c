@@ -9,6 +9,7 @@ TSEE_Array *TSEE_Array_Create() {
 	TSEE_Array *array = xmalloc(sizeof(*array));
 	array->data = NULL;
 	array->size = 0;
+	array->capacity = 0;
 	return array;
 } 
 
@@ -20,11 +21,35 @@ TSEE_Array *TSEE_Array_Create() {
  * @return int - The new size of the array.
  */
 int TSEE_Array_Extend(TSEE_Array *arr, int size) {
-	arr->data = xrealloc(arr->data, sizeof(*arr->data) * (arr->size + size));
+	if (arr->size + size > arr->capacity) {
+		size_t capacity = arr->capacity ? arr->capacity * 2 : 4;
+		if (capacity < arr->size + size) capacity = arr->size + size;
+		TSEE_Array_Reserve(arr, capacity);
+	}
 	arr->size += size;
 	return arr->size;
 }
 
+/**
+ * @brief Makes room for at least "capacity" items, so adding that many doesn't reallocate.
+ * 
+ * @param arr Array to reserve space in
+ * @param capacity Number of items to make room for.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Array_Reserve(TSEE_Array *arr, size_t capacity) {
+	if (capacity <= arr->capacity) {
+		return true;
+	}
+	void **data = xrealloc(arr->data, sizeof(*arr->data) * capacity);
+	if (!data) {
+		return false;
+	}
+	arr->data = data;
+	arr->capacity = capacity;
+	return true;
+}
+
 /**
  * @brief Append data to the end of an array.
  * 
@@ -84,10 +109,11 @@ bool TSEE_Array_Delete(TSEE_Array *arr, size_t index) {
 	}
 	// TODO: figure out why memmove was segfaulting
 	//xmemmove(arr->data[index + 1], arr->data[index], sizeof(*arr->data) * (arr->size - index));
-	arr->data = xrealloc(arr->data, sizeof(*arr->data) * (--arr->size));
+	arr->size--;
 	if (arr->size == 0 && arr->data) {
 		xfree(arr->data);
 		arr->data = NULL;
+		arr->capacity = 0;
 	}
 	return true;
 }
@@ -121,6 +147,7 @@ bool TSEE_Array_Clear(TSEE_Array *arr) {
 		xfree(arr->data);
 	arr->data = NULL;
 	arr->size = 0;
+	arr->capacity = 0;
 	return true;
 }
 
@@ -0,0 +1,91 @@
+#include "../tsee.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Maps a whole file into memory, read-only.
+ *        Empty files can't be mapped, they succeed with NULL data and a size of 0.
+ * 
+ * @param path Path of the file to map.
+ * @param file Mapped file to fill in.
+ * @return true on success, false on fail.
+ */
+bool TSEE_File_Map(const char *path, TSEE_MappedFile *file) {
+	file->data = NULL;
+	file->size = 0;
+	file->packed = false;
+	file->allocated = false;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < 0) {
+		close(fd);
+		return false;
+	}
+	if (st.st_size == 0) {
+		close(fd);
+		return true;
+	}
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		TSEE_Error("Failed to map file `%s`\n", path);
+		return false;
+	}
+	file->data = data;
+	file->size = st.st_size;
+	return true;
+}
+
+/**
+ * @brief Unmaps a file mapped with TSEE_File_Map, or frees one read by TSEE_IO_ReadBatch.
+ *        Files found in archives are left alone.
+ * 
+ * @param file File to unmap.
+ */
+void TSEE_File_Unmap(TSEE_MappedFile *file) {
+	if (file->data && !file->packed) {
+		if (file->allocated) {
+			xfree(file->data);
+		} else {
+			munmap(file->data, file->size);
+		}
+	}
+	file->data = NULL;
+	file->size = 0;
+}
+
+/**
+ * @brief Replaces a file with another in one step, so it's either the old file or the new one and never partly written.
+ *        The directory is synced afterwards, so the replacement survives a crash.
+ * 
+ * @param from File to move, its data should already be synced.
+ * @param to File to replace.
+ * @return true on success, false on fail.
+ */
+bool TSEE_File_Replace(const char *from, const char *to) {
+	if (rename(from, to) != 0) {
+		TSEE_Error("Failed to replace `%s` with `%s` (%s)\n", to, from, strerror(errno));
+		return false;
+	}
+	char *directory = strdup(to);
+	char *slash = strrchr(directory, '/');
+	if (slash == directory) {
+		// Keep the root directory's slash.
+		slash[1] = '\0';
+	} else if (slash) {
+		*slash = '\0';
+	}
+	int fd = open(slash ? directory : ".", O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+	xfree(directory);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "../tsee.h"
+
+/**
+ * @brief Hashes a string with 64-bit FNV-1a.
+ * 
+ * @param str String to hash.
+ * @return Uint64 
+ */
+Uint64 TSEE_Hash_String(const char *str) {
+	Uint64 hash = 0xcbf29ce484222325ULL;
+	for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+		hash ^= *c;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * @brief Rotates a 64-bit value left.
+ * 
+ * @param value Value to rotate.
+ * @param bits Bits to rotate by, 1 to 63.
+ * @return Uint64 
+ */
+Uint64 TSEE_Hash_Rotate(Uint64 value, int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * @brief Hashes a block of memory with a 64-bit hash in the style of xxHash64.
+ *        Much faster than FNV-1a on large buffers, it reads 32 bytes per round in four independent lanes.
+ *        The result depends on the machine's byte order, so don't store it in files.
+ * 
+ * @param data Memory to hash.
+ * @param size Size of the memory in bytes.
+ * @param seed Starting value, pass the previous hash to hash several blocks as one.
+ * @return Uint64 
+ */
+Uint64 TSEE_Hash_Bytes(const void *data, size_t size, Uint64 seed) {
+	const Uint64 prime1 = 0x9E3779B185EBCA87ULL;
+	const Uint64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+	const Uint64 prime3 = 0x165667B19E3779F9ULL;
+	const Uint64 prime4 = 0x85EBCA77C2B2AE63ULL;
+	const Uint8 *bytes = data;
+	Uint64 hash = seed + prime3 + size;
+	if (size >= 32) {
+		Uint64 lanes[4] = {seed + prime1 + prime2, seed + prime2, seed, seed - prime1};
+		while (size >= 32) {
+			for (int i = 0; i < 4; i++) {
+				Uint64 word;
+				memcpy(&word, bytes + i * 8, 8);
+				lanes[i] = TSEE_Hash_Rotate(lanes[i] + word * prime2, 31) * prime1;
+			}
+			bytes += 32;
+			size -= 32;
+		}
+		hash += TSEE_Hash_Rotate(lanes[0], 1) + TSEE_Hash_Rotate(lanes[1], 7) + TSEE_Hash_Rotate(lanes[2], 12) + TSEE_Hash_Rotate(lanes[3], 18);
+	}
+	while (size >= 8) {
+		Uint64 word;
+		memcpy(&word, bytes, 8);
+		hash ^= TSEE_Hash_Rotate(word * prime2, 31) * prime1;
+		hash = TSEE_Hash_Rotate(hash, 27) * prime1 + prime4;
+		bytes += 8;
+		size -= 8;
+	}
+	while (size > 0) {
+		hash ^= *bytes * prime3;
+		hash = TSEE_Hash_Rotate(hash, 11) * prime1;
+		bytes++;
+		size--;
+	}
+	// Mix the final bits so similar inputs land far apart.
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+/**
+ * @brief Hashes a pointer, for maps keyed by pointers.
+ *        The mixing can be undone, so different pointers never share a hash and the map can compare hashes alone.
+ * 
+ * @param ptr Pointer to hash.
+ * @return Uint64 
+ */
+Uint64 TSEE_Hash_Pointer(const void *ptr) {
+	Uint64 hash = (uintptr_t)ptr;
+	hash ^= hash >> 33;
+	hash *= 0xC2B2AE3D27D4EB4FULL;
+	hash ^= hash >> 29;
+	hash *= 0x165667B19E3779F9ULL;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+/**
+ * @brief Create a TSEE_HashMap.
+ * 
+ * @return TSEE_HashMap* 
+ */
+TSEE_HashMap *TSEE_HashMap_Create() {
+	TSEE_HashMap *map = xmalloc(sizeof(*map));
+	map->entries = NULL;
+	map->size = 0;
+	map->capacity = 0;
+	return map;
+}
+
+/**
+ * @brief Finds the slot for a key, either the slot holding it or the empty slot it would go in.
+ * 
+ * @param map Map to search, must have a capacity.
+ * @param hash Hash of the key.
+ * @param key Key to compare against, or NULL to only compare hashes.
+ * @return size_t Index of the slot.
+ */
+size_t TSEE_HashMap_FindSlot(TSEE_HashMap *map, Uint64 hash, const char *key) {
+	size_t mask = map->capacity - 1;
+	size_t i = hash & mask;
+	while (map->entries[i].used) {
+		TSEE_HashMap_Entry *entry = &map->entries[i];
+		if (entry->hash == hash && (key == NULL ? entry->key == NULL : entry->key && strcmp(entry->key, key) == 0)) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/**
+ * @brief Grows a map to a new capacity, re-inserting all of its entries.
+ * 
+ * @param map Map to grow.
+ * @param capacity New capacity, must be a power of two.
+ * @return true on success, false on fail.
+ */
+bool TSEE_HashMap_Resize(TSEE_HashMap *map, size_t capacity) {
+	TSEE_HashMap_Entry *old = map->entries;
+	size_t oldCapacity = map->capacity;
+	map->entries = xmalloc(sizeof(*map->entries) * capacity);
+	if (!map->entries) {
+		map->entries = old;
+		return false;
+	}
+	memset(map->entries, 0, sizeof(*map->entries) * capacity);
+	map->capacity = capacity;
+	for (size_t i = 0; i < oldCapacity; i++) {
+		if (!old[i].used) continue;
+		map->entries[TSEE_HashMap_FindSlot(map, old[i].hash, old[i].key)] = old[i];
+	}
+	if (old)
+		xfree(old);
+	return true;
+}
+
+/**
+ * @brief Sets the value for a key, keyed by its hash and optionally a string.
+ * 
+ * @param map Map to insert into.
+ * @param hash Hash of the key.
+ * @param key String key (copied), or NULL to key only by the hash.
+ * @param value Value to store.
+ * @return true on success, false on fail.
+ */
+bool TSEE_HashMap_Insert(TSEE_HashMap *map, Uint64 hash, const char *key, void *value) {
+	if ((map->size + 1) * 4 > map->capacity * 3) {
+		if (!TSEE_HashMap_Resize(map, map->capacity ? map->capacity * 2 : 16)) {
+			return false;
+		}
+	}
+	TSEE_HashMap_Entry *entry = &map->entries[TSEE_HashMap_FindSlot(map, hash, key)];
+	if (!entry->used) {
+		entry->used = true;
+		entry->hash = hash;
+		entry->key = key ? strdup(key) : NULL;
+		map->size++;
+	}
+	entry->value = value;
+	return true;
+}
+
+/**
+ * @brief Gets the value for a key.
+ * 
+ * @param map Map to search.
+ * @param hash Hash of the key.
+ * @param key String key, or NULL to only match by hash.
+ * @return void* or NULL if it isn't found.
+ */
+void *TSEE_HashMap_Lookup(TSEE_HashMap *map, Uint64 hash, const char *key) {
+	if (map->size == 0) return NULL;
+	TSEE_HashMap_Entry *entry = &map->entries[TSEE_HashMap_FindSlot(map, hash, key)];
+	return entry->used ? entry->value : NULL;
+}
+
+/**
+ * @brief Removes a key from a map.
+ * Note: Does not free the value.
+ * 
+ * @param map Map to remove from.
+ * @param hash Hash of the key.
+ * @param key String key, or NULL to only match by hash.
+ * @return true if the key was removed, false if it wasn't there.
+ */
+bool TSEE_HashMap_Remove(TSEE_HashMap *map, Uint64 hash, const char *key) {
+	if (map->size == 0) return false;
+	size_t mask = map->capacity - 1;
+	size_t i = TSEE_HashMap_FindSlot(map, hash, key);
+	if (!map->entries[i].used) return false;
+	if (map->entries[i].key)
+		xfree(map->entries[i].key);
+	map->entries[i].used = false;
+	map->size--;
+	// Shift back any entries which probed past the removed one.
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & mask;
+		if (!map->entries[j].used) break;
+		size_t home = map->entries[j].hash & mask;
+		if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+			map->entries[i] = map->entries[j];
+			map->entries[j].used = false;
+			i = j;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Sets the value for a string key.
+ * 
+ * @param map Map to insert into.
+ * @param key Key to set, it is copied into the map.
+ * @param value Value to store.
+ * @return true on success, false on fail.
+ */
+bool TSEE_HashMap_Set(TSEE_HashMap *map, const char *key, void *value) {
+	return TSEE_HashMap_Insert(map, TSEE_Hash_String(key), key, value);
+}
+
+/**
+ * @brief Gets the value for a string key.
+ * 
+ * @param map Map to search.
+ * @param key Key to find.
+ * @return void* or NULL if it isn't found.
+ */
+void *TSEE_HashMap_Get(TSEE_HashMap *map, const char *key) {
+	return TSEE_HashMap_Lookup(map, TSEE_Hash_String(key), key);
+}
+
+/**
+ * @brief Removes a string key from a map.
+ * Note: Does not free the value.
+ * 
+ * @param map Map to remove from.
+ * @param key Key to remove.
+ * @return true if the key was removed, false if it wasn't there.
+ */
+bool TSEE_HashMap_Delete(TSEE_HashMap *map, const char *key) {
+	return TSEE_HashMap_Remove(map, TSEE_Hash_String(key), key);
+}
+
+/**
+ * @brief Destroys a map and its keys.
+ * Note: Does not free the values.
+ * 
+ * @param map Map to destroy.
+ * @return true on success, false on fail.
+ */
+bool TSEE_HashMap_Destroy(TSEE_HashMap *map) {
+	if (!map) return false;
+	for (size_t i = 0; i < map->capacity; i++) {
+		if (map->entries[i].used && map->entries[i].key)
+			xfree(map->entries[i].key);
+	}
+	if (map->entries)
+		xfree(map->entries);
+	xfree(map);
+	return true;
+}
\ No newline at end of file
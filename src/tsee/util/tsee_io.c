@@ -0,0 +1,369 @@
+#include "../tsee.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define TSEE_IO_URING
+#endif
+#endif
+
+#define TSEE_IO_THREADS 4
+#define TSEE_IO_QUEUE_DEPTH 64
+
+/**
+ * @brief Opens a file for a batched read and allocates its buffer.
+ * 
+ * @param read Read to open.
+ * @return true on success, false on fail.
+ */
+bool TSEE_IO_Open(TSEE_IO_Read *read) {
+	read->fd = open(read->path, O_RDONLY | O_CLOEXEC);
+	if (read->fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(read->fd, &st) != 0 || st.st_size <= 0) {
+		close(read->fd);
+		read->fd = -1;
+		return false;
+	}
+	read->file.data = xmalloc(st.st_size);
+	read->file.size = st.st_size;
+	read->file.packed = false;
+	read->file.allocated = true;
+	read->done = 0;
+	return true;
+}
+
+/**
+ * @brief Closes a batched read's file and hands its buffer to the batch's callback.
+ * 
+ * @param batch Batch the read is in.
+ * @param read Read that finished.
+ * @param success Whether the whole file was read.
+ */
+void TSEE_IO_Finish(TSEE_IO_Batch *batch, TSEE_IO_Read *read, bool success) {
+	if (read->fd >= 0) {
+		close(read->fd);
+		read->fd = -1;
+	}
+	if (!success) {
+		TSEE_Warn("Failed to read `%s`\n", read->path);
+		if (read->file.data) xfree(read->file.data);
+		read->file.data = NULL;
+		read->file.size = 0;
+	}
+	batch->callback(read->index, &read->file, batch->userdata);
+}
+
+/**
+ * @brief Reads the rest of an opened file with pread.
+ * 
+ * @param read Read to finish.
+ * @return true on success, false on fail.
+ */
+bool TSEE_IO_ReadSync(TSEE_IO_Read *read) {
+	while (read->done < read->file.size) {
+		ssize_t result = pread(read->fd, (char *)read->file.data + read->done, read->file.size - read->done, read->done);
+		if (result < 0 && errno == EINTR) continue;
+		if (result <= 0) {
+			return false;
+		}
+		read->done += result;
+	}
+	return true;
+}
+
+/**
+ * @brief Worker thread for the pread fallback, reads files from the batch until none are left.
+ * 
+ * @param data The TSEE_IO_Batch to read.
+ * @return int
+ */
+int TSEE_IO_Thread(void *data) {
+	TSEE_IO_Batch *batch = data;
+	while (true) {
+		size_t i = SDL_AtomicAdd(&batch->next, 1);
+		if (i >= batch->count) break;
+		TSEE_IO_Read *read = &batch->reads[i];
+		TSEE_IO_Finish(batch, read, TSEE_IO_Open(read) && TSEE_IO_ReadSync(read));
+	}
+	return 0;
+}
+
+/**
+ * @brief Reads a batch with a pool of threads each doing blocking preads, for when io_uring isn't available.
+ *        Falls back to reading on this thread if no threads can be created.
+ * 
+ * @param batch Batch to read.
+ */
+void TSEE_IO_ReadPool(TSEE_IO_Batch *batch) {
+	SDL_Thread *threads[TSEE_IO_THREADS];
+	int count = 0;
+	for (int i = 0; i < TSEE_IO_THREADS && (size_t)i < batch->count; i++) {
+		threads[count] = SDL_CreateThread(TSEE_IO_Thread, "TSEE IO", batch);
+		if (threads[count]) count++;
+	}
+	// This thread helps too, which also covers failing to create any.
+	TSEE_IO_Thread(batch);
+	for (int i = 0; i < count; i++) {
+		SDL_WaitThread(threads[i], NULL);
+	}
+}
+
+#ifdef TSEE_IO_URING
+/**
+ * @brief Sets up an io_uring and maps its queues.
+ * 
+ * @param ring Ring to set up.
+ * @param entries Submission queue size.
+ * @return true on success, false if io_uring isn't available.
+ */
+bool TSEE_IO_RingInit(TSEE_IO_Ring *ring, unsigned entries) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = syscall(__NR_io_uring_setup, entries, &params);
+	if (ring->fd < 0) {
+		return false;
+	}
+	ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+	if (single) {
+		if (ring->cq_size > ring->sq_size) ring->sq_size = ring->cq_size;
+		ring->cq_size = ring->sq_size;
+	}
+	ring->sq = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	ring->cq = single ? ring->sq : mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+	ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	if (ring->sq == MAP_FAILED || ring->cq == MAP_FAILED || ring->sqes == MAP_FAILED) {
+		if (ring->sq == MAP_FAILED) ring->sq = NULL;
+		if (ring->cq == MAP_FAILED) ring->cq = NULL;
+		if (ring->sqes == MAP_FAILED) ring->sqes = NULL;
+		TSEE_IO_RingExit(ring);
+		return false;
+	}
+	char *sq = ring->sq;
+	char *cq = ring->cq;
+	ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+	ring->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+	ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+	ring->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+	ring->cqes = cq + params.cq_off.cqes;
+	ring->entries = params.sq_entries;
+	return true;
+}
+
+/**
+ * @brief Unmaps an io_uring's queues and closes it.
+ * 
+ * @param ring Ring to close.
+ */
+void TSEE_IO_RingExit(TSEE_IO_Ring *ring) {
+	if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq && ring->cq != ring->sq) munmap(ring->cq, ring->cq_size);
+	if (ring->sq) munmap(ring->sq, ring->sq_size);
+	if (ring->fd >= 0) close(ring->fd);
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+}
+
+/**
+ * @brief Queues a read of the rest of a file. There must be room in the submission queue.
+ * 
+ * @param ring Ring to queue on.
+ * @param read Read to queue, given back in its completion.
+ */
+void TSEE_IO_RingQueue(TSEE_IO_Ring *ring, TSEE_IO_Read *read) {
+	unsigned tail = *ring->sq_tail;
+	unsigned index = tail & ring->sq_mask;
+	struct io_uring_sqe *sqe = &((struct io_uring_sqe *)ring->sqes)[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = read->fd;
+	sqe->addr = (Uint64)(uintptr_t)((char *)read->file.data + read->done);
+	sqe->len = read->file.size - read->done;
+	sqe->off = read->done;
+	sqe->user_data = (Uint64)(uintptr_t)read;
+	read->queued = true;
+	ring->sq_array[index] = index;
+	// The kernel mustn't see the new tail before the entry is written.
+	__atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	ring->queued++;
+}
+
+/**
+ * @brief Waits for every read the kernel has taken from a ring to complete, so none of them still write to their buffers.
+ *        Completed reads keep what they read, and are left for pread to finish.
+ * 
+ * @param ring Ring to drain, nothing more is submitted to it.
+ * @param inflight Number of reads submitted and not completed, 0 once it's drained.
+ * @return true once nothing is in flight, false if the ring can't be waited on.
+ */
+bool TSEE_IO_RingDrain(TSEE_IO_Ring *ring, unsigned *inflight) {
+	while (true) {
+		unsigned head = *ring->cq_head;
+		unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			struct io_uring_cqe *cqe = &((struct io_uring_cqe *)ring->cqes)[head & ring->cq_mask];
+			TSEE_IO_Read *read = (TSEE_IO_Read *)(uintptr_t)cqe->user_data;
+			read->queued = false;
+			if (cqe->res > 0) {
+				read->done += cqe->res;
+			}
+			(*inflight)--;
+		}
+		__atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+		if (*inflight == 0) {
+			return true;
+		}
+		int result = syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+			return false;
+		}
+	}
+}
+
+/**
+ * @brief Reads a batch with io_uring. Every read is queued at once, up to the queue depth,
+ *        and each file goes to the callback as soon as its read completes.
+ *        Reads the ring rejects are finished with pread instead.
+ * 
+ * @param batch Batch to read.
+ * @return true on success, false if io_uring isn't available and nothing was read.
+ */
+bool TSEE_IO_ReadRing(TSEE_IO_Batch *batch) {
+	TSEE_IO_Ring ring;
+	unsigned depth = batch->count < TSEE_IO_QUEUE_DEPTH ? batch->count : TSEE_IO_QUEUE_DEPTH;
+	if (!TSEE_IO_RingInit(&ring, depth)) {
+		return false;
+	}
+	size_t next = 0;
+	size_t finished = 0;
+	unsigned inflight = 0;
+	while (finished < batch->count) {
+		while (next < batch->count && inflight + ring.queued < ring.entries) {
+			TSEE_IO_Read *read = &batch->reads[next++];
+			if (!TSEE_IO_Open(read)) {
+				TSEE_IO_Finish(batch, read, false);
+				finished++;
+				continue;
+			}
+			TSEE_IO_RingQueue(&ring, read);
+		}
+		if (inflight + ring.queued == 0) continue;
+		int result = syscall(__NR_io_uring_enter, ring.fd, ring.queued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+		if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+			TSEE_Warn("io_uring failed, reading the rest of the batch with pread (%s)\n", strerror(errno));
+			break;
+		}
+		if (result > 0) {
+			inflight += result;
+			ring.queued -= result;
+		}
+		unsigned head = *ring.cq_head;
+		unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			struct io_uring_cqe *cqe = &((struct io_uring_cqe *)ring.cqes)[head & ring.cq_mask];
+			TSEE_IO_Read *read = (TSEE_IO_Read *)(uintptr_t)cqe->user_data;
+			int res = cqe->res;
+			read->queued = false;
+			inflight--;
+			if (res > 0) {
+				read->done += res;
+				if (read->done < read->file.size) {
+					// Short read, queue the rest. A slot just freed up for it.
+					__atomic_store_n(ring.cq_head, head + 1, __ATOMIC_RELEASE);
+					TSEE_IO_RingQueue(&ring, read);
+					continue;
+				}
+			}
+			// Kernels too old for IORING_OP_READ reject it, pread gets the file anyway.
+			bool success = res > 0 || (res < 0 && TSEE_IO_ReadSync(read));
+			TSEE_IO_Finish(batch, read, success);
+			finished++;
+		}
+		__atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+	}
+	bool broken = finished < batch->count;
+	if (broken) {
+		// Closing the ring doesn't wait for reads the kernel already has, they'd keep writing into buffers the callback owns.
+		// Once they've all completed, only reads that were never submitted are still queued, and pread can finish everything.
+		bool drained = TSEE_IO_RingDrain(&ring, &inflight);
+		TSEE_IO_RingExit(&ring);
+		for (size_t i = 0; i < next; i++) {
+			TSEE_IO_Read *read = &batch->reads[i];
+			if (read->fd < 0) continue;
+			if (!drained && read->queued) {
+				// It may still be being read into, so its buffer is leaked rather than freed or handed on.
+				read->file.data = NULL;
+				TSEE_IO_Finish(batch, read, false);
+				continue;
+			}
+			read->queued = false;
+			TSEE_IO_Finish(batch, read, TSEE_IO_ReadSync(read));
+		}
+		batch->next.value = next;
+		TSEE_IO_ReadPool(batch);
+		return true;
+	}
+	TSEE_IO_RingExit(&ring);
+	return true;
+}
+#endif
+
+/**
+ * @brief Reads a list of files into memory as one batch, with io_uring where the kernel has it
+ *        and a pread thread pool otherwise. Blocks until every file is read.
+ *        The callback is called for each file as soon as it's read, on whichever thread read it,
+ *        so work on the file can start while the rest are still being read.
+ * 
+ * @param paths Paths of the files.
+ * @param count Number of files.
+ * @param callback Called with each file's index and contents. Its data is NULL if it couldn't be read,
+ *                 otherwise the callback owns it and frees it with TSEE_File_Unmap.
+ * @param userdata Passed to the callback.
+ */
+void TSEE_IO_ReadBatch(char **paths, size_t count, TSEE_IO_Callback callback, void *userdata) {
+	if (count == 0) return;
+	TSEE_IO_Batch batch;
+	batch.reads = xmalloc(sizeof(*batch.reads) * count);
+	batch.count = count;
+	batch.next.value = 0;
+	batch.callback = callback;
+	batch.userdata = userdata;
+	for (size_t i = 0; i < count; i++) {
+		TSEE_IO_Read *read = &batch.reads[i];
+		read->path = paths[i];
+		read->index = i;
+		read->fd = -1;
+		read->file.data = NULL;
+		read->file.size = 0;
+		read->file.packed = false;
+		read->file.allocated = false;
+		read->done = 0;
+		read->queued = false;
+	}
+	Uint64 start = SDL_GetPerformanceCounter();
+	const char *backend = "io_uring";
+#ifdef TSEE_IO_URING
+	if (!TSEE_IO_ReadRing(&batch))
+#endif
+	{
+		backend = "pread";
+		TSEE_IO_ReadPool(&batch);
+	}
+	TSEE_Log("Read %zu files with %s in %.3f ms\n", count, backend, (SDL_GetPerformanceCounter() - start) * 1000 / (double)SDL_GetPerformanceFrequency());
+	xfree(batch.reads);
+}
\ No newline at end of file
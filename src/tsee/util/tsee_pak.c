@@ -0,0 +1,342 @@
+#include "../tsee.h"
+#include <unistd.h>
+
+/**
+ * @brief Strips leading "./" from a path so it matches the paths stored in archives.
+ * 
+ * @param path Path to strip.
+ * @return const char*
+ */
+const char *TSEE_Pak_StripPath(const char *path) {
+	while (path[0] == '.' && path[1] == '/') {
+		path += 2;
+	}
+	return path;
+}
+
+/**
+ * @brief Mounts a .tsee_pak archive, mapping it into memory.
+ *        Archives mounted later are searched first. Mount archives before loading from them,
+ *        the texture loader's threads read the mount list without locking it.
+ * 
+ * @param tsee TSEE object to mount the archive in.
+ * @param path Path of the archive.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Pak_Mount(TSEE *tsee, const char *path) {
+	TSEE_Pak *pak = xmalloc(sizeof(*pak));
+	if (!TSEE_File_Map(path, &pak->file)) {
+		TSEE_Error("Failed to open archive `%s`\n", path);
+		xfree(pak);
+		return false;
+	}
+	const TSEE_Pak_Header *header = pak->file.data;
+	Uint64 indexOffset = 0;
+	Uint32 count = 0;
+	bool valid = pak->file.size >= sizeof(*header) && memcmp(header->magic, TSEE_PAK_MAGIC, sizeof(header->magic)) == 0;
+	if (valid) {
+		indexOffset = SDL_SwapLE64(header->index_offset);
+		count = SDL_SwapLE32(header->count);
+		valid = SDL_SwapLE32(header->version) == TSEE_PAK_VERSION
+			&& indexOffset % sizeof(Uint64) == 0
+			&& indexOffset <= pak->file.size
+			&& count <= (pak->file.size - indexOffset) / sizeof(TSEE_Pak_Entry);
+	}
+	pak->entries = (const TSEE_Pak_Entry *)((const char *)pak->file.data + indexOffset);
+	pak->count = count;
+	// Check every entry is inside the file and the index is sorted, so lookups don't have to.
+	for (Uint32 i = 0; valid && i < count; i++) {
+		const TSEE_Pak_Entry *entry = &pak->entries[i];
+		Uint64 offset = SDL_SwapLE64(entry->offset);
+		Uint64 size = SDL_SwapLE64(entry->size);
+		Uint64 pathOffset = SDL_SwapLE32(entry->path_offset);
+		Uint64 pathSize = SDL_SwapLE32(entry->path_size);
+		valid = offset <= pak->file.size && size <= pak->file.size - offset
+			&& pathOffset + pathSize < pak->file.size
+			&& ((const char *)pak->file.data)[pathOffset + pathSize] == '\0'
+			&& (i == 0 || SDL_SwapLE64(pak->entries[i - 1].hash) <= SDL_SwapLE64(entry->hash));
+	}
+	if (!valid) {
+		TSEE_Error("`%s` isn't a valid TSEE archive\n", path);
+		TSEE_File_Unmap(&pak->file);
+		xfree(pak);
+		return false;
+	}
+	pak->path = strdup(path);
+	TSEE_Array_Append(tsee->paks, pak);
+	TSEE_Log("Mounted archive `%s` with %u files.\n", path, count);
+	return true;
+}
+
+/**
+ * @brief Unmounts an archive. Nothing opened from it may still be in use.
+ * 
+ * @param tsee TSEE object the archive is mounted in.
+ * @param path Path the archive was mounted with.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Pak_Unmount(TSEE *tsee, const char *path) {
+	for (size_t i = 0; i < tsee->paks->size; i++) {
+		TSEE_Pak *pak = tsee->paks->data[i];
+		if (strcmp(pak->path, path) == 0) {
+			TSEE_Array_Delete(tsee->paks, i);
+			TSEE_File_Unmap(&pak->file);
+			xfree(pak->path);
+			xfree(pak);
+			return true;
+		}
+	}
+	TSEE_Warn("Archive `%s` isn't mounted\n", path);
+	return false;
+}
+
+/**
+ * @brief Unmounts every archive.
+ * 
+ * @param tsee TSEE object to unmount the archives from.
+ */
+void TSEE_Pak_UnmountAll(TSEE *tsee) {
+	if (!tsee->paks) return;
+	while (tsee->paks->size > 0) {
+		TSEE_Pak *pak = tsee->paks->data[tsee->paks->size - 1];
+		TSEE_Pak_Unmount(tsee, pak->path);
+	}
+}
+
+/**
+ * @brief Sets whether loose files are opened before mounted archives.
+ *        On by default so edited assets show up without rebuilding the archive,
+ *        which also means source images shipped next to an archive of cooked textures are decoded instead of the cooked ones.
+ * 
+ * @param tsee TSEE object to set it for.
+ * @param override True to check loose files first, false to only use them when no archive has the file.
+ */
+void TSEE_Pak_SetLooseOverride(TSEE *tsee, bool override) {
+	tsee->loose_override = override;
+}
+
+/**
+ * @brief Binary searches an archive's index for a path.
+ * 
+ * @param pak Archive to search.
+ * @param path Path to find.
+ * @return const TSEE_Pak_Entry* or NULL if it isn't in the archive.
+ */
+const TSEE_Pak_Entry *TSEE_Pak_FindEntry(TSEE_Pak *pak, const char *path) {
+	path = TSEE_Pak_StripPath(path);
+	Uint64 hash = TSEE_Hash_String(path);
+	Uint32 low = 0;
+	Uint32 high = pak->count;
+	while (low < high) {
+		Uint32 mid = low + (high - low) / 2;
+		if (SDL_SwapLE64(pak->entries[mid].hash) < hash) low = mid + 1;
+		else high = mid;
+	}
+	for (; low < pak->count && SDL_SwapLE64(pak->entries[low].hash) == hash; low++) {
+		const char *entryPath = (const char *)pak->file.data + SDL_SwapLE32(pak->entries[low].path_offset);
+		if (strcmp(entryPath, path) == 0) {
+			return &pak->entries[low];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Finds a file in the mounted archives, without copying it.
+ * 
+ * @param tsee TSEE object with the archives.
+ * @param path Path of the file.
+ * @param file Filled in with the file's memory, which stays valid until the archive is unmounted.
+ * @return true on success, false if no archive has the file.
+ */
+bool TSEE_Pak_Find(TSEE *tsee, const char *path, TSEE_MappedFile *file) {
+	if (!tsee->paks) return false;
+	for (size_t i = tsee->paks->size; i-- > 0;) {
+		TSEE_Pak *pak = tsee->paks->data[i];
+		const TSEE_Pak_Entry *entry = TSEE_Pak_FindEntry(pak, path);
+		if (entry) {
+			file->data = (char *)pak->file.data + SDL_SwapLE64(entry->offset);
+			file->size = SDL_SwapLE64(entry->size);
+			file->packed = true;
+			file->allocated = false;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Checks if TSEE_Pak_Map would find a file in a mounted archive rather than on disk.
+ * 
+ * @param tsee TSEE object with the archives.
+ * @param path Path of the file.
+ * @return true if the file comes from an archive, false otherwise.
+ */
+bool TSEE_Pak_IsPacked(TSEE *tsee, const char *path) {
+	TSEE_MappedFile file;
+	if (tsee->loose_override && access(path, R_OK) == 0) {
+		return false;
+	}
+	return TSEE_Pak_Find(tsee, path, &file);
+}
+
+/**
+ * @brief Maps a file from a loose file or a mounted archive, following the loose override setting.
+ *        Free it with TSEE_File_Unmap, which leaves archive memory alone.
+ * 
+ * @param tsee TSEE object with the archives.
+ * @param path Path of the file.
+ * @param file Mapped file to fill in.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Pak_Map(TSEE *tsee, const char *path, TSEE_MappedFile *file) {
+	if (tsee->loose_override && TSEE_File_Map(path, file)) {
+		return true;
+	}
+	if (TSEE_Pak_Find(tsee, path, file)) {
+		return true;
+	}
+	return !tsee->loose_override && TSEE_File_Map(path, file);
+}
+
+/**
+ * @brief Opens a file from a loose file or a mounted archive, following the loose override setting.
+ *        Files in archives are read straight from the mapped archive.
+ * 
+ * @param tsee TSEE object with the archives.
+ * @param path Path of the file.
+ * @return SDL_RWops* or NULL on fail.
+ */
+SDL_RWops *TSEE_Pak_Open(TSEE *tsee, const char *path) {
+	SDL_RWops *rw = NULL;
+	if (tsee->loose_override && (rw = SDL_RWFromFile(path, "rb"))) {
+		return rw;
+	}
+	TSEE_MappedFile file;
+	if (TSEE_Pak_Find(tsee, path, &file)) {
+		return SDL_RWFromConstMem(file.data, file.size);
+	}
+	return tsee->loose_override ? NULL : SDL_RWFromFile(path, "rb");
+}
+
+/**
+ * @brief qsort comparator ordering archive entries by hash.
+ * 
+ * @param a First TSEE_Pak_BuildEntry.
+ * @param b Second TSEE_Pak_BuildEntry.
+ * @return int
+ */
+int TSEE_Pak_CompareEntries(const void *a, const void *b) {
+	Uint64 first = ((const TSEE_Pak_BuildEntry *)a)->entry.hash;
+	Uint64 second = ((const TSEE_Pak_BuildEntry *)b)->entry.hash;
+	return (first > second) - (first < second);
+}
+
+/**
+ * @brief Builds a .tsee_pak archive from loose files, stored under the paths they're read from.
+ *        Files are laid out in the order given, so list them in the order they're loaded.
+ * 
+ * @param output Path to write the archive to.
+ * @param paths Paths of the files to pack.
+ * @param count Number of files.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Pak_Build(const char *output, char **paths, size_t count) {
+	return TSEE_Pak_Write(output, paths, NULL, count);
+}
+
+/**
+ * @brief Writes a .tsee_pak archive, laying the files out in the order given.
+ * 
+ * @param output Path to write the archive to.
+ * @param paths Paths to store the files under.
+ * @param files Contents of each file, or NULL to read each path from disk.
+ * @param count Number of files.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Pak_Write(const char *output, char **paths, const TSEE_MappedFile *files, size_t count) {
+	if (count > UINT32_MAX) {
+		TSEE_Error("Too many files for one archive\n");
+		return false;
+	}
+	FILE *fp = fopen(output, "wb");
+	if (!fp) {
+		TSEE_Error("Failed to open `%s` for writing\n", output);
+		return false;
+	}
+	TSEE_Pak_BuildEntry *entries = xmalloc(sizeof(*entries) * (count ? count : 1));
+	bool success = true;
+
+	// Paths come straight after the header, then the index, then the files.
+	Uint64 offset = sizeof(TSEE_Pak_Header);
+	TSEE_Pak_Header header = {0};
+	success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	for (size_t i = 0; success && i < count; i++) {
+		const char *path = TSEE_Pak_StripPath(paths[i]);
+		size_t length = strlen(path);
+		entries[i].path = paths[i];
+		entries[i].entry.hash = TSEE_Hash_String(path);
+		entries[i].entry.path_offset = offset;
+		entries[i].entry.path_size = length;
+		success = fwrite(path, 1, length + 1, fp) == length + 1;
+		offset += length + 1;
+	}
+	// Gaps left by seeking past the end are zero filled.
+	offset = TSEE_PAK_ALIGN(offset, sizeof(Uint64));
+	Uint64 indexOffset = offset;
+	offset += sizeof(TSEE_Pak_Entry) * count;
+	for (size_t i = 0; success && i < count; i++) {
+		TSEE_MappedFile file;
+		if (files) {
+			file = files[i];
+			file.packed = true;
+		} else if (!TSEE_File_Map(entries[i].path, &file)) {
+			TSEE_Error("Failed to read `%s` into archive\n", entries[i].path);
+			success = false;
+			break;
+		}
+		// Empty files have no data to write, and aren't aligned so they can't point past the end of the archive.
+		if (file.size > 0) {
+			offset = TSEE_PAK_ALIGN(offset, TSEE_PAK_ALIGNMENT);
+			if (fseek(fp, offset, SEEK_SET) != 0 || fwrite(file.data, 1, file.size, fp) != file.size) {
+				success = false;
+			}
+		}
+		entries[i].entry.offset = offset;
+		entries[i].entry.size = file.size;
+		offset += file.size;
+		TSEE_File_Unmap(&file);
+	}
+	if (success) {
+		qsort(entries, count, sizeof(*entries), TSEE_Pak_CompareEntries);
+		success = fseek(fp, indexOffset, SEEK_SET) == 0;
+		for (size_t i = 0; success && i < count; i++) {
+			TSEE_Pak_Entry entry = {
+				.hash = SDL_SwapLE64(entries[i].entry.hash),
+				.offset = SDL_SwapLE64(entries[i].entry.offset),
+				.size = SDL_SwapLE64(entries[i].entry.size),
+				.path_offset = SDL_SwapLE32(entries[i].entry.path_offset),
+				.path_size = SDL_SwapLE32(entries[i].entry.path_size),
+			};
+			success = fwrite(&entry, sizeof(entry), 1, fp) == 1;
+		}
+	}
+	if (success) {
+		memcpy(header.magic, TSEE_PAK_MAGIC, sizeof(header.magic));
+		header.version = SDL_SwapLE32(TSEE_PAK_VERSION);
+		header.count = SDL_SwapLE32(count);
+		header.index_offset = SDL_SwapLE64(indexOffset);
+		success = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+	}
+	if (fclose(fp) != 0) {
+		success = false;
+	}
+	xfree(entries);
+	if (!success) {
+		TSEE_Error("Failed to write archive `%s`\n", output);
+		remove(output);
+		return false;
+	}
+	TSEE_Log("Packed %zu files into `%s`.\n", count, output);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,644 @@
+#include "../tsee.h"
+#include <unistd.h>
+
+#define TSEE_STREAM_BUFFER_SIZE (64 * 1024)
+#define TSEE_STREAM_MAX_STRING (16 * 1024 * 1024)
+
+/**
+ * @brief Sets up an empty stream, used by the TSEE_Stream_Open functions.
+ *
+ * @param stream Stream to set up.
+ * @param type Backend the stream uses.
+ * @param writing True for a writer, false for a reader.
+ */
+void TSEE_Stream_Init(TSEE_Stream *stream, TSEE_Stream_Type type, bool writing) {
+	memset(stream, 0, sizeof(*stream));
+	stream->type = type;
+	stream->writing = writing;
+}
+
+/**
+ * @brief Gives a stream its own buffer.
+ *
+ * @param stream Stream to give a buffer.
+ * @param capacity Size of the buffer.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_Allocate(TSEE_Stream *stream, size_t capacity) {
+	stream->buffer = xmalloc(capacity);
+	if (!stream->buffer) {
+		return false;
+	}
+	stream->capacity = capacity;
+	stream->owns_buffer = true;
+	return true;
+}
+
+/**
+ * @brief Opens a file to read or write through a buffer.
+ *
+ * @param stream Stream to open.
+ * @param path Path of the file.
+ * @param writing True to create or replace the file, false to read it.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_OpenFile(TSEE_Stream *stream, const char *path, bool writing) {
+	TSEE_Stream_Init(stream, TSEE_STREAM_FILE, writing);
+	stream->fp = fopen(path, writing ? "wb" : "rb");
+	if (!stream->fp) {
+		return false;
+	}
+	// The stream does its own buffering.
+	setvbuf(stream->fp, NULL, _IONBF, 0);
+	if (!TSEE_Stream_Allocate(stream, TSEE_STREAM_BUFFER_SIZE)) {
+		fclose(stream->fp);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Opens a loose file or a file in a mounted archive to read, mapped into memory so reads are copies from the mapping.
+ *
+ * @param tsee TSEE object with the archives.
+ * @param stream Stream to open.
+ * @param path Path of the file.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_OpenMapped(TSEE *tsee, TSEE_Stream *stream, const char *path) {
+	TSEE_Stream_Init(stream, TSEE_STREAM_MAPPED, false);
+	if (!TSEE_Pak_Map(tsee, path, &stream->file)) {
+		return false;
+	}
+	stream->buffer = stream->file.data;
+	stream->length = stream->file.size;
+	stream->capacity = stream->file.size;
+	return true;
+}
+
+/**
+ * @brief Opens memory to read. The memory isn't copied, so must outlive the stream.
+ *
+ * @param stream Stream to open.
+ * @param data Memory to read.
+ * @param size Size of the memory.
+ */
+void TSEE_Stream_OpenMemory(TSEE_Stream *stream, const void *data, size_t size) {
+	TSEE_Stream_Init(stream, TSEE_STREAM_MEMORY, false);
+	stream->buffer = (Uint8 *)data;
+	stream->length = size;
+	stream->capacity = size;
+}
+
+/**
+ * @brief Opens a stream that writes to memory, which grows as it's written. Take it with TSEE_Stream_TakeMemory.
+ *
+ * @param stream Stream to open.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_OpenMemoryWriter(TSEE_Stream *stream) {
+	TSEE_Stream_Init(stream, TSEE_STREAM_MEMORY, true);
+	return TSEE_Stream_Allocate(stream, TSEE_STREAM_BUFFER_SIZE);
+}
+
+/**
+ * @brief Opens a stream that decompresses zlib data read from another stream, or compresses what's written to it into another stream.
+ *        Closing it doesn't close the other stream.
+ *
+ * @param stream Stream to open.
+ * @param inner Stream to read compressed data from or write it to.
+ * @param writing True to compress, false to decompress.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_OpenZlib(TSEE_Stream *stream, TSEE_Stream *inner, bool writing) {
+	TSEE_Stream_Init(stream, TSEE_STREAM_ZLIB, writing);
+	if (inner->writing != writing) {
+		TSEE_Error("Zlib stream must %s the stream it wraps\n", writing ? "write to" : "read from");
+		return false;
+	}
+	stream->inner = inner;
+	stream->zlib = xmalloc(sizeof(*stream->zlib));
+	if (!stream->zlib) {
+		return false;
+	}
+	memset(stream->zlib, 0, sizeof(*stream->zlib));
+	int result = writing ? deflateInit(stream->zlib, Z_DEFAULT_COMPRESSION) : inflateInit(stream->zlib);
+	if (result != Z_OK) {
+		TSEE_Error("Failed to start zlib stream (%s)\n", stream->zlib->msg ? stream->zlib->msg : "unknown error");
+		xfree(stream->zlib);
+		return false;
+	}
+	if (!TSEE_Stream_Allocate(stream, TSEE_STREAM_BUFFER_SIZE)) {
+		if (writing) deflateEnd(stream->zlib);
+		else inflateEnd(stream->zlib);
+		xfree(stream->zlib);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Runs zlib on a stream, compressing or decompressing between it and the stream it wraps.
+ *
+ * @param stream Zlib stream.
+ * @param flush Z_NO_FLUSH, or Z_FINISH to finish compressing.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_Zlib(TSEE_Stream *stream, int flush) {
+	TSEE_Stream *inner = stream->inner;
+	z_stream *zlib = stream->zlib;
+	if (stream->writing) {
+		zlib->next_in = stream->buffer;
+		zlib->avail_in = stream->position;
+		int result;
+		do {
+			if (inner->position == inner->capacity && !TSEE_Stream_Flush(inner)) {
+				return false;
+			}
+			zlib->next_out = inner->buffer + inner->position;
+			zlib->avail_out = inner->capacity - inner->position;
+			result = deflate(zlib, flush);
+			inner->position = zlib->next_out - inner->buffer;
+			if (result == Z_STREAM_ERROR) {
+				return false;
+			}
+		} while (zlib->avail_in > 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+		return true;
+	}
+	if (stream->length == stream->capacity) {
+		return true;
+	}
+	zlib->next_out = stream->buffer + stream->length;
+	zlib->avail_out = stream->capacity - stream->length;
+	while (zlib->avail_out == stream->capacity - stream->length && !stream->ended) {
+		if (inner->position == inner->length && !TSEE_Stream_Fill(inner)) {
+			TSEE_Error("Compressed data ended early\n");
+			return false;
+		}
+		zlib->next_in = inner->buffer + inner->position;
+		zlib->avail_in = inner->length - inner->position < UINT_MAX ? inner->length - inner->position : UINT_MAX;
+		int result = inflate(zlib, Z_NO_FLUSH);
+		inner->position = zlib->next_in - inner->buffer;
+		if (result == Z_STREAM_END) {
+			stream->ended = true;
+		} else if (result != Z_OK && result != Z_BUF_ERROR) {
+			TSEE_Error("Failed to decompress (%s)\n", zlib->msg ? zlib->msg : "corrupt data");
+			return false;
+		}
+	}
+	stream->length = zlib->next_out - stream->buffer;
+	return true;
+}
+
+/**
+ * @brief Reads more of a reader's source into its buffer, after moving what's left unread to the start.
+ *
+ * @param stream Stream to fill.
+ * @return true if anything was read, false at the end of the stream or on fail.
+ */
+bool TSEE_Stream_Fill(TSEE_Stream *stream) {
+	if (stream->failed || stream->writing || !stream->owns_buffer) {
+		return false;
+	}
+	size_t unread = stream->length - stream->position;
+	if (stream->position > 0) {
+		memmove(stream->buffer, stream->buffer + stream->position, unread);
+		stream->offset += stream->position;
+		stream->position = 0;
+		stream->length = unread;
+	}
+	if (stream->type == TSEE_STREAM_FILE) {
+		stream->length += fread(stream->buffer + unread, 1, stream->capacity - unread, stream->fp);
+		if (ferror(stream->fp)) {
+			stream->failed = true;
+		}
+	} else if (stream->type == TSEE_STREAM_ZLIB) {
+		if (!TSEE_Stream_Zlib(stream, Z_NO_FLUSH)) {
+			stream->failed = true;
+		}
+	}
+	return stream->length > unread;
+}
+
+/**
+ * @brief Writes a writer's buffer out to its destination. Memory writers grow instead.
+ *
+ * @param stream Stream to flush.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_Flush(TSEE_Stream *stream) {
+	if (stream->failed || !stream->writing) {
+		return false;
+	}
+	if (stream->type == TSEE_STREAM_MEMORY) {
+		Uint8 *buffer = xrealloc(stream->buffer, stream->capacity * 2);
+		if (!buffer) {
+			stream->failed = true;
+			return false;
+		}
+		stream->buffer = buffer;
+		stream->capacity *= 2;
+		return true;
+	}
+	if (stream->type == TSEE_STREAM_FILE) {
+		if (fwrite(stream->buffer, 1, stream->position, stream->fp) != stream->position) {
+			stream->failed = true;
+		}
+	} else if (stream->type == TSEE_STREAM_ZLIB) {
+		if (!TSEE_Stream_Zlib(stream, Z_NO_FLUSH)) {
+			stream->failed = true;
+		}
+	}
+	stream->offset += stream->position;
+	stream->position = 0;
+	return !stream->failed;
+}
+
+/**
+ * @brief Flushes a file writer and waits for the file's data to reach the disk.
+ *
+ * @param stream Stream to sync.
+ * @return true on success, false on fail or if it isn't writing to a file.
+ */
+bool TSEE_Stream_Sync(TSEE_Stream *stream) {
+	if (stream->type != TSEE_STREAM_FILE || !TSEE_Stream_Flush(stream)) {
+		return false;
+	}
+	if (fflush(stream->fp) != 0 || fsync(fileno(stream->fp)) != 0) {
+		stream->failed = true;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Reads bytes from a stream.
+ *
+ * @param stream Stream to read from.
+ * @param dst Where to read to.
+ * @param size Number of bytes to read.
+ * @return true on success, false if the stream ended early or failed.
+ */
+bool TSEE_Stream_Read(TSEE_Stream *stream, void *dst, size_t size) {
+	Uint8 *out = dst;
+	while (size > 0) {
+		if (stream->position == stream->length && !TSEE_Stream_Fill(stream)) {
+			stream->failed = true;
+			return false;
+		}
+		size_t available = stream->length - stream->position;
+		size_t count = size < available ? size : available;
+		memcpy(out, stream->buffer + stream->position, count);
+		stream->position += count;
+		out += count;
+		size -= count;
+	}
+	return !stream->failed;
+}
+
+/**
+ * @brief Gets the next bytes of a reader without copying them or moving past them.
+ *        Memory and mapped streams can peek any amount, others up to their buffer size.
+ *
+ * @param stream Stream to peek.
+ * @param size Number of bytes wanted.
+ * @return const void* valid until the stream is next used, or NULL if there aren't that many bytes left.
+ */
+const void *TSEE_Stream_Peek(TSEE_Stream *stream, size_t size) {
+	if (stream->failed || stream->writing) {
+		return NULL;
+	}
+	while (stream->length - stream->position < size) {
+		if (size > stream->capacity || !TSEE_Stream_Fill(stream)) {
+			return NULL;
+		}
+	}
+	return stream->buffer + stream->position;
+}
+
+/**
+ * @brief Skips bytes in a reader.
+ *
+ * @param stream Stream to skip in.
+ * @param size Number of bytes to skip.
+ * @return true on success, false if the stream ended early or failed.
+ */
+bool TSEE_Stream_Skip(TSEE_Stream *stream, Uint64 size) {
+	while (size > 0) {
+		if (stream->position == stream->length && !TSEE_Stream_Fill(stream)) {
+			stream->failed = true;
+			return false;
+		}
+		size_t available = stream->length - stream->position;
+		size_t count = size < available ? size : available;
+		stream->position += count;
+		size -= count;
+	}
+	return !stream->failed;
+}
+
+/**
+ * @brief Writes bytes to a stream.
+ *
+ * @param stream Stream to write to.
+ * @param src Bytes to write.
+ * @param size Number of bytes to write.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_Write(TSEE_Stream *stream, const void *src, size_t size) {
+	const Uint8 *in = src;
+	while (size > 0 && !stream->failed) {
+		if (stream->position == stream->capacity && !TSEE_Stream_Flush(stream)) {
+			return false;
+		}
+		size_t space = stream->capacity - stream->position;
+		size_t count = size < space ? size : space;
+		memcpy(stream->buffer + stream->position, in, count);
+		stream->position += count;
+		in += count;
+		size -= count;
+	}
+	return !stream->failed;
+}
+
+/**
+ * @brief Gets how far through a stream it has read or written.
+ *
+ * @param stream Stream to check.
+ * @return Uint64 Offset from the start of the stream.
+ */
+Uint64 TSEE_Stream_Tell(TSEE_Stream *stream) {
+	return stream->offset + stream->position;
+}
+
+/**
+ * @brief Moves a stream on to a multiple of an alignment, skipping bytes when reading and writing zeros when writing.
+ *
+ * @param stream Stream to align.
+ * @param alignment Alignment to move to.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_Align(TSEE_Stream *stream, size_t alignment) {
+	Uint64 offset = TSEE_Stream_Tell(stream);
+	Uint64 padding = TSEE_PAK_ALIGN(offset, alignment) - offset;
+	if (!stream->writing) {
+		return TSEE_Stream_Skip(stream, padding);
+	}
+	static const Uint8 zeros[64] = {0};
+	while (padding > 0 && !stream->failed) {
+		size_t count = padding < sizeof(zeros) ? padding : sizeof(zeros);
+		TSEE_Stream_Write(stream, zeros, count);
+		padding -= count;
+	}
+	return !stream->failed;
+}
+
+/**
+ * @brief Reads a little endian 32-bit integer.
+ *
+ * @param stream Stream to read from.
+ * @param value Set to the value read.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_ReadU32(TSEE_Stream *stream, Uint32 *value) {
+	if (!TSEE_Stream_Read(stream, value, sizeof(*value))) {
+		*value = 0;
+		return false;
+	}
+	*value = SDL_SwapLE32(*value);
+	return true;
+}
+
+/**
+ * @brief Reads a little endian 64-bit integer.
+ *
+ * @param stream Stream to read from.
+ * @param value Set to the value read.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_ReadU64(TSEE_Stream *stream, Uint64 *value) {
+	if (!TSEE_Stream_Read(stream, value, sizeof(*value))) {
+		*value = 0;
+		return false;
+	}
+	*value = SDL_SwapLE64(*value);
+	return true;
+}
+
+/**
+ * @brief Reads a little endian float.
+ *
+ * @param stream Stream to read from.
+ * @param value Set to the value read.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_ReadF32(TSEE_Stream *stream, float *value) {
+	if (!TSEE_Stream_Read(stream, value, sizeof(*value))) {
+		*value = 0;
+		return false;
+	}
+	*value = SDL_SwapFloatLE(*value);
+	return true;
+}
+
+/**
+ * @brief Reads a string written with TSEE_Stream_WriteString, a 32-bit length followed by the characters.
+ *
+ * @param stream Stream to read from.
+ * @return char* NUL terminated copy to free with xfree, or NULL on fail.
+ */
+char *TSEE_Stream_ReadString(TSEE_Stream *stream) {
+	Uint32 length = 0;
+	if (!TSEE_Stream_ReadU32(stream, &length)) {
+		return NULL;
+	}
+	if (length > TSEE_STREAM_MAX_STRING) {
+		TSEE_Error("String of %u bytes is too long, the stream is probably corrupt\n", length);
+		stream->failed = true;
+		return NULL;
+	}
+	char *string = xmalloc(length + 1);
+	if (!string) {
+		stream->failed = true;
+		return NULL;
+	}
+	if (!TSEE_Stream_Read(stream, string, length)) {
+		xfree(string);
+		return NULL;
+	}
+	string[length] = '\0';
+	return string;
+}
+
+/**
+ * @brief Reads a NUL terminated string.
+ *
+ * @param stream Stream to read from.
+ * @return char* Copy to free with xfree, or NULL on fail.
+ */
+char *TSEE_Stream_ReadCString(TSEE_Stream *stream) {
+	size_t length = 0;
+	size_t capacity = 16;
+	char *string = xmalloc(capacity);
+	while (string) {
+		if (stream->position == stream->length && !TSEE_Stream_Fill(stream)) {
+			stream->failed = true;
+			break;
+		}
+		const Uint8 *start = stream->buffer + stream->position;
+		size_t available = stream->length - stream->position;
+		const Uint8 *end = memchr(start, '\0', available);
+		size_t count = end ? (size_t)(end - start) : available;
+		if (length + count + 1 > capacity) {
+			while (length + count + 1 > capacity) capacity *= 2;
+			char *grown = xrealloc(string, capacity);
+			if (!grown) {
+				break;
+			}
+			string = grown;
+		}
+		memcpy(string + length, start, count);
+		length += count;
+		stream->position += count + (end ? 1 : 0);
+		if (end) {
+			string[length] = '\0';
+			return string;
+		}
+	}
+	if (string) xfree(string);
+	return NULL;
+}
+
+/**
+ * @brief Reads a line of text, like fgets. The newline is kept if it fits.
+ *
+ * @param stream Stream to read from.
+ * @param line Buffer to read into, always NUL terminated.
+ * @param size Size of the buffer.
+ * @return true if a line was read, false at the end of the stream.
+ */
+bool TSEE_Stream_ReadLine(TSEE_Stream *stream, char *line, size_t size) {
+	size_t length = 0;
+	while (length + 1 < size) {
+		if (stream->position == stream->length && !TSEE_Stream_Fill(stream)) {
+			break;
+		}
+		char c = stream->buffer[stream->position++];
+		line[length++] = c;
+		if (c == '\n') break;
+	}
+	line[length] = '\0';
+	return length > 0;
+}
+
+/**
+ * @brief Writes a little endian 32-bit integer.
+ *
+ * @param stream Stream to write to.
+ * @param value Value to write.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_WriteU32(TSEE_Stream *stream, Uint32 value) {
+	value = SDL_SwapLE32(value);
+	return TSEE_Stream_Write(stream, &value, sizeof(value));
+}
+
+/**
+ * @brief Writes a little endian 64-bit integer.
+ *
+ * @param stream Stream to write to.
+ * @param value Value to write.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_WriteU64(TSEE_Stream *stream, Uint64 value) {
+	value = SDL_SwapLE64(value);
+	return TSEE_Stream_Write(stream, &value, sizeof(value));
+}
+
+/**
+ * @brief Writes a little endian float.
+ *
+ * @param stream Stream to write to.
+ * @param value Value to write.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_WriteF32(TSEE_Stream *stream, float value) {
+	value = SDL_SwapFloatLE(value);
+	return TSEE_Stream_Write(stream, &value, sizeof(value));
+}
+
+/**
+ * @brief Writes a string as a 32-bit length followed by the characters, read it back with TSEE_Stream_ReadString.
+ *
+ * @param stream Stream to write to.
+ * @param string String to write.
+ * @return true on success, false on fail.
+ */
+bool TSEE_Stream_WriteString(TSEE_Stream *stream, const char *string) {
+	size_t length = strlen(string);
+	if (length > TSEE_STREAM_MAX_STRING) {
+		TSEE_Error("String of %zu bytes is too long to write\n", length);
+		stream->failed = true;
+		return false;
+	}
+	return TSEE_Stream_WriteU32(stream, length) && TSEE_Stream_Write(stream, string, length);
+}
+
+/**
+ * @brief Takes the memory a memory writer has written, the stream is left empty.
+ *
+ * @param stream Memory writer.
+ * @param size Set to the number of bytes written.
+ * @return void* Memory to free with xfree, or NULL on fail.
+ */
+void *TSEE_Stream_TakeMemory(TSEE_Stream *stream, size_t *size) {
+	*size = 0;
+	if (stream->type != TSEE_STREAM_MEMORY || !stream->writing || stream->failed) {
+		return NULL;
+	}
+	void *data = stream->buffer;
+	*size = stream->position;
+	stream->buffer = NULL;
+	stream->owns_buffer = false;
+	stream->position = 0;
+	stream->capacity = 0;
+	return data;
+}
+
+/**
+ * @brief Closes a stream, flushing anything left to write.
+ *
+ * @param stream Stream to close.
+ * @return true if every read and write on the stream succeeded, false otherwise.
+ */
+bool TSEE_Stream_Close(TSEE_Stream *stream) {
+	if (stream->writing && stream->type != TSEE_STREAM_MEMORY && !stream->failed) {
+		if (stream->type == TSEE_STREAM_ZLIB) {
+			if (!TSEE_Stream_Zlib(stream, Z_FINISH)) {
+				stream->failed = true;
+			}
+			stream->position = 0;
+		} else {
+			TSEE_Stream_Flush(stream);
+		}
+	}
+	if (stream->zlib) {
+		if (stream->writing) deflateEnd(stream->zlib);
+		else inflateEnd(stream->zlib);
+		xfree(stream->zlib);
+		stream->zlib = NULL;
+	}
+	if (stream->fp && fclose(stream->fp) != 0) {
+		stream->failed = true;
+	}
+	stream->fp = NULL;
+	if (stream->type == TSEE_STREAM_MAPPED) {
+		TSEE_File_Unmap(&stream->file);
+	}
+	if (stream->owns_buffer && stream->buffer) {
+		xfree(stream->buffer);
+	}
+	stream->buffer = NULL;
+	stream->owns_buffer = false;
+	return !stream->failed;
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 TSEE_Array *TSEE_Array_Create();
 int TSEE_Array_Extend(TSEE_Array *arr, int size);
+bool TSEE_Array_Reserve(TSEE_Array *arr, size_t capacity);
 bool TSEE_Array_Append(TSEE_Array *arr, void *data);
 bool TSEE_Array_Insert(TSEE_Array *arr, void *toInsert, size_t index);
 bool TSEE_Array_Delete(TSEE_Array *arr, size_t index);
@@ -25,4 +26,89 @@ bool TSEE_Vec2_Normalise(TSEE_Vec2 *vec);
 bool TSEE_Vec2_Multiply(TSEE_Vec2 *vec, float mult);
 bool TSEE_Vec2_Divide(TSEE_Vec2 *vec, float div);
 float TSEE_Vec2_Dot(TSEE_Vec2 first, TSEE_Vec2 second);
-bool TSEE_Vec2_Subtract(TSEE_Vec2 *first, TSEE_Vec2 minus);
\ No newline at end of file
+bool TSEE_Vec2_Subtract(TSEE_Vec2 *first, TSEE_Vec2 minus);
+
+// Hash Map
+
+Uint64 TSEE_Hash_String(const char *str);
+Uint64 TSEE_Hash_Rotate(Uint64 value, int bits);
+Uint64 TSEE_Hash_Bytes(const void *data, size_t size, Uint64 seed);
+Uint64 TSEE_Hash_Pointer(const void *ptr);
+TSEE_HashMap *TSEE_HashMap_Create();
+size_t TSEE_HashMap_FindSlot(TSEE_HashMap *map, Uint64 hash, const char *key);
+bool TSEE_HashMap_Resize(TSEE_HashMap *map, size_t capacity);
+bool TSEE_HashMap_Insert(TSEE_HashMap *map, Uint64 hash, const char *key, void *value);
+void *TSEE_HashMap_Lookup(TSEE_HashMap *map, Uint64 hash, const char *key);
+bool TSEE_HashMap_Remove(TSEE_HashMap *map, Uint64 hash, const char *key);
+bool TSEE_HashMap_Set(TSEE_HashMap *map, const char *key, void *value);
+void *TSEE_HashMap_Get(TSEE_HashMap *map, const char *key);
+bool TSEE_HashMap_Delete(TSEE_HashMap *map, const char *key);
+bool TSEE_HashMap_Destroy(TSEE_HashMap *map);
+
+// Files
+
+bool TSEE_File_Map(const char *path, TSEE_MappedFile *file);
+void TSEE_File_Unmap(TSEE_MappedFile *file);
+bool TSEE_File_Replace(const char *from, const char *to);
+
+// Streams
+
+void TSEE_Stream_Init(TSEE_Stream *stream, TSEE_Stream_Type type, bool writing);
+bool TSEE_Stream_Allocate(TSEE_Stream *stream, size_t capacity);
+bool TSEE_Stream_OpenFile(TSEE_Stream *stream, const char *path, bool writing);
+bool TSEE_Stream_OpenMapped(TSEE *tsee, TSEE_Stream *stream, const char *path);
+void TSEE_Stream_OpenMemory(TSEE_Stream *stream, const void *data, size_t size);
+bool TSEE_Stream_OpenMemoryWriter(TSEE_Stream *stream);
+bool TSEE_Stream_OpenZlib(TSEE_Stream *stream, TSEE_Stream *inner, bool writing);
+bool TSEE_Stream_Zlib(TSEE_Stream *stream, int flush);
+bool TSEE_Stream_Fill(TSEE_Stream *stream);
+bool TSEE_Stream_Flush(TSEE_Stream *stream);
+bool TSEE_Stream_Sync(TSEE_Stream *stream);
+bool TSEE_Stream_Read(TSEE_Stream *stream, void *dst, size_t size);
+const void *TSEE_Stream_Peek(TSEE_Stream *stream, size_t size);
+bool TSEE_Stream_Skip(TSEE_Stream *stream, Uint64 size);
+bool TSEE_Stream_Write(TSEE_Stream *stream, const void *src, size_t size);
+Uint64 TSEE_Stream_Tell(TSEE_Stream *stream);
+bool TSEE_Stream_Align(TSEE_Stream *stream, size_t alignment);
+bool TSEE_Stream_ReadU32(TSEE_Stream *stream, Uint32 *value);
+bool TSEE_Stream_ReadU64(TSEE_Stream *stream, Uint64 *value);
+bool TSEE_Stream_ReadF32(TSEE_Stream *stream, float *value);
+char *TSEE_Stream_ReadString(TSEE_Stream *stream);
+char *TSEE_Stream_ReadCString(TSEE_Stream *stream);
+bool TSEE_Stream_ReadLine(TSEE_Stream *stream, char *line, size_t size);
+bool TSEE_Stream_WriteU32(TSEE_Stream *stream, Uint32 value);
+bool TSEE_Stream_WriteU64(TSEE_Stream *stream, Uint64 value);
+bool TSEE_Stream_WriteF32(TSEE_Stream *stream, float value);
+bool TSEE_Stream_WriteString(TSEE_Stream *stream, const char *string);
+void *TSEE_Stream_TakeMemory(TSEE_Stream *stream, size_t *size);
+bool TSEE_Stream_Close(TSEE_Stream *stream);
+
+// Batched Reads
+
+bool TSEE_IO_Open(TSEE_IO_Read *read);
+void TSEE_IO_Finish(TSEE_IO_Batch *batch, TSEE_IO_Read *read, bool success);
+bool TSEE_IO_ReadSync(TSEE_IO_Read *read);
+int TSEE_IO_Thread(void *data);
+void TSEE_IO_ReadPool(TSEE_IO_Batch *batch);
+bool TSEE_IO_RingInit(TSEE_IO_Ring *ring, unsigned entries);
+void TSEE_IO_RingExit(TSEE_IO_Ring *ring);
+void TSEE_IO_RingQueue(TSEE_IO_Ring *ring, TSEE_IO_Read *read);
+bool TSEE_IO_RingDrain(TSEE_IO_Ring *ring, unsigned *inflight);
+bool TSEE_IO_ReadRing(TSEE_IO_Batch *batch);
+void TSEE_IO_ReadBatch(char **paths, size_t count, TSEE_IO_Callback callback, void *userdata);
+
+// Archives
+
+const char *TSEE_Pak_StripPath(const char *path);
+bool TSEE_Pak_Mount(TSEE *tsee, const char *path);
+bool TSEE_Pak_Unmount(TSEE *tsee, const char *path);
+void TSEE_Pak_UnmountAll(TSEE *tsee);
+void TSEE_Pak_SetLooseOverride(TSEE *tsee, bool override);
+const TSEE_Pak_Entry *TSEE_Pak_FindEntry(TSEE_Pak *pak, const char *path);
+bool TSEE_Pak_Find(TSEE *tsee, const char *path, TSEE_MappedFile *file);
+bool TSEE_Pak_IsPacked(TSEE *tsee, const char *path);
+bool TSEE_Pak_Map(TSEE *tsee, const char *path, TSEE_MappedFile *file);
+SDL_RWops *TSEE_Pak_Open(TSEE *tsee, const char *path);
+int TSEE_Pak_CompareEntries(const void *a, const void *b);
+bool TSEE_Pak_Build(const char *output, char **paths, size_t count);
+bool TSEE_Pak_Write(const char *output, char **paths, const TSEE_MappedFile *files, size_t count);
\ No newline at end of file
@@ -9,4 +9,137 @@ typedef struct TSEE_Vec2 {
 typedef struct TSEE_Array {
 	void **data;
 	size_t size;
-} TSEE_Array;
\ No newline at end of file
+	size_t capacity; // Allocated slots, grows by doubling so appends don't realloc every time
+} TSEE_Array;
+
+// An entry in a TSEE_HashMap.
+typedef struct TSEE_HashMap_Entry {
+	Uint64 hash;
+	char *key; // NULL for entries only keyed by their hash
+	void *value;
+	bool used;
+} TSEE_HashMap_Entry;
+
+// TSEE's hash map, keyed by strings (which are copied) or by 64-bit hashes.
+// Uses open addressing with linear probing, capacity is always a power of two.
+typedef struct TSEE_HashMap {
+	TSEE_HashMap_Entry *entries;
+	size_t size;
+	size_t capacity;
+} TSEE_HashMap;
+
+// A read-only file mapped into memory.
+typedef struct TSEE_MappedFile {
+	void *data;
+	size_t size;
+	bool packed; // Points into a mounted archive, so isn't unmapped
+	bool allocated; // Read into memory from xmalloc rather than mapped
+} TSEE_MappedFile;
+
+// Where a TSEE_Stream reads from or writes to.
+typedef enum TSEE_Stream_Type {
+	TSEE_STREAM_FILE,
+	TSEE_STREAM_MAPPED,
+	TSEE_STREAM_MEMORY,
+	TSEE_STREAM_ZLIB,
+} TSEE_Stream_Type;
+
+// A buffered reader or writer, over a file, a mapped file, memory or another stream through zlib.
+// Errors are sticky, once a read or write fails so does every one after it, so fields can be read in a row and checked once.
+// The typed reads and writes are little endian.
+typedef struct TSEE_Stream {
+	TSEE_Stream_Type type;
+	bool writing;
+	bool failed;
+	Uint8 *buffer;
+	size_t position; // Next byte to read or write in the buffer
+	size_t length; // Bytes in the buffer that can be read
+	size_t capacity;
+	bool owns_buffer;
+	Uint64 offset; // Offset in the stream of the start of the buffer
+	FILE *fp;
+	TSEE_MappedFile file;
+	struct TSEE_Stream *inner; // Stream zlib streams read compressed data from or write it to
+	z_stream *zlib;
+	bool ended; // Zlib reader reached the end of the compressed data
+} TSEE_Stream;
+
+// Called as each file in a batched read finishes, on the thread that read it.
+// The file's data is NULL if it couldn't be read, otherwise the callback owns it.
+typedef void (*TSEE_IO_Callback)(size_t index, TSEE_MappedFile *file, void *userdata);
+
+// One file in a batched read.
+typedef struct TSEE_IO_Read {
+	const char *path;
+	size_t index;
+	int fd;
+	TSEE_MappedFile file;
+	size_t done; // Bytes read so far
+	bool queued; // On an io_uring and not completed yet, so the kernel may still write to the buffer
+} TSEE_IO_Read;
+
+// A list of files being read together.
+typedef struct TSEE_IO_Batch {
+	TSEE_IO_Read *reads;
+	size_t count;
+	SDL_atomic_t next; // Next read for the pread threads to take
+	TSEE_IO_Callback callback;
+	void *userdata;
+} TSEE_IO_Batch;
+
+// An io_uring and its mapped queues, set up with the raw syscalls.
+typedef struct TSEE_IO_Ring {
+	int fd;
+	void *sq;
+	void *cq;
+	void *sqes;
+	void *cqes;
+	size_t sq_size;
+	size_t cq_size;
+	size_t sqes_size;
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_array;
+	unsigned sq_mask;
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned cq_mask;
+	unsigned entries;
+	unsigned queued; // Queued but not yet submitted
+} TSEE_IO_Ring;
+
+#define TSEE_PAK_MAGIC "TSEEPAK"
+#define TSEE_PAK_VERSION 1
+#define TSEE_PAK_ALIGNMENT 16
+#define TSEE_PAK_ALIGN(offset, alignment) (((offset) + (alignment) - 1) / (alignment) * (alignment))
+
+// Header at the start of a .tsee_pak archive. All archive fields are little endian.
+typedef struct TSEE_Pak_Header {
+	char magic[8];
+	Uint32 version;
+	Uint32 count;
+	Uint64 index_offset;
+} TSEE_Pak_Header;
+
+// An archive index entry, the index is sorted by hash so it can be binary searched in place.
+typedef struct TSEE_Pak_Entry {
+	Uint64 hash; // TSEE_Hash_String of the path
+	Uint64 offset; // Aligned to TSEE_PAK_ALIGNMENT
+	Uint64 size;
+	Uint32 path_offset; // NUL terminated path, for hash collisions
+	Uint32 path_size;
+} TSEE_Pak_Entry;
+
+// An index entry being built, with the file it's read from.
+typedef struct TSEE_Pak_BuildEntry {
+	TSEE_Pak_Entry entry;
+	const char *path;
+} TSEE_Pak_BuildEntry;
+
+// A mounted .tsee_pak archive.
+typedef struct TSEE_Pak {
+	char *path;
+	TSEE_MappedFile file;
+	const TSEE_Pak_Entry *entries;
+	Uint32 count;
+} TSEE_Pak;
\ No newline at end of file